@@ -4,9 +4,16 @@ in layout (location = 1) vec2 aTexCoord;
 
 out vec2 texCoord;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform PerFrame
+{
+    mat4 view;
+    mat4 projection;
+};
+
+layout (std140) uniform PerDraw
+{
+    mat4 model;
+};
 
 void main()
 {
@@ -1,9 +1,13 @@
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <vge_core.h>
+#include <vge_job_system.h>
 #include <vge_memory.h>
 #include <vge_profiler.h>
 #include <vge_gfx.h>
@@ -25,11 +29,14 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Set by GLFW on the main thread, and applied by the render thread, as that is where the GL context lives.
+static std::atomic<u64> g_framebuffer_size{};
+
 void
 framebuffer_size_callback(VGE_UNUSED GLFWwindow* window,
                           int width, int height)
 {
-    glViewport(0, 0, width, height);
+    g_framebuffer_size.store(((u64)(u32)width << 32) | (u32)height);
 }
 
 void
@@ -40,13 +47,28 @@ process_input(GLFWwindow* window)
 }
 
 int
-main(VGE_UNUSED int argc,
-     VGE_UNUSED char** argv)
+main(int argc,
+     char** argv)
 {
     using namespace VGE;
 
     vge::init_logger();
 
+    // --trace <file> streams all profiling events to a Chrome trace file.
+    // --track-allocations <file> tracks all allocations, and writes a report with the leaks at shutdown.
+    const char* allocation_report = nullptr;
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--trace")
+            gTraceExporter.Start(argv[i + 1]);
+
+        if (std::string(argv[i]) == "--track-allocations")
+        {
+            allocation_report = argv[i + 1];
+            gMemoryManager.EnableTracking(true);
+        }
+    }
+
     if (!glfwInit())
     {
         glfwTerminate();
@@ -107,6 +129,14 @@ main(VGE_UNUSED int argc,
     glDepthFunc(GL_LEQUAL);
 
     // Setup subsystems
+    // The render thread gets the last ThreadID, so it is kept out of the job system.
+    const auto render_thread_id = VGE::Thread::MaxThreads - 1;
+    const auto worker_count = std::clamp((int)std::thread::hardware_concurrency() - 2, 0, render_thread_id - 1);
+    gJobSystem.Init(worker_count, GetDefaultAllocator());
+    gProfiler.SetThreadName(0, "Main");
+    for (int i = 1; i <= gJobSystem.WorkerCount(); i++)
+        gProfiler.SetThreadName(i, "Worker");
+    gProfiler.SetThreadName(render_thread_id, "Render");
     gGfxManager.Init();
     gDebug.Init();
 
@@ -133,20 +163,16 @@ main(VGE_UNUSED int argc,
     glUseProgram(shader_id);
     glUniform1i(glGetUniformLocation(shader_id, "u_texture0"), 0);
     glUniform1i(glGetUniformLocation(shader_id, "u_texture1"), 1);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, gGfxManager.GetTextureID(tex_handle1));
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, gGfxManager.GetTextureID(tex_handle2));
 
     auto object = VGE::LoadOBJ("resources/meshes/cube/cube.obj");
     auto handle2 = gGfxManager.CreateMesh();
     VGE::MeshData data2;
-    data2.name = "obj_file";
+    data2.name = VGE::StringID("obj_file");
     data2.triangles = (GLuint*)object.indices.Data();
     data2.triangle_count = object.indices.Size();
-    data2.vertex_count = object.positions.Size();
-    data2.vertices = object.positions.Data();
-    data2.uv0 = object.uv_coords.Data();
+    data2.vertex_count = object.vertices.Size();
+    data2.vertices = object.vertices.Column<VGE::OBJAsset::Position>().Data();
+    data2.uv0 = object.vertices.Column<VGE::OBJAsset::UV>().Data();
     gGfxManager.SetMesh(handle2, data2);
 
     auto third = gGfxManager.CreateMesh();
@@ -157,16 +183,93 @@ main(VGE_UNUSED int argc,
 
     // near = 0.1, far = 100.0f
     projection = glm::perspective(glm::radians(45.0f), (float)800 / (float)640, 0.1f, 100.0f);
-    view = glm::lookAt(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const auto camera_position = glm::vec3(0.0f, 0.0f, 5.0f);
+    view = glm::lookAt(camera_position, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
     //view       = glm::translate(view, glm::vec3(0.0f, 0.0f, -5.0f));
 
-    glUniformMatrix4fv(glGetUniformLocation(shader_id, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    // Resolved once, the values are written to the uniform arena of each frame.
+    const auto view_uniform = gGfxManager.GetUniform(shader_handle, "view");
+    const auto projection_uniform = gGfxManager.GetUniform(shader_handle, "projection");
+    const auto model_uniform = gGfxManager.GetUniform(shader_handle, "model");
+
+    // Shared by all the cubes, only the uniforms and depth differ.
+    StaticDrawCommand cube_command;
+    cube_command.Mesh = handle2;
+    cube_command.Shader = shader_handle;
+    cube_command.UV0 = tex_handle1;
+    cube_command.UV1 = tex_handle2;
+
+    const glm::vec3 cube_positions[] =
+    {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 1.0f,  1.0f, -1.0f),
+        glm::vec3(-1.0f,  1.0f, -1.0f),
+        glm::vec3( 1.0f, -1.0f, -1.0f),
+        glm::vec3(-1.0f, -1.0f, -1.0f),
+    };
+
+    // Render thread
+    // Owns the GL context from here on, and draws frame N while the main thread records frame N+1.
+    // ImGui is driven from the render thread as well, as the debug windows talk to OpenGL.
+    // GLFW events have to be polled on the main thread though, so everything feeding ImGui
+    // (the GLFW callbacks, the io state and the profiler frames it draws) is guarded by ui_lock.
+    std::mutex ui_lock;
+    RenderThread render_thread(render_thread_id);
+    glfwMakeContextCurrent(nullptr);
+
+    render_thread.Start([window]()
+    {
+        glfwMakeContextCurrent(window);
+    },
+    [&](int slot)
+    {
+        if (const auto size = g_framebuffer_size.exchange(0))
+            glViewport(0, 0, (int)(size >> 32), (int)(size & 0xFFFFFFFF));
+
+        // Clearing
+        const auto clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+        glClearColor(clear_color.x, clear_color.y, clear_color.z, clear_color.w);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        gGfxManager.RenderStatic(slot);
+
+        // hax for testing
+        gDebug.DrawAxes(glm::vec3(0.0f, 0.0f, 0.0f));
+        auto tmp = projection * view;
+        gDebug.RenderDebugLines(tmp);
+
+        {
+            std::lock_guard<std::mutex> lock(ui_lock);
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui::NewFrame();
+
+            vge::draw_debug_windows();
+
+            //ImGui::ShowDemoWindow();
+
+            ImGui::Render();
+        }
+
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        glfwSwapBuffers(window);
+    },
+    []()
+    {
+        glfwMakeContextCurrent(nullptr);
+    });
 
     // Main loop
     while (!glfwWindowShouldClose(window))
     {
         // New Frame
-        VGE::gProfiler.BeginFrame();
+        {
+            std::lock_guard<std::mutex> lock(ui_lock);
+            VGE::gProfiler.BeginFrame();
+            gMemoryManager.BeginFrame();
+            glfwPollEvents();
+            ImGui_ImplGlfw_NewFrame();
+        }
+
         {
                 VGE_PROFILE();
                 std::this_thread::sleep_for(std::chrono::milliseconds(2));
@@ -180,75 +283,51 @@ main(VGE_UNUSED int argc,
                     std::this_thread::sleep_for(std::chrono::milliseconds(2));
                 }
 
-            glfwPollEvents();
-            ImGui_ImplOpenGL3_NewFrame();
-            ImGui_ImplGlfw_NewFrame();
-            ImGui::NewFrame();
-
-            glUseProgram(shader_id);
-
-            // Clearing
-            const auto clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
-            glClearColor(clear_color.x, clear_color.y, clear_color.z, clear_color.w);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-            glUniformMatrix4fv(glGetUniformLocation(shader_id, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
-            glm::mat4 model = glm::mat4(1.0f);
-            // pass transformation matrices to the shader
-
-            glUniformMatrix4fv(glGetUniformLocation(shader_id, "model"), 1, GL_FALSE, glm::value_ptr(model));
+            // Only waits if the render thread is still busy with the frame before the last.
+            const auto slot = render_thread.BeginFrame();
 
             // Drawing
-            gGfxManager.DrawMesh(handle2);
-
-            StaticDrawCommand command;
-            command.Uniforms[0] = Uniform("view");
-            command.Uniforms[0].AsMat4 = view;
-            command.Uniforms[1] = Uniform("projection");
-            command.Uniforms[1].AsMat4 = projection;
-            command.Uniforms[2] = Uniform("model");
-            command.Uniforms[2].AsMat4 = model;
-            command.UniformCount = 3;
-            command.Mesh = handle2;
-            command.Shader = shader_handle;
-
-            gGfxManager.SubmitStaticDrawCommand(command);
-
-            model = glm::translate(glm::mat4(1.0f) ,glm::vec3(1.0f,  1.0f, -1.0f));
-            glUniformMatrix4fv(glGetUniformLocation(shader_id, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            gGfxManager.DrawMesh(handle2);
-            model = glm::translate(glm::mat4(1.0f) ,glm::vec3(-1.0f,  1.0f, -1.0f));
-            glUniformMatrix4fv(glGetUniformLocation(shader_id, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            gGfxManager.DrawMesh(handle2);
-            model = glm::translate(glm::mat4(1.0f) ,glm::vec3(1.0f,  -1.0f, -1.0f));
-            glUniformMatrix4fv(glGetUniformLocation(shader_id, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            gGfxManager.DrawMesh(handle2);
-            model = glm::translate(glm::mat4(1.0f) ,glm::vec3(-1.0f,  -1.0f, -1.0f));
-            glUniformMatrix4fv(glGetUniformLocation(shader_id, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            gGfxManager.DrawMesh(handle2);
-
-            // Draw subsystems
-
-
-            // hax for testing
-            gDebug.DrawAxes(glm::vec3(0.0f, 0.0f, 0.0f));
-            auto tmp = projection * view;
-            gDebug.RenderDebugLines(tmp);
-
+            gGfxManager.SetUniform(gGfxManager.FrameUniforms(), view_uniform, view);
+            gGfxManager.SetUniform(gGfxManager.FrameUniforms(), projection_uniform, projection);
+
+            // One job pr cube, recording into the command buffer of whichever thread picks it up.
+            JobCounter recorded{};
+            for (const auto& position : cube_positions)
+            {
+                const auto cube = &position;
+                const auto sequence = (u32)(cube - cube_positions);
+                gJobSystem.Run(gJobSystem.CreateJob([&cube_command, &model_uniform, &camera_position, cube, sequence]()
+                {
+                    auto command = cube_command;
+                    command.Sequence = sequence;
+                    command.Uniforms = gGfxManager.AllocateDrawUniforms(command.Shader);
+                    gGfxManager.SetUniform(command.Uniforms, model_uniform, glm::translate(glm::mat4(1.0f), *cube));
+                    command.Depth = glm::distance(camera_position, *cube);
+                    gGfxManager.SubmitStaticDrawCommand(command);
+                }), &recorded);
+            }
+            gJobSystem.WaitForCounter(&recorded);
+
+            gGfxManager.SubmitStatic(slot);
+            render_thread.EndFrame();
         }
 
-        vge::draw_debug_windows();
-
-        //ImGui::ShowDemoWindow();
-
-        // Want to finish render thread here.
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        glfwSwapBuffers(window);
+        {
+            std::lock_guard<std::mutex> lock(ui_lock);
+            VGE::gProfiler.EndFrame();
+        }
     }
 
+    // Draws what has been submitted, and hands the context back for the cleanup below.
+    render_thread.Stop();
+    glfwMakeContextCurrent(window);
+
     // Subsystem shutdown
+    gJobSystem.Shutdown();
+    gGfxManager.Shutdown();
+    gTraceExporter.Stop();
+    if (allocation_report)
+        gMemoryManager.GetTracker()->ExportReport(allocation_report);
 
     //
     // glDeleteVertexArrays(1, &VAO);
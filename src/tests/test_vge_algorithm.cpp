@@ -0,0 +1,251 @@
+#include <catch.h>
+#include <vge_algorithm.h>
+#include <vge_memory.h>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    template<class T>
+    std::vector<T>
+    random_values(int count, u64 seed, T max = std::numeric_limits<T>::max())
+    {
+        std::mt19937_64 rng(seed);
+        std::uniform_int_distribution<T> dist(0, max);
+        std::vector<T> values(count);
+        for (auto& value : values)
+            value = dist(rng);
+        return values;
+    }
+
+    template<class T>
+    VGE::Span<T>
+    span(std::vector<T>& values)
+    {
+        return {values.data(), (int)values.size()};
+    }
+}
+
+TEST_CASE("Radix sort sorts 32 and 64 bit keys", "[algorithm]")
+{
+    for (auto count : {0, 1, 2, 100, 100000})
+    {
+        auto keys32 = random_values<u32>(count, count);
+        auto expected32 = keys32;
+        std::sort(expected32.begin(), expected32.end());
+        VGE::RadixSort(span(keys32));
+        REQUIRE(keys32 == expected32);
+
+        auto keys64 = random_values<u64>(count, count);
+        auto expected64 = keys64;
+        std::sort(expected64.begin(), expected64.end());
+        VGE::RadixSort(span(keys64));
+        REQUIRE(keys64 == expected64);
+    }
+}
+
+TEST_CASE("Radix sort skips passes but still sorts keys using only some digits", "[algorithm]")
+{
+    // Only the second byte varies, so three of the four passes are skipped, leaving the result in the scratch memory.
+    auto keys = random_values<u32>(10000, 1, 0xFF);
+    for (auto& key : keys)
+        key = (key << 8) | 0xAB000000;
+
+    auto expected = keys;
+    std::sort(expected.begin(), expected.end());
+    VGE::RadixSort(span(keys));
+    REQUIRE(keys == expected);
+}
+
+TEST_CASE("Radix sort is stable and moves the values along", "[algorithm]")
+{
+    constexpr auto count = 50000;
+    auto keys = random_values<u64>(count, 7, 1000);
+    std::vector<int> values(count);
+    for (int i = 0; i < count; i++)
+        values[i] = i;
+
+    std::vector<std::pair<u64, int>> expected(count);
+    for (int i = 0; i < count; i++)
+        expected[i] = {keys[i], i};
+    std::stable_sort(expected.begin(), expected.end(), [](auto& a, auto& b) { return a.first < b.first; });
+
+    VGE::RadixSort(span(keys), span(values));
+    for (int i = 0; i < count; i++)
+    {
+        REQUIRE(keys[i] == expected[i].first);
+        REQUIRE(values[i] == expected[i].second);
+    }
+}
+
+TEST_CASE("Sorting VGE::Array with scratch from an allocator", "[algorithm]")
+{
+    constexpr auto cap = 4 * 1024 * 1024;
+    auto memory = std::malloc(cap);
+    VGE::MemoryManager manager;
+    VGE::ThreadCachingAllocator allocator(memory, cap, "sort_scratch", &manager);
+    {
+        VGE::Array<u32> keys(allocator);
+        VGE::Array<float> values(allocator);
+        for (u32 i = 0; i < 1000; i++)
+        {
+            keys.PushBack((i * 7919) % 1000);
+            values.PushBack((float)keys.Back());
+        }
+
+        const auto used = allocator.AllocatedSize();
+        VGE::RadixSort(keys, values, allocator);
+        REQUIRE(allocator.AllocatedSize() == used);
+        for (int i = 0; i < keys.Size(); i++)
+        {
+            REQUIRE(keys[i] == (u32)i);
+            REQUIRE(values[i] == (float)i);
+        }
+
+        VGE::MergeSort(values, std::greater<float>(), allocator);
+        REQUIRE(allocator.AllocatedSize() == used);
+        REQUIRE(values[0] == 999.0f);
+        REQUIRE(std::is_sorted(values.Begin(), values.End(), std::greater<float>()));
+    }
+    REQUIRE(allocator.AllocatedSize() == 0);
+    std::free(memory);
+}
+
+TEST_CASE("Merge sort is stable", "[algorithm]")
+{
+    struct Item
+    {
+        int key;
+        int order;
+    };
+
+    const auto by_key = [](const Item& a, const Item& b) { return a.key < b.key; };
+
+    for (auto count : {0, 1, 31, 32, 33, 1000, 100000})
+    {
+        std::vector<Item> items(count);
+        auto keys = random_values<int>(count, count, 100);
+        for (int i = 0; i < count; i++)
+            items[i] = {keys[i], i};
+
+        auto expected = items;
+        std::stable_sort(expected.begin(), expected.end(), by_key);
+
+        VGE::MergeSort(span(items), by_key);
+        for (int i = 0; i < count; i++)
+        {
+            REQUIRE(items[i].key == expected[i].key);
+            REQUIRE(items[i].order == expected[i].order);
+        }
+    }
+}
+
+TEST_CASE("Parallel merge sort matches std::stable_sort", "[algorithm]")
+{
+    struct Item
+    {
+        float depth;
+        int order;
+    };
+
+    const auto by_depth = [](const Item& a, const Item& b) { return a.depth < b.depth; };
+
+    auto& system = VGE::gJobSystem;
+    for (auto worker_count : {0, 3})
+    {
+        system.Init(worker_count);
+
+        constexpr auto count = 500000;
+        std::vector<Item> items(count);
+        auto depths = random_values<int>(count, worker_count, 10000);
+        for (int i = 0; i < count; i++)
+            items[i] = {(float)depths[i], i};
+
+        auto expected = items;
+        std::stable_sort(expected.begin(), expected.end(), by_depth);
+
+        VGE::ParallelMergeSort(span(items), by_depth);
+        system.Shutdown();
+
+        bool matching = true;
+        for (int i = 0; i < count; i++)
+            matching &= items[i].depth == expected[i].depth && items[i].order == expected[i].order;
+        REQUIRE(matching);
+    }
+}
+
+TEST_CASE("Sorting vs std::sort", "[.][benchmark][algorithm]")
+{
+    constexpr auto count = 1 << 20;
+    const auto keys32 = random_values<u32>(count, 1);
+    const auto keys64 = random_values<u64>(count, 2);
+
+    // Draw command style keys, where only the low 24 bits are in use.
+    const auto sort_keys = random_values<u64>(count, 3, 0xFFFFFF);
+
+    std::vector<u32> work32;
+    std::vector<u64> work64;
+    std::vector<int> values(count);
+
+    BENCHMARK("std::sort, 1M u32")
+    {
+        work32 = keys32;
+        std::sort(work32.begin(), work32.end());
+    }
+
+    BENCHMARK("RadixSort, 1M u32")
+    {
+        work32 = keys32;
+        VGE::RadixSort(span(work32));
+    }
+
+    BENCHMARK("std::sort, 1M u64")
+    {
+        work64 = keys64;
+        std::sort(work64.begin(), work64.end());
+    }
+
+    BENCHMARK("RadixSort, 1M u64")
+    {
+        work64 = keys64;
+        VGE::RadixSort(span(work64));
+    }
+
+    BENCHMARK("RadixSort, 1M u64 using 24 bits")
+    {
+        work64 = sort_keys;
+        VGE::RadixSort(span(work64));
+    }
+
+    BENCHMARK("RadixSort, 1M u64 using 24 bits with int values")
+    {
+        work64 = sort_keys;
+        VGE::RadixSort(span(work64), span(values));
+    }
+
+    BENCHMARK("MergeSort, 1M u64")
+    {
+        work64 = keys64;
+        VGE::MergeSort(span(work64));
+    }
+
+    BENCHMARK("std::stable_sort, 1M u64")
+    {
+        work64 = keys64;
+        std::stable_sort(work64.begin(), work64.end());
+    }
+
+    auto& system = VGE::gJobSystem;
+    system.Init();
+
+    BENCHMARK("ParallelMergeSort, 1M u64")
+    {
+        work64 = keys64;
+        VGE::ParallelMergeSort(span(work64));
+    }
+
+    system.Shutdown();
+}
@@ -1,20 +1,820 @@
 #include <catch.h>
 #include <vge_memory.h>
 #include <vge_thread.h>
+#include <vge_array.h>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <vector>
 
 TEST_CASE("Linear Allocator registers itself", "[linear_allocator]")
 {
     char memory[256];
     VGE::MemoryManager manager;
     VGE::LinearAllocator allocator(memory, 256, nullptr, &manager);
-    REQUIRE(manager.mAllocatorsCount[VGE::Thread::ThisThread::ID()] == 1);
+    REQUIRE(manager.AllocatorCount() == 1);
 }
 
+TEST_CASE("Size classes cover all small sizes", "[thread_caching_allocator]")
+{
+    using TCA = VGE::ThreadCachingAllocator;
+    REQUIRE(TCA::ClassSize(TCA::SizeClassCount - 1) == TCA::MaxSmallSize);
+
+    for (int size = 1; size <= TCA::MaxSmallSize; size++)
+    {
+        const auto size_class = TCA::SizeClass(size);
+        REQUIRE(TCA::ClassSize(size_class) >= size);
+        REQUIRE((size_class == 0 || TCA::ClassSize(size_class - 1) < size));
+    }
+}
+
+TEST_CASE("Thread caching allocator reports its usage", "[thread_caching_allocator]")
+{
+    constexpr auto cap = 4 * 1024 * 1024;
+    auto memory = std::malloc(cap);
+    {
+        VGE::MemoryManager manager;
+        VGE::ThreadCachingAllocator allocator(memory, cap, "tca", &manager);
+        REQUIRE(manager.AllocatorCount() == 1);
+        REQUIRE(allocator.Capacity() == cap);
+        REQUIRE(allocator.MemoryBegin() == memory);
+        REQUIRE(allocator.AllocatedSize() == 0);
+
+        auto small = allocator.Allocate(24);
+        REQUIRE(allocator.AllocatedSize() == 32);
+        REQUIRE(((uintptr_t)small % VGE::ThreadCachingAllocator::MinAlignment) == 0);
+        REQUIRE(small >= memory);
+        REQUIRE(small < (char*)memory + cap);
+
+        auto large = allocator.Allocate(VGE::ThreadCachingAllocator::MaxSmallSize + 1);
+        REQUIRE(allocator.AllocatedSize() == 32 + VGE::ThreadCachingAllocator::MaxSmallSize + 1);
+        REQUIRE(((uintptr_t)large % VGE::ThreadCachingAllocator::MinAlignment) == 0);
+
+        allocator.Deallocate(small);
+        allocator.Deallocate(large);
+        REQUIRE(allocator.AllocatedSize() == 0);
+
+        // Freed blocks are reused by the same thread.
+        REQUIRE(allocator.Allocate(20) == small);
+    }
+    std::free(memory);
+}
+
+TEST_CASE("Thread caching allocator handles cross thread frees", "[thread_caching_allocator]")
+{
+    constexpr auto cap = 16 * 1024 * 1024;
+    auto memory = std::malloc(cap);
+    {
+        VGE::MemoryManager manager;
+        VGE::ThreadCachingAllocator allocator(memory, cap, "tca", &manager);
+
+        constexpr auto count = 10000;
+        static void* blocks[count];
+        for (int i = 0; i < count; i++)
+        {
+            blocks[i] = allocator.Allocate(64);
+            std::memset(blocks[i], i & 0xFF, 64);
+        }
+
+        // Everything is freed by another thread, which has to give the blocks back to the central free list.
+        VGE::Thread thread(1);
+        thread.Start([&allocator]()
+        {
+            for (auto block : blocks)
+                allocator.Deallocate(block);
+        });
+        thread.Join();
+
+        REQUIRE(allocator.AllocatedSize() == 0);
+
+        // The main thread gets the blocks back, rather than carving new spans.
+        const auto spans_size = allocator.SpansSize();
+        for (int i = 0; i < count / 2; i++)
+            blocks[i] = allocator.Allocate(64);
+        REQUIRE(allocator.SpansSize() == spans_size);
+    }
+    std::free(memory);
+}
+
+TEST_CASE("Thread caching allocator never hands out the same block twice", "[thread_caching_allocator]")
+{
+    constexpr auto cap = 64 * 1024 * 1024;
+    auto memory = std::malloc(cap);
+    {
+        VGE::MemoryManager manager;
+        VGE::ThreadCachingAllocator allocator(memory, cap, "tca", &manager);
+
+        constexpr auto thread_count = 4;
+        std::atomic<int> errors = 0;
+        std::optional<VGE::Thread> threads[thread_count];
+
+        for (int t = 0; t < thread_count; t++)
+        {
+            threads[t].emplace(t + 1);
+            threads[t]->Start([&allocator, &errors, t]()
+            {
+                struct Block { u8* Data; int Size; };
+                std::vector<Block> live;
+                u32 random = 1234567 * (t + 1);
+
+                for (int i = 0; i < 50000; i++)
+                {
+                    random ^= random << 13; random ^= random >> 17; random ^= random << 5;
+
+                    if (live.empty() || random % 3 != 0)
+                    {
+                        const auto size = 1 + (int)(random % 2048);
+                        auto data = (u8*)allocator.Allocate(size);
+                        std::memset(data, t, size);
+                        live.push_back({data, size});
+                    }
+                    else
+                    {
+                        auto block = live[random % live.size()];
+                        live[random % live.size()] = live.back();
+                        live.pop_back();
+
+                        for (int j = 0; j < block.Size; j++)
+                            errors += block.Data[j] != t;
+                        allocator.Deallocate(block.Data);
+                    }
+                }
+
+                for (auto block : live)
+                    allocator.Deallocate(block.Data);
+            });
+        }
+
+        for (auto& thread : threads)
+            thread->Join();
+
+        REQUIRE(errors.load() == 0);
+        REQUIRE(allocator.AllocatedSize() == 0);
+    }
+    std::free(memory);
+}
+
+TEST_CASE("Array growth with the default allocator", "[.][benchmark][thread_caching_allocator]")
+{
+    VGE::MallocAllocator malloc_allocator("malloc");
+
+    BENCHMARK("10k arrays of 64 ints, malloc")
+    {
+        for (int i = 0; i < 10000; i++)
+        {
+            VGE::Array<int> array(malloc_allocator);
+            for (int j = 0; j < 64; j++)
+                array.PushBack(j);
+        }
+    }
+
+    BENCHMARK("10k arrays of 64 ints, default allocator")
+    {
+        for (int i = 0; i < 10000; i++)
+        {
+            VGE::Array<int> array;
+            for (int j = 0; j < 64; j++)
+                array.PushBack(j);
+        }
+    }
+}
+
+TEST_CASE("Global allocator hands out aligned memory within its bounds", "[global_allocator]")
+{
+    VGE::MemoryManager manager;
+    VGE::GlobalAllocator allocator(&manager, 16 * 1024 * 1024);
+
+    // Nothing is reserved before the first allocation.
+    REQUIRE(allocator.MemoryBegin() == nullptr);
+    REQUIRE(manager.AllocatorCount() == 0);
+
+    auto small = (char*)allocator.Allocate(3);
+    REQUIRE(small == allocator.MemoryBegin());
+    REQUIRE(manager.AllocatorCount() == 1);
+    REQUIRE(allocator.AllocatedSize() == 3);
+
+    auto aligned = (char*)allocator.Allocate(8);
+    REQUIRE(((uintptr_t)aligned % VGE::GlobalAllocator::MinAlignment) == 0);
+
+    auto region = (char*)allocator.AllocateRegion(1024 * 1024);
+    REQUIRE(((uintptr_t)region % VGE::GlobalAllocator::RegionAlignment) == 0);
+    REQUIRE(allocator.AllocatedSize() == (region - small) + 1024 * 1024);
+    VGE::GlobalAllocator::CommitPages(region, 1024 * 1024);
+    std::memset(region, 0xFF, 1024 * 1024);
+
+    // Only the direct allocations are committed, the region is left to its child.
+    REQUIRE(allocator.CommittedSize() == VGE::GlobalAllocator::CommitSize);
+
+    auto after_region = (char*)allocator.Allocate(16);
+    REQUIRE(after_region >= region + 1024 * 1024);
+    REQUIRE(allocator.CommittedSize() == 2 * VGE::GlobalAllocator::CommitSize);
+
+    // Children would be left pointing at released memory.
+    REQUIRE_THROWS(allocator.Clear());
+
+    REQUIRE(allocator.Contains(region));
+    REQUIRE_FALSE(allocator.Contains(&allocator));
+    REQUIRE_THROWS(allocator.Allocate(allocator.Capacity()));
+}
+
+TEST_CASE("Linear allocator can live in a region of the global allocator", "[global_allocator][linear_allocator]")
+{
+    VGE::MemoryManager manager;
+    VGE::GlobalAllocator global(&manager, 1024 * 1024);
+
+    constexpr auto cap = 64 * 1024;
+    const auto region = global.AllocateRegion(cap);
+    VGE::GlobalAllocator::CommitPages(region, cap);
+    VGE::LinearAllocator allocator(region, cap, "child", &manager);
+    REQUIRE(global.Contains(allocator.MemoryBegin()));
+    REQUIRE(manager.AllocatorCount() == 2);
+
+    std::memset(allocator.Allocate(cap), 0, cap);
+    REQUIRE(allocator.AllocatedSize() == cap);
+}
+
+TEST_CASE("Allocators respect the requested alignment", "[allocator]")
+{
+    VGE::MemoryManager manager;
+    VGE::GlobalAllocator global(&manager, 64 * 1024 * 1024);
+
+    constexpr auto cap = 8 * 1024 * 1024;
+    auto linear_memory = global.AllocateRegion(cap);
+    auto tca_memory = global.AllocateRegion(cap);
+    VGE::GlobalAllocator::CommitPages(linear_memory, cap);
+    VGE::LinearAllocator linear(linear_memory, cap, "linear", &manager);
+    VGE::ThreadCachingAllocator tca(tca_memory, cap, "tca", &manager);
+    VGE::MallocAllocator malloc_allocator("malloc");
+
+    VGE::Allocator* allocators[] = {&global, &linear, &tca, &malloc_allocator};
+    for (auto allocator : allocators)
+    {
+        for (i64 alignment : {1, 8, 16, 64, 256, 4096, 64 * 1024})
+        {
+            for (i64 size : {1, 24, 100, 1000, 40 * 1024})
+            {
+                auto ptr = allocator->Allocate(size, alignment);
+                REQUIRE(ptr);
+                REQUIRE(VGE::IsAligned(ptr, alignment));
+                std::memset(ptr, 0xAB, size);
+                allocator->Deallocate(ptr);
+            }
+        }
+    }
+
+    REQUIRE(tca.AllocatedSize() == 0);
+    REQUIRE(malloc_allocator.AllocatedSize() == 0);
+    REQUIRE_THROWS(tca.Allocate(16, 3));
+}
+
+TEST_CASE("Thread caching allocator serves aligned requests from size classes", "[thread_caching_allocator]")
+{
+    using TCA = VGE::ThreadCachingAllocator;
+    REQUIRE(TCA::ClassSize(TCA::AlignedSizeClass(1, 64)) == 64);
+    REQUIRE(TCA::ClassSize(TCA::AlignedSizeClass(100, 64)) == 128);
+    REQUIRE(TCA::ClassSize(TCA::AlignedSizeClass(5000, 4096)) == 8192);
+    REQUIRE(TCA::AlignedSizeClass(TCA::MaxSmallSize + 1, 64) == -1);
+    REQUIRE(TCA::AlignedSizeClass(16, 64 * 1024) == -1);
+}
+
+TEST_CASE("Allocators take sizes above 2GB", "[allocator]")
+{
+    VGE::MemoryManager manager;
+    VGE::GlobalAllocator global(&manager, i64(8) << 30);
+
+    constexpr auto size = i64(3) << 30;
+    auto ptr = (char*)global.Allocate(size, 64);
+    REQUIRE(ptr);
+    REQUIRE(global.AllocatedSize() == size);
+
+    // Only touch the end, so only the last page is backed by memory.
+    ptr[size - 1] = 1;
+    REQUIRE(ptr[size - 1] == 1);
+}
+
+TEST_CASE("Array storage is aligned for over aligned types", "[array]")
+{
+    struct alignas(64) CacheLine
+    {
+        int Value;
+    };
+
+    VGE::Array<CacheLine> array;
+    for (int i = 0; i < 100; i++)
+    {
+        array.PushBack({i});
+        REQUIRE(VGE::IsAligned(&array[0], 64));
+    }
+}
+
+TEST_CASE("Frame allocator keeps memory alive for the frames in flight", "[frame_allocator]")
+{
+    VGE::MemoryManager manager;
+    VGE::GlobalAllocator global(&manager, 64 * 1024 * 1024);
+    VGE::FrameAllocator allocator(64 * 1024, "frame", &manager, &global);
+    REQUIRE(manager.mFrameAllocatorsCount == 1);
+    REQUIRE(allocator.Capacity() == VGE::Thread::MaxThreads * VGE::FrameAllocator::FramesInFlight * 64 * 1024);
+
+    auto first = (int*)allocator.Allocate(sizeof(int), alignof(int));
+    *first = 42;
+    REQUIRE(allocator.ThreadAllocatedSize() == sizeof(int));
+
+    manager.BeginFrame();
+    REQUIRE(allocator.FrameNumber() == 1);
+    REQUIRE(allocator.ThreadAllocatedSize() == 0);
+
+    // The previous frame is untouched while the next one is recorded.
+    auto second = (int*)allocator.Allocate(sizeof(int), alignof(int));
+    REQUIRE(second != first);
+    REQUIRE(*first == 42);
+    REQUIRE(allocator.AllocatedSize() == 2 * sizeof(int));
+
+    // Two frames later the first arena is reused.
+    manager.BeginFrame();
+    REQUIRE(allocator.Allocate(sizeof(int), alignof(int)) == first);
+}
+
+TEST_CASE("Frame allocator reports usage pr frame and thread", "[frame_allocator]")
+{
+    VGE::MemoryManager manager;
+    VGE::GlobalAllocator global(&manager, 64 * 1024 * 1024);
+    VGE::FrameAllocator allocator(64 * 1024, "frame", &manager, &global);
+    REQUIRE(allocator.GetReport(0) == nullptr);
+
+    allocator.Allocate(1000, 64);
+    allocator.Allocate(24, 8);
+
+    constexpr auto thread_id = 1;
+    VGE::Thread thread(thread_id);
+    thread.Start([&allocator]() { allocator.Allocate(5000); });
+    thread.Join();
+
+    allocator.BeginFrame();
+    allocator.Allocate(100);
+    allocator.BeginFrame();
+
+    const auto first = allocator.GetReport(1);
+    REQUIRE(first);
+    REQUIRE(first->Frame == 0);
+    REQUIRE(first->Used[VGE::Thread::ThisThread::ID()] == 1024);
+    REQUIRE(first->Used[thread_id] == 5000);
+    REQUIRE(first->Total == 6024);
+
+    const auto second = allocator.GetReport(0);
+    REQUIRE(second->Frame == 1);
+    REQUIRE(second->Total == 100);
+    REQUIRE(allocator.GetReport(2) == nullptr);
+
+    REQUIRE(allocator.HighWaterMark() == 5000);
+    REQUIRE(allocator.FrameHighWaterMark() == 6024);
+}
+
+TEST_CASE("Frame allocator asserts when an arena overruns", "[frame_allocator]")
+{
+    VGE::MemoryManager manager;
+    VGE::GlobalAllocator global(&manager, 64 * 1024 * 1024);
+    VGE::FrameAllocator allocator(1024, "frame", &manager, &global);
+
+    REQUIRE(allocator.Allocate(1024));
+    REQUIRE_THROWS(allocator.Allocate(1));
+
+    // A new frame gets a fresh arena.
+    allocator.BeginFrame();
+    REQUIRE(allocator.Allocate(1024));
+}
+
+TEST_CASE("Pool allocator reuses freed blocks", "[pool_allocator]")
+{
+    alignas(64) char memory[4096];
+    VGE::MemoryManager manager;
+    VGE::PoolAllocator pool(memory, sizeof(memory), 40, 16, VGE::PoolAllocator::Threading::SingleThreaded, "pool", &manager);
+    REQUIRE(manager.AllocatorCount() == 1);
+    REQUIRE(pool.BlockSize() == 48);
+    REQUIRE(pool.BlockCount() > 0);
+    REQUIRE(pool.BlockCount() <= (int)(sizeof(memory) / 48));
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < pool.BlockCount(); i++)
+    {
+        auto block = pool.Allocate(40, 16);
+        REQUIRE(block);
+        REQUIRE(VGE::IsAligned(block, 16));
+        REQUIRE(block >= (void*)memory);
+        REQUIRE(block < (void*)(memory + sizeof(memory)));
+        std::memset(block, i, 40);
+        blocks.push_back(block);
+    }
+    REQUIRE(pool.AllocatedBlocks() == pool.BlockCount());
+    REQUIRE(pool.AllocatedSize() == pool.BlockCount() * 48);
+    REQUIRE_THROWS(pool.Allocate(40));
+
+    // Last in, first out.
+    pool.Deallocate(blocks[3]);
+    pool.Deallocate(blocks[7]);
+    REQUIRE(pool.Allocate(40) == blocks[7]);
+    REQUIRE(pool.Allocate(40) == blocks[3]);
+
+    REQUIRE_THROWS(pool.Allocate(49));
+    REQUIRE_THROWS(pool.Allocate(8, 64));
+
+    pool.Clear();
+    REQUIRE(pool.AllocatedBlocks() == 0);
+    REQUIRE(pool.Allocate(40) == blocks[0]);
+}
+
+TEST_CASE("Pool allocator catches double frees and writes after free", "[pool_allocator]")
+{
+    alignas(64) char memory[1024];
+    VGE::MemoryManager manager;
+    VGE::PoolAllocator pool(memory, sizeof(memory), 32, 16, VGE::PoolAllocator::Threading::SingleThreaded, "pool", &manager);
+
+    auto block = (char*)pool.Allocate(32);
+    pool.Deallocate(block);
+    REQUIRE(block[8] == (char)VGE::PoolAllocator::PoisonByte);
+    REQUIRE_THROWS(pool.Deallocate(block));
+    REQUIRE_THROWS(pool.Deallocate(block + 1));
+
+    block[8] = 0;
+    REQUIRE_THROWS(pool.Allocate(32));
+}
+
+TEST_CASE("Lock free pool allocator can be shared between threads", "[pool_allocator]")
+{
+    constexpr auto block_count = 1024;
+    constexpr auto iterations = 20000;
+    auto memory = std::malloc(block_count * 64 + 4096);
+    {
+        VGE::MemoryManager manager;
+        VGE::PoolAllocator pool(memory, block_count * 64 + 4096, 64, 64, VGE::PoolAllocator::Threading::LockFree, "pool", &manager);
+        REQUIRE(pool.BlockCount() >= block_count);
+
+        std::atomic<bool> failed{false};
+        std::optional<VGE::Thread> threads[3];
+        for (int t = 0; t < 3; t++)
+        {
+            threads[t].emplace(t + 1);
+            threads[t]->Start([&pool, &failed, t]()
+            {
+                void* owned[8];
+                for (int i = 0; i < iterations; i++)
+                {
+                    for (auto& block : owned)
+                    {
+                        block = pool.Allocate(64, 64);
+                        std::memset(block, t, 64);
+                    }
+
+                    for (auto block : owned)
+                    {
+                        if (((char*)block)[0] != t || ((char*)block)[63] != t)
+                            failed = true;
+                        pool.Deallocate(block);
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread->Join();
+
+        REQUIRE_FALSE(failed);
+        REQUIRE(pool.AllocatedBlocks() == 0);
+    }
+    std::free(memory);
+}
+
+TEST_CASE("Stack allocator frees to markers", "[stack_allocator]")
+{
+    alignas(64) char memory[1024];
+    VGE::MemoryManager manager;
+    VGE::StackAllocator allocator(memory, sizeof(memory), "stack", &manager);
+    REQUIRE(manager.AllocatorCount() == 1);
+    REQUIRE(allocator.GetMarker() == 0);
+
+    auto first = allocator.Allocate(10, 1);
+    REQUIRE(first == memory);
+    const auto marker = allocator.GetMarker();
+    REQUIRE(marker == 10);
+
+    auto second = allocator.Allocate(100, 64);
+    REQUIRE(VGE::IsAligned(second, 64));
+    REQUIRE(allocator.AllocatedSize() == 164);
+
+    allocator.FreeToMarker(marker);
+    REQUIRE(allocator.AllocatedSize() == 10);
+    REQUIRE(((u8*)second)[0] == VGE::StackAllocator::PoisonByte);
+    REQUIRE(allocator.Allocate(100, 64) == second);
+    REQUIRE(allocator.HighWaterMark() == 164);
+
+    // Freeing the outer marker first, makes the inner one invalid.
+    const auto inner = allocator.GetMarker();
+    allocator.FreeToMarker(marker);
+    REQUIRE_THROWS(allocator.FreeToMarker(inner));
+
+    REQUIRE_THROWS(allocator.Allocate(sizeof(memory)));
+    allocator.Clear();
+    REQUIRE(allocator.AllocatedSize() == 0);
+}
+
+TEST_CASE("Stack allocator scopes rewind in LIFO order", "[stack_allocator]")
+{
+    char memory[1024];
+    VGE::MemoryManager manager;
+    VGE::StackAllocator allocator(memory, sizeof(memory), "stack", &manager);
+
+    allocator.Allocate(16);
+    {
+        VGE::StackAllocator::Scope outer(allocator);
+        allocator.Allocate(100);
+        {
+            VGE::StackAllocator::Scope inner(allocator);
+            allocator.Allocate(200);
+            REQUIRE(allocator.AllocatedSize() == 16 + 112 + 200);
+        }
+        REQUIRE(allocator.AllocatedSize() == 16 + 100);
+
+        // Arrays using the stack release everything with the scope.
+        VGE::Array<int> array(allocator);
+        for (int i = 0; i < 50; i++)
+            array.PushBack(i);
+        REQUIRE(allocator.AllocatedSize() > 16 + 100 + 50 * sizeof(int));
+    }
+    REQUIRE(allocator.AllocatedSize() == 16);
+}
+
+namespace
+{
+    VGE_NO_INLINE void*
+    AllocateFromCallSiteA(VGE::Allocator& allocator, i64 size)
+    {
+        return allocator.Allocate(size);
+    }
+
+    VGE_NO_INLINE void*
+    AllocateFromCallSiteB(VGE::Allocator& allocator, i64 size)
+    {
+        return allocator.Allocate(size);
+    }
+}
+
+TEST_CASE("Memory manager tracks allocations pr frame and call site", "[memory_manager]")
+{
+    constexpr auto cap = 4 * 1024 * 1024;
+    auto memory = std::malloc(cap);
+    {
+        VGE::MemoryManager manager;
+        VGE::ThreadCachingAllocator allocator(memory, cap, "tca", &manager);
+
+        // Nothing is recorded until tracking is enabled.
+        allocator.Deallocate(allocator.Allocate(16));
+        REQUIRE(manager.GetTracker() == nullptr);
+
+        manager.EnableTracking(true);
+        const auto tracker = manager.GetTracker();
+        REQUIRE(tracker);
+
+        void* a[3];
+        for (auto& ptr : a)
+            ptr = AllocateFromCallSiteA(allocator, 100);
+        allocator.Deallocate(a[1]);
+
+        // Allocated on another thread, and freed on this one.
+        void* b = nullptr;
+        VGE::Thread thread(1);
+        thread.Start([&allocator, &b]() { b = AllocateFromCallSiteB(allocator, 5000); });
+        thread.Join();
+        allocator.Deallocate(b);
 
+        manager.BeginFrame();
+        const auto frame = tracker->GetFrameStats(0);
+        REQUIRE(frame);
+        REQUIRE(frame->Frame == 0);
+        REQUIRE(frame->Allocations == 4);
+        REQUIRE(frame->Deallocations == 2);
+        REQUIRE(frame->Bytes == 5300);
 
+        const auto sites = tracker->TopCallSites(10);
+        REQUIRE(sites.size() == 2);
+        REQUIRE(sites[0].Count == 3);
+        REQUIRE(sites[0].LiveCount == 2);
+        REQUIRE(sites[0].LiveBytes == 200);
+        REQUIRE(sites[1].Count == 1);
+        REQUIRE(sites[1].LiveCount == 0);
+        REQUIRE(sites[0].CallSite != sites[1].CallSite);
+        REQUIRE_FALSE(tracker->CallSiteName(sites[0].CallSite).empty());
 
+        // An empty frame.
+        manager.BeginFrame();
+        REQUIRE(tracker->GetFrameStats(0)->Allocations == 0);
+        REQUIRE(tracker->GetFrameStats(1)->Allocations == 4);
 
+        REQUIRE(tracker->LiveAllocations().size() == 2);
+        REQUIRE(tracker->LiveAllocations().count(a[0]) == 1);
+        REQUIRE(tracker->DroppedEvents() == 0);
 
+        const auto filepath = "test_allocation_report.txt";
+        REQUIRE(tracker->ExportReport(filepath));
+        std::ifstream file(filepath);
+        const std::string report((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::remove(filepath);
+        REQUIRE(report.find("# Live allocations: 2") != std::string::npos);
 
+        allocator.Deallocate(a[0]);
+        allocator.Deallocate(a[2]);
+        manager.EnableTracking(false);
+        allocator.Deallocate(allocator.Allocate(16));
 
+        std::FILE* leak_file = std::tmpfile();
+        REQUIRE(leak_file);
+        REQUIRE(tracker->DumpLeaks(leak_file) == 0);
+        std::fclose(leak_file);
+    }
+    std::free(memory);
+}
+
+TEST_CASE("Allocation tracker matches frees published before their allocation", "[memory_manager]")
+{
+    const auto tracker = std::make_unique<VGE::AllocationTracker>();
+    int value{};
+
+    // The free from this thread is drained before the allocating thread has published its allocation.
+    tracker->Record(VGE::AllocationKind::Deallocate, nullptr, &value, 0, nullptr);
+    tracker->Update();
+    REQUIRE(tracker->LiveAllocations().empty());
+
+    tracker->Record(VGE::AllocationKind::Allocate, nullptr, &value, sizeof(value), nullptr);
+    tracker->Update();
+    REQUIRE(tracker->LiveAllocations().count(&value) == 1);
+
+    // Frees of memory allocated before tracking started are only retried once.
+    int untracked{};
+    tracker->Record(VGE::AllocationKind::Deallocate, nullptr, &untracked, 0, nullptr);
+    tracker->Update();
+    tracker->Update();
+    tracker->Record(VGE::AllocationKind::Allocate, nullptr, &untracked, sizeof(untracked), nullptr);
+    tracker->Update();
+    REQUIRE(tracker->LiveAllocations().count(&untracked) == 1);
+}
+
+TEST_CASE("Memory manager tracks the malloc allocator", "[memory_manager]")
+{
+    VGE::MemoryManager manager;
+    VGE::MallocAllocator allocator("malloc", &manager);
+    manager.EnableTracking(true);
+
+    const auto ptr = allocator.Allocate(100, 64);
+    manager.BeginFrame();
+    REQUIRE(manager.GetTracker()->LiveAllocations().count(ptr) == 1);
+
+    allocator.Deallocate(ptr);
+    manager.BeginFrame();
+    REQUIRE(manager.GetTracker()->LiveAllocations().empty());
+}
+
+TEST_CASE("Transient allocations are counted, but never leak", "[memory_manager]")
+{
+    char memory[1024];
+    VGE::MemoryManager manager;
+    VGE::StackAllocator allocator(memory, sizeof(memory), "stack", &manager);
+    manager.EnableTracking(true);
+
+    {
+        VGE::StackAllocator::Scope scope(allocator);
+        allocator.Allocate(100);
+        allocator.Allocate(100);
+    }
+
+    manager.BeginFrame();
+    REQUIRE(manager.GetTracker()->GetFrameStats(0)->Allocations == 2);
+    REQUIRE(manager.GetTracker()->LiveAllocations().empty());
+}
+
+TEST_CASE("Memory manager keeps more than 256 allocators pr thread", "[memory_manager]")
+{
+    constexpr auto count = 1000;
+    static char memory[count][64];
+    VGE::MemoryManager manager;
+
+    std::vector<std::optional<VGE::LinearAllocator>> allocators(count);
+
+    // Registered out of address order.
+    for (int i = 0; i < count; i++)
+    {
+        const auto idx = (i * 7) % count;
+        allocators[idx].emplace(memory[idx], 64, nullptr, &manager);
+    }
+    REQUIRE(manager.AllocatorCount() == count);
 
+    for (int i = 0; i < count; i++)
+    {
+        REQUIRE(manager.FindAllocator(memory[i]) == &*allocators[i]);
+        REQUIRE(manager.FindAllocator(memory[i] + 63) == &*allocators[i]);
+    }
+
+    for (int i = 0; i < count; i += 2)
+        allocators[i].reset();
+    REQUIRE(manager.AllocatorCount() == count / 2);
+    REQUIRE(manager.FindAllocator(memory[0]) == nullptr);
+    REQUIRE(manager.FindAllocator(memory[1]) == &*allocators[1]);
+}
+
+TEST_CASE("Memory manager finds the innermost allocator owning a pointer", "[memory_manager]")
+{
+    VGE::MemoryManager manager;
+    VGE::GlobalAllocator global(&manager, 16 * 1024 * 1024);
+
+    constexpr auto cap = 1024 * 1024;
+    const auto first_region = (char*)global.AllocateRegion(cap);
+    const auto second_region = (char*)global.AllocateRegion(cap);
+    VGE::GlobalAllocator::CommitPages(second_region, cap);
+    VGE::ThreadCachingAllocator tca(first_region, cap, "tca", &manager);
+
+    // A stack inside a pool block inside the global allocator, registered outermost last.
+    std::optional<VGE::StackAllocator> stack;
+    std::optional<VGE::PoolAllocator> pool;
+    pool.emplace(second_region, cap, 4096, 16, VGE::PoolAllocator::Threading::SingleThreaded, "pool", &manager);
+    const auto block = (char*)pool->Allocate(4096);
+    stack.emplace(block, 4096, "stack", &manager);
+
+    REQUIRE(manager.FindAllocator(&manager) == nullptr);
+    REQUIRE(manager.FindAllocator(first_region) == &tca);
+    REQUIRE(manager.FindAllocator(second_region - 1) == &tca);
+    REQUIRE(manager.FindAllocator(block) == &*stack);
+    REQUIRE(manager.FindAllocator(block + 4095) == &*stack);
+    REQUIRE(manager.FindAllocator(block + 4096) == &*pool);
+    REQUIRE(manager.FindAllocator(second_region + cap) == &global);
+
+    // Children fall back to their grandparent once the parent is gone.
+    stack.reset();
+    REQUIRE(manager.FindAllocator(block) == &*pool);
+    stack.emplace(block, 4096, "stack", &manager);
+    pool.reset();
+    REQUIRE(manager.FindAllocator(block) == &*stack);
+    REQUIRE(manager.FindAllocator(block + 4096) == &global);
+
+    // Memory from another thread's allocator.
+    std::optional<VGE::LinearAllocator> linear;
+    VGE::Thread thread(1);
+    thread.Start([&]() { linear.emplace(second_region + 8192, 1024, "linear", &manager); });
+    thread.Join();
+    REQUIRE(manager.FindAllocator(second_region + 8192) == &*linear);
+
+    // Destroyed on another thread than it was created on.
+    linear.reset();
+    REQUIRE(manager.FindAllocator(second_region + 8192) == &global);
+}
+
+TEST_CASE("Memory manager frees through the owning allocator", "[memory_manager]")
+{
+    constexpr auto cap = 64 * 1024;
+    auto memory = std::malloc(cap);
+    {
+        VGE::MemoryManager manager;
+        VGE::PoolAllocator pool(memory, cap, 64, 16, VGE::PoolAllocator::Threading::SingleThreaded, "pool", &manager);
+
+        auto block = pool.Allocate(64);
+        REQUIRE(pool.AllocatedBlocks() == 1);
+        manager.Free(block);
+        REQUIRE(pool.AllocatedBlocks() == 0);
+
+        manager.Free(nullptr);
+        int not_owned;
+        REQUIRE_THROWS(manager.Free(&not_owned));
+    }
+    std::free(memory);
+}
+
+TEST_CASE("Allocator registration", "[.][benchmark][memory_manager]")
+{
+    static char memory[1000][64];
+    static VGE::MemoryManager manager;
+    static std::optional<VGE::LinearAllocator> allocators[1000];
+    for (int i = 0; i < 1000; i++)
+        allocators[i].emplace(memory[i], 64, nullptr, &manager);
+
+    BENCHMARK("Scoped allocator with 1000 registered")
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            char scratch[64];
+            VGE::LinearAllocator scoped(scratch, sizeof(scratch), nullptr, &manager);
+        }
+    }
+
+    BENCHMARK("FindAllocator with 1000 registered")
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            volatile auto found = manager.FindAllocator(memory[(i * 7) % 1000]);
+            (void)found;
+        }
+    }
+
+    for (auto& allocator : allocators)
+        allocator.reset();
+}
@@ -0,0 +1,32 @@
+#include <catch.h>
+#include <vge_clock.h>
+#include <thread>
+
+TEST_CASE("Clock is monotonic", "[clock]")
+{
+    auto previous = VGE::Clock::now();
+    for (int i = 0; i < 100000; i++)
+    {
+        const auto now = VGE::Clock::now();
+        REQUIRE(now >= previous);
+        previous = now;
+    }
+}
+
+TEST_CASE("Clock agrees with steady_clock", "[clock]")
+{
+    const auto steady_begin = std::chrono::steady_clock::now();
+    const auto begin = VGE::Clock::now();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const auto steady_end = std::chrono::steady_clock::now();
+    const auto end = VGE::Clock::now();
+
+    const auto expected = std::chrono::duration<double, std::milli>(steady_end - steady_begin).count();
+    const auto measured = std::chrono::duration<double, std::milli>(end - begin).count();
+
+    // Generous, as the calibration only runs for a short while.
+    REQUIRE(measured == Approx(expected).epsilon(0.02));
+    REQUIRE(VGE::Clock::TicksPerSecond() > 0.0);
+}
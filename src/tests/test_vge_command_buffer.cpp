@@ -0,0 +1,129 @@
+#include <catch.h>
+#include <vge_command_buffer.h>
+#include <vge_job_system.h>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const VGE::Uniform&
+    tag_uniform()
+    {
+        static const auto uniform = []()
+        {
+            VGE::Uniform uniform;
+            uniform.Block = VGE::UniformBlock::Draw;
+            uniform.Offset = 0;
+            uniform.Size = sizeof(int);
+            return uniform;
+        }();
+        return uniform;
+    }
+
+    // Records a command tagged in its uniforms.
+    void
+    record(VGE::CommandBuffer& buffer, int tag, int mesh = 0, u32 sequence = 0)
+    {
+        VGE::StaticDrawCommand command;
+        command.Mesh = {mesh, 0};
+        command.Sequence = sequence;
+        command.Uniforms = buffer.AllocateUniforms(sizeof(int));
+        buffer.WriteUniform(command.Uniforms, tag_uniform(), &tag, sizeof(tag));
+        buffer.Submit(command);
+    }
+
+    int
+    read_tag(const VGE::UniformArena& uniforms, const VGE::StaticDrawCommand& command)
+    {
+        int tag;
+        std::memcpy(&tag, uniforms.Data() + command.Uniforms, sizeof(tag));
+        return tag;
+    }
+}
+
+TEST_CASE("Command buffers are merged in thread order", "[command_buffer]")
+{
+    static VGE::ThreadCommandBuffers buffers;
+    buffers.SetAlignment(64);
+    REQUIRE(&buffers.ThisThread() == &buffers.Buffer(0));
+    REQUIRE_THROWS(buffers.Buffer(-1));
+    REQUIRE_THROWS(buffers.Buffer(VGE::Thread::MaxThreads));
+
+    record(buffers.Buffer(3), 4);
+    record(buffers.Buffer(3), 5);
+    record(buffers.Buffer(0), 1);
+    record(buffers.Buffer(0), 2);
+    record(buffers.Buffer(1), 3);
+
+    // Drawn without any uniforms.
+    VGE::StaticDrawCommand plain;
+    plain.Mesh = {0, 0};
+    buffers.Buffer(VGE::Thread::MaxThreads - 1).Submit(plain);
+
+    VGE::RenderQueue queue;
+    VGE::UniformArena uniforms;
+    uniforms.SetAlignment(64);
+    REQUIRE(buffers.Merge(queue, uniforms) == 6);
+    REQUIRE(queue.Size() == 6);
+
+    // All the keys are equal, so the sort keeps the merged order.
+    queue.Sort();
+    for (int i = 0; i < 5; i++)
+    {
+        const auto& command = queue.Command(i);
+        REQUIRE(command.Uniforms % 64 == 0);
+        REQUIRE(read_tag(uniforms, command) == i + 1);
+    }
+    REQUIRE(queue.Command(5).Uniforms == VGE::NoUniforms);
+
+    // The buffers are empty again.
+    for (int i = 0; i < VGE::Thread::MaxThreads; i++)
+    {
+        REQUIRE(buffers.Buffer(i).Size() == 0);
+        REQUIRE(buffers.Buffer(i).Uniforms().Size() == 0);
+    }
+
+    // Uniform offsets only make sense between arenas with the same alignment.
+    VGE::UniformArena other;
+    other.SetAlignment(128);
+    REQUIRE_THROWS(uniforms.Append(other));
+}
+
+TEST_CASE("Command buffers are recorded from many jobs at once", "[command_buffer]")
+{
+    constexpr auto draw_count = 2000;
+
+    static VGE::ThreadCommandBuffers buffers;
+    buffers.SetAlignment(256);
+
+    auto& system = VGE::gJobSystem;
+    system.Init(3);
+
+    VGE::JobCounter counter{};
+    for (int i = 0; i < draw_count; i++)
+        system.Run(system.CreateJob([i]() { record(buffers.ThisThread(), i, i % 7, (u32)i); }), &counter);
+
+    system.WaitForCounter(&counter);
+    system.Shutdown();
+
+    VGE::RenderQueue queue;
+    VGE::UniformArena uniforms;
+    uniforms.SetAlignment(256);
+    REQUIRE(buffers.Merge(queue, uniforms) == draw_count);
+
+    // Every command made it, and still points at its own uniforms.
+    // Draws of the same mesh are in job order, no matter which thread ran the job.
+    queue.Sort();
+    std::vector<bool> seen(draw_count);
+    for (int i = 0; i < queue.Size(); i++)
+    {
+        const auto& command = queue.Command(i);
+        const auto tag = read_tag(uniforms, command);
+        REQUIRE((tag >= 0 && tag < draw_count));
+        REQUIRE(!seen[tag]);
+        seen[tag] = true;
+        REQUIRE(command.Mesh.idx == tag % 7);
+        if (i > 0 && queue.Command(i - 1).Mesh == command.Mesh)
+            REQUIRE(read_tag(uniforms, queue.Command(i - 1)) < tag);
+    }
+}
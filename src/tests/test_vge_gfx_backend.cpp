@@ -0,0 +1,423 @@
+#include <catch.h>
+#include <vge_gfx_backend_null.h>
+#include <vge_gfx_manager.h>
+#include <vge_job_system.h>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    using CallType = VGE::NullBackend::CallType;
+
+    const char* vertex_source = R"(
+        #version 330 core
+        in layout (location = 0) vec3 aPos;
+        in layout (location = 1) vec2 aTexCoord;
+
+        out vec2 texCoord;
+
+        layout (std140) uniform PerFrame
+        {
+            mat4 view;
+            mat4 projection;
+        };
+
+        /* Not one of the blocks of the GFXManager. */
+        layout (std140) uniform Lights
+        {
+            vec4 light;
+        };
+
+        layout (std140) uniform PerDraw
+        {
+            mat4 model; // Translation only
+            vec3 tint;
+            float fade;
+            vec2 scale;
+        };
+
+        void main()
+        {
+            gl_Position = projection * view * model * vec4(aPos, 1.0);
+            texCoord = aTexCoord;
+        }
+    )";
+
+    const char* fragment_source = R"(
+        #version 330 core
+        out vec4 FragColor;
+        in vec2 texCoord;
+
+        uniform sampler2D u_texture0;
+
+        void main()
+        {
+            FragColor = texture(u_texture0, texCoord);
+        }
+    )";
+
+    // The GFXManager loads shaders from disk, the files are removed again when this goes out of scope.
+    struct ShaderFile
+    {
+        ShaderFile(const char* path, const char* source)
+            : Path(path)
+        {
+            auto file = std::fopen(path, "w");
+            std::fputs(source, file);
+            std::fclose(file);
+        }
+
+        ~ShaderFile()
+        {
+            std::remove(Path);
+        }
+
+        const char* Path;
+    };
+
+    // A quad, as two triangles.
+    glm::vec3 quad_vertices[] = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+    glm::vec2 quad_uvs[] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+    GLuint quad_indices[] = {0, 1, 2, 2, 3, 0};
+
+    VGE::MeshData
+    quad_data(int index_count = 6)
+    {
+        VGE::MeshData data;
+        data.vertex_count = 4;
+        data.triangle_count = index_count;
+        data.vertices = quad_vertices;
+        data.uv0 = quad_uvs;
+        data.triangles = quad_indices;
+        return data;
+    }
+
+    VGE::ProgramID
+    linked_program(VGE::NullBackend& backend)
+    {
+        const auto program = backend.CreateProgram();
+        backend.AttachShader(program, backend.CompileShader(vertex_source, GL_VERTEX_SHADER));
+        backend.AttachShader(program, backend.CompileShader(fragment_source, GL_FRAGMENT_SHADER));
+        backend.LinkProgram(program);
+        return program;
+    }
+
+    // The backends live on the stack of the tests, so the manager must not hold on to them past the test.
+    struct ManagerScope
+    {
+        ManagerScope(VGE::GFXBackend& backend) { VGE::gGfxManager.Init(backend); }
+        ~ManagerScope() { VGE::gGfxManager.Shutdown(); }
+    };
+
+    // The GFXManager side of a frame: one shader, and a number of quads drawn with it.
+    struct Scene
+    {
+        static constexpr auto MaxMeshes = 16;
+
+        Scene(int mesh_count)
+            : VertexFile("test_vge_gfx_backend.vs", vertex_source)
+            , FragmentFile("test_vge_gfx_backend.fs", fragment_source)
+            , MeshCount(mesh_count)
+        {
+            auto& gfx = VGE::gGfxManager;
+            Shader = gfx.CreateShader();
+            gfx.AttachShader(Shader, VertexFile.Path, GL_VERTEX_SHADER);
+            gfx.AttachShader(Shader, FragmentFile.Path, GL_FRAGMENT_SHADER);
+            gfx.CompileAndLinkShader(Shader);
+            View = gfx.GetUniform(Shader, "view");
+            Model = gfx.GetUniform(Shader, "model");
+
+            for (int i = 0; i < MeshCount; i++)
+            {
+                Meshes[i] = gfx.CreateMesh();
+                gfx.SetMesh(Meshes[i], quad_data());
+            }
+        }
+
+        ~Scene()
+        {
+            for (int i = 0; i < MeshCount; i++)
+                VGE::gGfxManager.DestroyMesh(Meshes[i]);
+        }
+
+        // From any thread, into the command buffer of that thread.
+        void
+        Record(int draw) const
+        {
+            auto& gfx = VGE::gGfxManager;
+
+            VGE::StaticDrawCommand command;
+            command.Shader = Shader;
+            command.Mesh = Meshes[draw % MeshCount];
+            command.Depth = (float)draw;
+            command.Uniforms = gfx.AllocateDrawUniforms(Shader);
+            gfx.SetUniform(command.Uniforms, Model, glm::mat4((float)draw));
+            gfx.SubmitStaticDrawCommand(command);
+        }
+
+        ShaderFile VertexFile;
+        ShaderFile FragmentFile;
+
+        VGE::ShaderHandle Shader;
+        VGE::Uniform View;
+        VGE::Uniform Model;
+        VGE::MeshHandle Meshes[MaxMeshes];
+        int MeshCount;
+    };
+}
+
+TEST_CASE("Null backend lays out uniform blocks with the std140 rules", "[gfx_backend]")
+{
+    VGE::NullBackend backend;
+    backend.Init(1024);
+    const auto program = linked_program(backend);
+
+    VGE::HashMap<VGE::StringID, VGE::Uniform> uniforms;
+    int block_sizes[(int)VGE::UniformBlock::Count];
+    backend.ReflectUniforms(program, uniforms, block_sizes);
+
+    REQUIRE(uniforms.Size() == 6);
+    REQUIRE(block_sizes[(int)VGE::UniformBlock::Frame] == 128);
+    REQUIRE(block_sizes[(int)VGE::UniformBlock::Draw] == 96);
+    REQUIRE(!uniforms.Contains(VGE::StringID("light")));
+
+    const auto expect = [&](const char* name, VGE::UniformBlock block, int offset, int size, GLenum type)
+    {
+        const auto uniform = uniforms.Find(VGE::StringID(name));
+        REQUIRE(uniform);
+        REQUIRE(uniform->Block == block);
+        REQUIRE(uniform->Offset == offset);
+        REQUIRE(uniform->Size == size);
+        REQUIRE(uniform->Type == type);
+    };
+    expect("view", VGE::UniformBlock::Frame, 0, 64, GL_FLOAT_MAT4);
+    expect("projection", VGE::UniformBlock::Frame, 64, 64, GL_FLOAT_MAT4);
+    expect("model", VGE::UniformBlock::Draw, 0, 64, GL_FLOAT_MAT4);
+    expect("tint", VGE::UniformBlock::Draw, 64, 12, GL_FLOAT_VEC3);
+    expect("fade", VGE::UniformBlock::Draw, 76, 4, GL_FLOAT); // Packed into the end of the vec3
+    expect("scale", VGE::UniformBlock::Draw, 80, 8, GL_FLOAT_VEC2);
+}
+
+TEST_CASE("Null backend asserts on invalid use", "[gfx_backend]")
+{
+    VGE::NullBackend backend(256);
+    backend.Init(64);
+
+    // Nothing bound
+    REQUIRE_THROWS(backend.DrawIndexed(3));
+
+    const auto program = linked_program(backend);
+    const auto mesh = backend.CreateMesh(quad_data());
+    backend.BindProgram(program);
+    backend.BindMesh(mesh);
+    backend.DrawIndexed(6);
+    REQUIRE_THROWS(backend.DrawIndexed(7));
+
+    // Objects have to exist, and be of the right type.
+    REQUIRE_THROWS(backend.BindProgram(12345));
+    REQUIRE_THROWS(backend.BindProgram(mesh.VAO));
+    REQUIRE_THROWS(backend.BindTexture(0, program));
+    REQUIRE_THROWS(backend.BindTexture(VGE::NullBackend::MaxTextureUnits, 0));
+    REQUIRE_THROWS(backend.AttachShader(program, program));
+
+    // Programs have to be linked before they're used.
+    VGE::HashMap<VGE::StringID, VGE::Uniform> uniforms;
+    int block_sizes[(int)VGE::UniformBlock::Count];
+    const auto unlinked = backend.CreateProgram();
+    REQUIRE_THROWS(backend.BindProgram(unlinked));
+    REQUIRE_THROWS(backend.ReflectUniforms(unlinked, uniforms, block_sizes));
+
+    // Destroyed meshes are gone, and are unbound.
+    const auto objects = backend.ObjectCount();
+    backend.DestroyMesh(mesh);
+    REQUIRE(backend.ObjectCount() == objects - 4);
+    REQUIRE_THROWS(backend.BindMesh(mesh));
+    REQUIRE_THROWS(backend.DrawIndexed(6));
+
+    // Indices out of range
+    GLuint indices[] = {0, 1, 4};
+    auto bad_mesh = quad_data(3);
+    bad_mesh.triangles = indices;
+    REQUIRE_THROWS(backend.CreateMesh(bad_mesh));
+
+    // Uniform ranges have to be aligned and within what was uploaded.
+    char uniform_data[1024]{};
+    REQUIRE_THROWS(backend.BindUniforms(VGE::UniformBlock::Draw, 0, 64));
+    backend.UploadUniforms(uniform_data, sizeof(uniform_data));
+    backend.BindUniforms(VGE::UniformBlock::Draw, 512, 64);
+    REQUIRE_THROWS(backend.BindUniforms(VGE::UniformBlock::Draw, 64, 64));
+    REQUIRE_THROWS(backend.BindUniforms(VGE::UniformBlock::Draw, 768, 512));
+
+    // The immediate buffer is 64 bytes.
+    float lines[32]{};
+    backend.DrawLines(lines, 2, 32);
+    REQUIRE_THROWS(backend.DrawLines(lines, 4, 32));
+}
+
+TEST_CASE("Null backend counts uploads and state changes", "[gfx_backend]")
+{
+    VGE::NullBackend backend;
+    backend.Init(1024);
+    backend.RecordCalls(true);
+
+    const auto mesh = backend.CreateMesh(quad_data());
+    const auto& stats = backend.GetStats();
+    REQUIRE(stats.MeshBytes == 6 * 4 + 4 * 12 + 4 * 8);
+
+    unsigned char pixels[4 * 4 * 4]{};
+    const auto texture = backend.CreateTexture(pixels, 4, 4, 4);
+    REQUIRE(stats.TextureBytes == 64);
+    REQUIRE(stats.UploadedBytes == stats.MeshBytes + stats.TextureBytes);
+
+    backend.ResetStats();
+    REQUIRE(backend.Calls().Size() == 0);
+
+    const auto program = linked_program(backend);
+    backend.BindProgram(program);
+    backend.BindTexture(0, texture);
+    backend.BindMesh(mesh);
+    backend.DrawIndexed(6);
+    backend.BindProgram(program);
+    backend.BindTexture(0, texture);
+    backend.BindTexture(1, texture);
+    backend.BindMesh(mesh);
+    backend.DrawIndexed(3);
+
+    REQUIRE(stats.StateChanges == 4);
+    REQUIRE(stats.RedundantBinds == 3);
+    REQUIRE(stats.Draws == 2);
+    REQUIRE(stats.Indices == 9);
+    REQUIRE(stats.Calls[(int)CallType::BindTexture] == 3);
+
+    const auto& calls = backend.Calls();
+    REQUIRE(calls.Size() == 15); // 6 for the program
+    REQUIRE(calls[6].Type == CallType::BindProgram);
+    REQUIRE(calls[6].Object == program);
+    REQUIRE(calls[14].Type == CallType::DrawIndexed);
+    REQUIRE(calls[14].Object == mesh.VAO);
+    REQUIRE(calls[14].Value == 3);
+}
+
+TEST_CASE("GFXManager destroys meshes that never got any data", "[gfx_backend]")
+{
+    VGE::NullBackend backend;
+    const ManagerScope manager(backend);
+    backend.RecordCalls(true);
+
+    // Like GL, the null backend ignores the zero names of a mesh that was never created.
+    const auto objects = backend.ObjectCount();
+    REQUIRE_NOTHROW(backend.DestroyMesh(VGE::MeshBuffers{}));
+    REQUIRE(backend.ObjectCount() == objects);
+
+    auto& gfx = VGE::gGfxManager;
+    const auto mesh = gfx.CreateMesh();
+    REQUIRE_NOTHROW(gfx.DestroyMesh(mesh));
+    REQUIRE(backend.GetStats().Calls[(int)CallType::DestroyMesh] == 1);
+
+    // The handle is gone, so it warns instead of destroying anything.
+    gfx.DestroyMesh(mesh);
+    REQUIRE(backend.GetStats().Calls[(int)CallType::DestroyMesh] == 1);
+}
+
+TEST_CASE("GFXManager renders a frame recorded from jobs headless", "[gfx_backend]")
+{
+    constexpr auto draw_count = 100;
+
+    VGE::NullBackend backend(64);
+    backend.RecordCalls(true);
+
+    auto& gfx = VGE::gGfxManager;
+    const ManagerScope manager(backend);
+
+    const Scene scene(2);
+    REQUIRE(gfx.GetShaderID(scene.Shader) != 0);
+    REQUIRE(scene.View.Valid());
+    REQUIRE(scene.Model.Offset == 0);
+
+    auto& system = VGE::gJobSystem;
+    system.Init(3);
+
+    gfx.SetUniform(gfx.FrameUniforms(), scene.View, glm::mat4(1.0f));
+
+    VGE::JobCounter counter{};
+    for (int i = 0; i < draw_count; i++)
+        system.Run(system.CreateJob([&scene, i]() { scene.Record(i); }), &counter);
+
+    system.WaitForCounter(&counter);
+    system.Shutdown();
+
+    backend.ResetStats();
+    gfx.SubmitStatic(0);
+    gfx.RenderStatic(0);
+
+    // The draws sharing a mesh are drawn together, so only the first draw of each mesh binds anything but uniforms.
+    const auto& stats = backend.GetStats();
+    REQUIRE(stats.Draws == draw_count);
+    REQUIRE(stats.Indices == draw_count * 6);
+    REQUIRE(stats.Calls[(int)CallType::UploadUniforms] == 1);
+    REQUIRE(stats.Calls[(int)CallType::BindUniforms] == draw_count + 1);
+    REQUIRE(stats.Calls[(int)CallType::BindProgram] == 1);
+    REQUIRE(stats.Calls[(int)CallType::BindMesh] == 3); // Unbound at the end
+    // A 128 byte PerFrame block, 99 PerDraw blocks of 96 bytes padded to 128, and the last PerDraw block of 96 bytes.
+    REQUIRE(stats.UniformBytes == 128 + 128 * (draw_count - 1) + 96);
+
+    // Every draw has its own uniforms.
+    const auto& calls = backend.Calls();
+    std::vector<bool> seen(stats.UniformBytes / 64);
+    for (int i = 0; i < calls.Size(); i++)
+    {
+        if (calls[i].Type != CallType::BindUniforms || calls[i].Value != 96)
+            continue;
+
+        REQUIRE(!seen[calls[i].Object / 64]);
+        seen[calls[i].Object / 64] = true;
+    }
+}
+
+TEST_CASE("GFXManager frame of 10k draws on the null backend", "[.][benchmark][gfx_backend]")
+{
+    constexpr auto draw_count = 10000;
+    static constexpr auto draws_pr_job = 100;
+
+    VGE::NullBackend backend;
+
+    auto& gfx = VGE::gGfxManager;
+    const ManagerScope manager(backend);
+
+    const Scene scene(Scene::MaxMeshes);
+
+    auto& system = VGE::gJobSystem;
+    system.Init(3);
+
+    const auto frame = [&]()
+    {
+        gfx.SetUniform(gfx.FrameUniforms(), scene.View, glm::mat4(1.0f));
+
+        VGE::JobCounter counter{};
+        for (int first = 0; first < draw_count; first += draws_pr_job)
+        {
+            system.Run(system.CreateJob([&scene, first]()
+            {
+                for (int i = first; i < first + draws_pr_job; i++)
+                    scene.Record(i);
+            }), &counter);
+        }
+        system.WaitForCounter(&counter);
+
+        gfx.SubmitStatic(0);
+        gfx.RenderStatic(0);
+    };
+
+    BENCHMARK("Record, submit and render 10k draws")
+    {
+        frame();
+    }
+
+    backend.ResetStats();
+    frame();
+    const auto& stats = backend.GetStats();
+    WARN("Pr frame: " << stats.Draws << " draws, " << stats.StateChanges << " state changes, "
+         << stats.RedundantBinds << " redundant binds, " << stats.UniformBytes << " bytes of uniforms");
+
+    system.Shutdown();
+}
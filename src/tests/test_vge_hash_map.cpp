@@ -0,0 +1,253 @@
+#include <catch.h>
+#include <vge_hash_map.h>
+#include <vge_memory.h>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("Hash map is empty upon creation", "[hash_map]")
+{
+    VGE::HashMap<int, int> map;
+    REQUIRE(map.Size() == 0);
+    REQUIRE(map.Capacity() == 0);
+    REQUIRE(map.Find(1) == nullptr);
+    REQUIRE(!map.Remove(1));
+    REQUIRE(map.Begin() == map.End());
+}
+
+TEST_CASE("Hash map insert, find and remove", "[hash_map]")
+{
+    VGE::HashMap<u32, int> map;
+    for (u32 i = 0; i < 10000; i++)
+        REQUIRE(map.Insert(i * 7, (int)i).second);
+
+    REQUIRE(map.Size() == 10000);
+    REQUIRE(!map.Insert(7, -1).second);
+    REQUIRE(*map.Find(7) == 1);
+
+    for (u32 i = 0; i < 10000; i++)
+    {
+        REQUIRE(map.Find(i * 7));
+        REQUIRE(*map.Find(i * 7) == (int)i);
+        REQUIRE(!map.Contains(i * 7 + 1));
+    }
+
+    for (u32 i = 0; i < 10000; i += 2)
+        REQUIRE(map.Remove(i * 7));
+
+    REQUIRE(map.Size() == 5000);
+    for (u32 i = 0; i < 10000; i++)
+        REQUIRE(map.Contains(i * 7) == (i % 2 == 1));
+
+    map[3] = 42;
+    map[3]++;
+    REQUIRE(*map.Find(3) == 43);
+}
+
+TEST_CASE("Hash map heterogeneous lookup", "[hash_map]")
+{
+    VGE::HashMap<std::string, int> map;
+    map.Insert("resources/shaders/basic_shader.vs", 1);
+    map.Insert("resources/shaders/basic_shader.fs", 2);
+    map.Insert("a key that is longer than the small string buffer of std::string", 3);
+
+    const char* path = "resources/shaders/basic_shader.fs";
+    REQUIRE(*map.Find(path) == 2);
+    REQUIRE(*map.Find(std::string_view("resources/shaders/basic_shader.vs")) == 1);
+    REQUIRE(*map.Find(std::string("a key that is longer than the small string buffer of std::string")) == 3);
+    REQUIRE(map.Find("resources/shaders/basic_shader") == nullptr);
+
+    REQUIRE(map.Remove(path));
+    REQUIRE(!map.Contains(path));
+    REQUIRE(map.Size() == 2);
+}
+
+TEST_CASE("Hash map iteration", "[hash_map]")
+{
+    VGE::HashMap<int, int> map;
+    for (int i = 0; i < 1000; i++)
+        map.Insert(i, i * 2);
+    for (int i = 0; i < 1000; i += 3)
+        map.Remove(i);
+
+    int count = 0;
+    i64 sum = 0;
+    for (auto& entry : map)
+    {
+        REQUIRE(entry.Value == entry.Key * 2);
+        sum += entry.Key;
+        count++;
+    }
+    REQUIRE(count == map.Size());
+
+    i64 expected = 0;
+    for (int i = 0; i < 1000; i++)
+        expected += (i % 3) ? i : 0;
+    REQUIRE(sum == expected);
+}
+
+TEST_CASE("Hash map does not grow under churn", "[hash_map]")
+{
+    VGE::HashMap<u64, u64> map;
+    map.Reserve(1000);
+    const auto capacity = map.Capacity();
+    REQUIRE(capacity * 7 >= 1000 * 8);
+
+    // Every removal leaves a deleted slot behind, they are cleaned out by rehashing in place.
+    for (u64 i = 0; i < 1000000; i++)
+    {
+        map.Insert(i, i);
+        if (i >= 1000)
+            REQUIRE(map.Remove(i - 1000));
+    }
+    REQUIRE(map.Size() == 1000);
+    REQUIRE(map.Capacity() == capacity);
+}
+
+TEST_CASE("Hash map matches std::unordered_map", "[hash_map]")
+{
+    VGE::HashMap<std::string, std::unique_ptr<int>> map;
+    std::unordered_map<std::string, int> reference;
+
+    std::mt19937 rng(1234);
+    for (int i = 0; i < 200000; i++)
+    {
+        const auto key = "key " + std::to_string(rng() % 5000);
+        switch (rng() % 3)
+        {
+            case 0:
+            {
+                const auto inserted = map.Insert(key, std::make_unique<int>(i)).second;
+                REQUIRE(inserted == reference.emplace(key, i).second);
+            } break;
+
+            case 1:
+                REQUIRE(map.Remove(key.c_str()) == (reference.erase(key) == 1));
+                break;
+
+            case 2:
+            {
+                const auto found = map.Find(key.c_str());
+                const auto it = reference.find(key);
+                REQUIRE((found != nullptr) == (it != reference.end()));
+                if (found)
+                    REQUIRE(**found == it->second);
+            } break;
+        }
+    }
+
+    REQUIRE(map.Size() == (int)reference.size());
+    for (const auto& [key, value] : reference)
+        REQUIRE(**map.Find(key) == value);
+}
+
+TEST_CASE("Hash map allocates from its allocator", "[hash_map]")
+{
+    constexpr auto cap = 1024 * 1024;
+    auto memory = std::malloc(cap);
+    VGE::MemoryManager manager;
+    VGE::ThreadCachingAllocator allocator(memory, cap, "hash_map", &manager);
+    {
+        VGE::HashMap<int, std::string> map(allocator);
+        for (int i = 0; i < 100; i++)
+            map.Insert(i, std::to_string(i));
+
+        REQUIRE(allocator.AllocatedSize() > 0);
+
+        auto moved = std::move(map);
+        REQUIRE(moved.Size() == 100);
+        REQUIRE(map.Size() == 0);
+        REQUIRE(*moved.Find(99) == "99");
+    }
+    REQUIRE(allocator.AllocatedSize() == 0);
+    std::free(memory);
+}
+
+TEST_CASE("HashMap vs std::unordered_map", "[.][benchmark][hash_map]")
+{
+    constexpr auto count = 1 << 20;
+
+    std::vector<u64> keys(count);
+    std::mt19937_64 rng(42);
+    for (auto& key : keys)
+        key = rng();
+
+    VGE::HashMap<u64, u64> map;
+    std::unordered_map<u64, u64> reference;
+
+    BENCHMARK("HashMap, insert 1M")
+    {
+        for (auto key : keys)
+            map.Insert(key, key);
+    }
+
+    BENCHMARK("std::unordered_map, insert 1M")
+    {
+        for (auto key : keys)
+            reference.emplace(key, key);
+    }
+
+    BENCHMARK("HashMap, find 1M hits")
+    {
+        u64 sum = 0;
+        for (auto key : keys)
+            sum += *map.Find(key);
+        REQUIRE(sum);
+    }
+
+    BENCHMARK("std::unordered_map, find 1M hits")
+    {
+        u64 sum = 0;
+        for (auto key : keys)
+            sum += reference.find(key)->second;
+        REQUIRE(sum);
+    }
+
+    BENCHMARK("HashMap, find 1M misses")
+    {
+        int found = 0;
+        for (auto key : keys)
+            found += map.Contains(key + 1);
+        REQUIRE(found == 0);
+    }
+
+    BENCHMARK("std::unordered_map, find 1M misses")
+    {
+        int found = 0;
+        for (auto key : keys)
+            found += reference.count(key + 1);
+        REQUIRE(found == 0);
+    }
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < 10000; i++)
+        paths.push_back("resources/meshes/asset_" + std::to_string(i) + ".obj");
+
+    VGE::HashMap<std::string, int> path_map;
+    std::unordered_map<std::string, int> path_reference;
+    for (int i = 0; i < (int)paths.size(); i++)
+    {
+        path_map.Insert(paths[i], i);
+        path_reference.emplace(paths[i], i);
+    }
+
+    BENCHMARK("HashMap, find 10k paths by const char*")
+    {
+        int sum = 0;
+        for (const auto& path : paths)
+            sum += *path_map.Find(path.c_str());
+        REQUIRE(sum);
+    }
+
+    // Constructs a std::string for every lookup.
+    BENCHMARK("std::unordered_map, find 10k paths by const char*")
+    {
+        int sum = 0;
+        for (const auto& path : paths)
+            sum += path_reference.find(path.c_str())->second;
+        REQUIRE(sum);
+    }
+}
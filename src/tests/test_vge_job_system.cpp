@@ -0,0 +1,194 @@
+#include <catch.h>
+#include <vge_job_system.h>
+#include <vge_allocator.h>
+#include <atomic>
+#include <thread>
+
+TEST_CASE("Work stealing queue is LIFO for owner and FIFO for stealers", "[job_system]")
+{
+    static VGE::WorkStealingQueue queue;
+    VGE::Job jobs[3];
+
+    for (auto& job : jobs)
+        queue.Push(&job);
+
+    REQUIRE(queue.Size() == 3);
+    REQUIRE(queue.Steal() == &jobs[0]);
+    REQUIRE(queue.Pop() == &jobs[2]);
+    REQUIRE(queue.Pop() == &jobs[1]);
+    REQUIRE(queue.Pop() == nullptr);
+    REQUIRE(queue.Steal() == nullptr);
+}
+
+TEST_CASE("Jobs run without any workers when waited upon", "[job_system]")
+{
+    auto& system = VGE::gJobSystem;
+    system.Init(0);
+
+    int value = 0;
+    auto job = system.CreateJob([&value]() { value = 42; });
+    system.Run(job);
+    system.Wait(job);
+
+    system.Shutdown();
+    REQUIRE(value == 42);
+}
+
+TEST_CASE("Parent is not finished before all children are", "[job_system]")
+{
+    auto& system = VGE::gJobSystem;
+    system.Init(3);
+
+    std::atomic<int> sum = 0;
+    auto root = system.CreateJob([]() {});
+
+    for (int i = 0; i < 1000; i++)
+    {
+        auto child = system.CreateJob([&sum]() { sum.fetch_add(1); }, root);
+        system.Run(child);
+    }
+
+    system.Run(root);
+    system.Wait(root);
+
+    system.Shutdown();
+    REQUIRE(sum.load() == 1000);
+}
+
+TEST_CASE("Jobs can spawn and wait for children while running", "[job_system]")
+{
+    auto& system = VGE::gJobSystem;
+    system.Init(3);
+
+    std::atomic<int> leaves = 0;
+    std::atomic<bool> children_done = false;
+    auto root = system.CreateJob([&leaves, &children_done](VGE::Job*)
+    {
+        auto& system = VGE::gJobSystem;
+        auto parent = system.CreateJob([]() {});
+        for (int i = 0; i < 64; i++)
+            system.Run(system.CreateJob([&leaves]() { leaves.fetch_add(1); }, parent));
+
+        system.Run(parent);
+        system.Wait(parent);
+        children_done.store(leaves.load() == 64);
+    });
+
+    system.Run(root);
+    system.Wait(root);
+
+    system.Shutdown();
+    REQUIRE(children_done.load());
+    REQUIRE(leaves.load() == 64);
+}
+
+TEST_CASE("Counter reaches zero when all jobs are done", "[job_system]")
+{
+    auto& system = VGE::gJobSystem;
+    system.Init(3);
+
+    std::atomic<int> executed_by[VGE::Thread::MaxThreads]{};
+    VGE::JobCounter counter = 0;
+
+    for (int i = 0; i < 2000; i++)
+    {
+        auto job = system.CreateJob([&executed_by]()
+        {
+            executed_by[VGE::Thread::ThisThread::ID()].fetch_add(1);
+        });
+        system.Run(job, &counter);
+    }
+
+    system.WaitForCounter(&counter);
+    system.Shutdown();
+
+    int total = 0;
+    for (auto& count : executed_by)
+        total += count.load();
+
+    REQUIRE(counter.load() == 0);
+    REQUIRE(total == 2000);
+}
+
+TEST_CASE("Waiting fibers are suspended instead of blocking the thread", "[job_system][fiber]")
+{
+    auto& system = VGE::gJobSystem;
+    system.Init(0, VGE::GetDefaultAllocator());
+    REQUIRE(system.UsesFibers());
+
+    // Every job blocks on the gate, so without fibers this would only make progress through nesting.
+    VGE::JobCounter gate = 1;
+    VGE::JobCounter not_started = 100;
+    VGE::JobCounter counter = 0;
+    std::atomic<int> done = 0;
+
+    for (int i = 0; i < 100; i++)
+    {
+        auto job = system.CreateJob([&gate, &not_started, &done]()
+        {
+            not_started.fetch_sub(1);
+            VGE::gJobSystem.WaitForCounter(&gate);
+            done.fetch_add(1);
+        });
+        system.Run(job, &counter);
+    }
+
+    system.WaitForCounter(&not_started);
+    REQUIRE(done.load() == 0);
+
+    gate.store(0);
+    system.WaitForCounter(&counter);
+    REQUIRE(done.load() == 100);
+
+    system.Shutdown();
+    REQUIRE_FALSE(system.UsesFibers());
+}
+
+TEST_CASE("ThisThread::ID is correct after a fiber is resumed", "[job_system][fiber]")
+{
+    auto& system = VGE::gJobSystem;
+    system.Init(3, VGE::GetDefaultAllocator());
+
+    struct Sample
+    {
+        VGE::Thread::ThreadID VGEID;
+        std::thread::id StdID;
+    };
+
+    static Sample samples[512];
+    std::atomic<int> sample_count = 0;
+    VGE::JobCounter counter = 0;
+
+    for (int i = 0; i < 256; i++)
+    {
+        auto job = system.CreateJob([&sample_count](VGE::Job* self)
+        {
+            auto& system = VGE::gJobSystem;
+            samples[sample_count.fetch_add(1)] = {VGE::Thread::ThisThread::ID(), std::this_thread::get_id()};
+
+            for (int j = 0; j < 8; j++)
+                system.Run(system.CreateJob([]() { std::this_thread::yield(); }, self));
+
+            VGE::JobCounter children = 0;
+            system.Run(system.CreateJob([]() { std::this_thread::yield(); }), &children);
+            system.WaitForCounter(&children);
+
+            samples[sample_count.fetch_add(1)] = {VGE::Thread::ThisThread::ID(), std::this_thread::get_id()};
+        });
+        system.Run(job, &counter);
+    }
+
+    system.WaitForCounter(&counter);
+    system.Shutdown();
+
+    // Every VGE ID must always have been reported by the same OS thread.
+    std::thread::id owners[VGE::Thread::MaxThreads]{};
+    for (int i = 0; i < sample_count.load(); i++)
+    {
+        auto& owner = owners[samples[i].VGEID];
+        if (owner == std::thread::id())
+            owner = samples[i].StdID;
+
+        REQUIRE(owner == samples[i].StdID);
+    }
+}
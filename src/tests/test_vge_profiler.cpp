@@ -0,0 +1,197 @@
+#include <catch.h>
+#include <vge_profiler.h>
+#include <vge_frame_allocator.h>
+#include <vge_thread.h>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    VGE::ProfileEvent
+    MakeEvent(const char* label, VGE::ProfileTimePoint begin, VGE::ProfileTimePoint end)
+    {
+        return VGE::ProfileEvent(label, __func__, __LINE__, begin, end);
+    }
+}
+
+TEST_CASE("Profiler keeps more than 256 events pr frame", "[profiler]")
+{
+    static VGE::Profiler profiler;
+
+    profiler.BeginFrame();
+    const auto now = VGE::Clock::now();
+    for (int i = 0; i < 1000; i++)
+        profiler.PushProfileEvent(MakeEvent("event", now, now + std::chrono::microseconds(1)));
+    profiler.EndFrame();
+
+    const auto frame = profiler.GetFrame(0);
+    REQUIRE(frame);
+
+    int count = 0;
+    profiler.ForEachEvent(*frame, VGE::Thread::ThisThread::ID(), [&count](const VGE::ProfileEvent&) { count++; });
+    REQUIRE(count == 1000);
+}
+
+TEST_CASE("Profiler keeps a history of frames", "[profiler]")
+{
+    static VGE::Profiler profiler;
+    REQUIRE(profiler.GetFrame(0) == nullptr);
+
+    for (int i = 0; i < VGE::Profiler::MaxFrames + 10; i++)
+    {
+        profiler.BeginFrame();
+        const auto now = VGE::Clock::now();
+        profiler.PushProfileEvent(MakeEvent("event", now, now));
+    }
+
+    // The last frame is still in progress.
+    REQUIRE(profiler.GetFrame(0) != nullptr);
+    REQUIRE(profiler.GetFrame(0) == &profiler.mFrames[(profiler.mFrameCount - 2) % VGE::Profiler::MaxFrames]);
+    REQUIRE(profiler.GetFrame(VGE::Profiler::MaxFrames - 2) != nullptr);
+    REQUIRE(profiler.GetFrame(VGE::Profiler::MaxFrames - 1) == nullptr);
+}
+
+TEST_CASE("Events spanning frames show up in every frame they overlap", "[profiler]")
+{
+    static VGE::Profiler profiler;
+    const auto thread_id = VGE::Thread::ThisThread::ID();
+
+    profiler.BeginFrame();
+    const auto begin = VGE::Clock::now();
+    profiler.EndFrame();
+
+    profiler.BeginFrame();
+    const auto end = VGE::Clock::now();
+    profiler.PushProfileEvent(MakeEvent("spanning", begin, end));
+    profiler.EndFrame();
+
+    for (int frames_back = 0; frames_back < 2; frames_back++)
+    {
+        int count = 0;
+        profiler.ForEachEvent(*profiler.GetFrame(frames_back), thread_id, [&count](const VGE::ProfileEvent& event)
+        {
+            count += std::strcmp(event.Label, "spanning") == 0;
+        });
+        REQUIRE(count == 1);
+    }
+}
+
+TEST_CASE("Profiler aggregates statistics pr call site", "[profiler]")
+{
+    static VGE::Profiler profiler;
+    const auto now = VGE::Clock::now();
+
+    // Durations 1..100 microseconds spread over two frames, from two call sites.
+    for (int frame = 0; frame < 2; frame++)
+    {
+        profiler.BeginFrame();
+        for (int i = 1; i <= 50; i++)
+        {
+            const auto duration = std::chrono::microseconds(frame * 50 + i);
+            profiler.PushProfileEvent(VGE::ProfileEvent("a", "function_a", 1, now, now + duration));
+        }
+        profiler.PushProfileEvent(VGE::ProfileEvent("b", "function_b", 2, now, now + std::chrono::milliseconds(1)));
+        profiler.EndFrame();
+    }
+
+    REQUIRE(profiler.mCallSiteCount == 2);
+
+    const auto site = profiler.FindCallSite("function_a", 1, false);
+    REQUIRE(site);
+    REQUIRE(profiler.FindCallSite("function_a", 2, false) == nullptr);
+
+    const auto stats = profiler.ComputeStats(*site, 2);
+    REQUIRE(stats.Count == 100);
+    REQUIRE(stats.Min == std::chrono::microseconds(1));
+    REQUIRE(stats.Max == std::chrono::microseconds(100));
+    REQUIRE(stats.Total == std::chrono::microseconds(5050));
+    REQUIRE(stats.P50 == std::chrono::microseconds(50));
+    REQUIRE(stats.P95 == std::chrono::microseconds(95));
+    REQUIRE(stats.P99 == std::chrono::microseconds(99));
+
+    // Only the last frame.
+    const auto last = profiler.ComputeStats(*site, 1);
+    REQUIRE(last.Count == 50);
+    REQUIRE(last.Min == std::chrono::microseconds(51));
+    REQUIRE(last.P50 == std::chrono::microseconds(75));
+}
+
+TEST_CASE("Profiler counts frames over budget", "[profiler]")
+{
+    static VGE::Profiler profiler;
+    profiler.mFrameBudgetMs = 1.0f;
+
+    profiler.BeginFrame();
+    profiler.EndFrame();
+
+    profiler.BeginFrame();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    profiler.EndFrame();
+
+    REQUIRE(profiler.mOverBudgetFrames == 1);
+    REQUIRE(profiler.IsOverBudget(*profiler.GetFrame(0)));
+    REQUIRE_FALSE(profiler.IsOverBudget(*profiler.GetFrame(1)));
+}
+
+static_assert(VGE::Basename("a/b/file.cpp")[0] == 'f', "Basename should strip unix directories");
+static_assert(VGE::Basename("a\\b\\file.cpp")[0] == 'f', "Basename should strip windows directories");
+static_assert(VGE::Basename("file.cpp")[0] == 'f', "Basename should leave plain filenames alone");
+
+TEST_CASE("VGE_PROFILE labels events with the basename of the file", "[profiler]")
+{
+    const auto thread_id = VGE::Thread::ThisThread::ID();
+    const auto head = VGE::gProfiler.mThreadEvents[thread_id].Head.load();
+    {
+        VGE_PROFILE();
+    }
+
+    VGE::ProfileEvent event;
+    REQUIRE(VGE::gProfiler.mThreadEvents[thread_id].Head.load() == head + 1);
+    REQUIRE(VGE::gProfiler.ReadEvent(thread_id, head, event));
+    REQUIRE(std::strcmp(event.Label, "test_vge_profiler.cpp") == 0);
+    REQUIRE(event.Begin <= event.End);
+}
+
+TEST_CASE("Profile scope overhead", "[.][benchmark][profiler]")
+{
+    constexpr auto iterations = 1000000;
+
+    // Reports the time of all iterations, divide by the count to get the cost of a single scope.
+    BENCHMARK("1M x VGE_PROFILE()")
+    {
+        for (int i = 0; i < iterations; i++)
+        {
+            VGE_PROFILE();
+        }
+    }
+
+    BENCHMARK("1M x VGE::Clock::now()")
+    {
+        for (int i = 0; i < iterations; i++)
+        {
+            const volatile auto now = VGE::Clock::now();
+            (void)now;
+        }
+    }
+
+    BENCHMARK("1M x std::chrono::high_resolution_clock::now()")
+    {
+        for (int i = 0; i < iterations; i++)
+        {
+            const volatile auto now = std::chrono::high_resolution_clock::now();
+            (void)now;
+        }
+    }
+}
+
+TEST_CASE("Profiler frames leave the frame allocators alone", "[profiler][frame_allocator]")
+{
+    static VGE::Profiler profiler;
+    const auto frame_allocator = VGE::GetFrameAllocator();
+    const auto frame = frame_allocator->FrameNumber();
+
+    // The frame boundary of the engine belongs to the main loop, not to any profiler instance.
+    profiler.BeginFrame();
+    REQUIRE(frame_allocator->FrameNumber() == frame);
+    profiler.EndFrame();
+}
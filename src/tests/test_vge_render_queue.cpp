@@ -0,0 +1,177 @@
+#include <catch.h>
+#include <vge_render_queue.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+    VGE::StaticDrawCommand
+    make_command(int shader, int texture, int mesh, float depth = 0.0f)
+    {
+        VGE::StaticDrawCommand command;
+        command.Shader = {shader, 0};
+        command.UV0 = {texture, 0};
+        command.Mesh = {mesh, 0};
+        command.Depth = depth;
+        return command;
+    }
+
+    // What binding on every change would cost when drawing in submission order.
+    int
+    count_changes(const std::vector<VGE::StaticDrawCommand>& commands)
+    {
+        int changes = 0;
+        for (size_t i = 0; i < commands.size(); i++)
+        {
+            const auto first = i == 0;
+            changes += first || commands[i].Shader != commands[i - 1].Shader;
+            changes += first || commands[i].UV0 != commands[i - 1].UV0 || commands[i].UV1 != commands[i - 1].UV1;
+            changes += first || commands[i].Mesh != commands[i - 1].Mesh;
+        }
+        return changes;
+    }
+}
+
+TEST_CASE("Sort key orders by shader, texture, mesh and then depth", "[render_queue]")
+{
+    const auto key = [](int shader, int texture, int mesh, float depth)
+    {
+        return VGE::RenderQueue::MakeSortKey(make_command(shader, texture, mesh, depth));
+    };
+
+    REQUIRE(key(0, 9, 9, 100.0f) < key(1, 0, 0, 0.0f));
+    REQUIRE(key(1, 0, 9, 100.0f) < key(1, 1, 0, 0.0f));
+    REQUIRE(key(1, 1, 0, 100.0f) < key(1, 1, 1, 0.0f));
+    REQUIRE(key(1, 1, 1, 0.5f) < key(1, 1, 1, 2.0f));
+    REQUIRE(key(1, 1, 1, -1.0f) == key(1, 1, 1, 0.0f));
+
+    // No texture sorts before the first texture.
+    REQUIRE(key(1, -1, 1, 0.0f) < key(1, 0, 1, 0.0f));
+
+    // The second texture orders after the first, but before the mesh.
+    auto with_uv1 = make_command(1, 1, 9, 100.0f);
+    with_uv1.UV1 = {0, 0};
+    REQUIRE(key(1, 1, 9, 100.0f) < VGE::RenderQueue::MakeSortKey(with_uv1));
+    REQUIRE(VGE::RenderQueue::MakeSortKey(with_uv1) < key(1, 2, 0, 0.0f));
+
+    REQUIRE_THROWS(key(0xFFFF, 0, 0, 0.0f));
+    REQUIRE_THROWS(key(0, 0xFF, 0, 0.0f));
+}
+
+TEST_CASE("Render queue groups draws by their second texture", "[render_queue]")
+{
+    constexpr auto draw_count = 64;
+
+    // Same shader and first texture, alternating between two second textures and two meshes.
+    VGE::RenderQueue queue;
+    for (int i = 0; i < draw_count; i++)
+    {
+        auto command = make_command(0, 0, i % 2, (float)i);
+        command.UV1 = {(i / 2) % 2, 0};
+        queue.Submit(command);
+    }
+
+    queue.Sort();
+    for (int i = 1; i < draw_count; i++)
+    {
+        const auto& previous = queue.Command(i - 1);
+        const auto& command = queue.Command(i);
+        REQUIRE(previous.UV1.idx <= command.UV1.idx);
+        if (previous.UV1 == command.UV1)
+            REQUIRE(previous.Mesh.idx <= command.Mesh.idx);
+    }
+
+    // Each second texture is bound once, instead of at almost every draw.
+    const auto& stats = queue.GetStats();
+    REQUIRE(stats.TextureBinds == 2);
+    REQUIRE(stats.MeshBinds == 4);
+}
+
+TEST_CASE("Render queue replays draws sharing state together", "[render_queue]")
+{
+    constexpr auto shader_count = 3;
+    constexpr auto texture_count = 4;
+    constexpr auto mesh_count = 8;
+    constexpr auto draw_count = 1000;
+
+    std::mt19937 rng(1234);
+    std::vector<VGE::StaticDrawCommand> commands;
+    for (int i = 0; i < draw_count; i++)
+    {
+        auto command = make_command(rng() % shader_count, rng() % texture_count, rng() % mesh_count, (float)(rng() % 1000) / 10.0f);
+        command.Uniforms = (u32)i; // Tags the command, so we can check that nothing got lost.
+        commands.push_back(command);
+    }
+
+    VGE::RenderQueue queue;
+    for (const auto& command : commands)
+        queue.Submit(command);
+
+    REQUIRE(queue.Size() == draw_count);
+    queue.Sort();
+
+    std::vector<bool> seen(draw_count);
+    for (int i = 0; i < queue.Size(); i++)
+    {
+        const auto& command = queue.Command(i);
+        REQUIRE(!seen[command.Uniforms]);
+        seen[command.Uniforms] = true;
+
+        if (i > 0)
+        {
+            const auto& previous = queue.Command(i - 1);
+            REQUIRE(VGE::RenderQueue::MakeSortKey(previous) <= VGE::RenderQueue::MakeSortKey(command));
+
+            // The flags say exactly what differs from the previous draw.
+            const auto changes = queue.Changes(i);
+            REQUIRE(((changes & VGE::RenderQueue::ChangeShader) != 0) == (previous.Shader != command.Shader));
+            REQUIRE(((changes & VGE::RenderQueue::ChangeTextures) != 0) == (previous.UV0 != command.UV0));
+            REQUIRE(((changes & VGE::RenderQueue::ChangeMesh) != 0) == (previous.Mesh != command.Mesh));
+        }
+    }
+
+    REQUIRE(queue.Changes(0) == (VGE::RenderQueue::ChangeShader | VGE::RenderQueue::ChangeTextures | VGE::RenderQueue::ChangeMesh));
+
+    // Every shader is bound once, every texture once pr shader, and every mesh once pr shader and texture.
+    const auto& stats = queue.GetStats();
+    REQUIRE(stats.Draws == draw_count);
+    REQUIRE(stats.ShaderBinds == shader_count);
+    REQUIRE(stats.TextureBinds == shader_count * texture_count);
+    REQUIRE(stats.MeshBinds == shader_count * texture_count * mesh_count);
+    REQUIRE(stats.AvoidedShaderBinds == draw_count - shader_count);
+    REQUIRE(stats.AvoidedTextureBinds == draw_count - shader_count * texture_count);
+    REQUIRE(stats.AvoidedMeshBinds == draw_count - shader_count * texture_count * mesh_count);
+
+    // Far fewer than skipping redundant binds in submission order would give.
+    const auto sorted_changes = stats.ShaderBinds + stats.TextureBinds + stats.MeshBinds;
+    REQUIRE(sorted_changes * 10 < count_changes(commands));
+
+    // The stats survive clearing, until the next sort.
+    queue.Clear();
+    REQUIRE(queue.Size() == 0);
+    REQUIRE(queue.GetStats().Draws == draw_count);
+}
+
+TEST_CASE("Render queue keeps submission order for equal keys", "[render_queue]")
+{
+    VGE::RenderQueue queue;
+    for (int i = 0; i < 10; i++)
+    {
+        auto command = make_command(0, 0, 0, 1.0f);
+        command.Uniforms = (u32)i;
+        queue.Submit(command);
+    }
+
+    // Closer, so drawn first.
+    queue.Submit(make_command(0, 0, 0, 0.5f));
+
+    queue.Sort();
+    REQUIRE(queue.Command(0).Depth == 0.5f);
+    for (int i = 1; i < queue.Size(); i++)
+    {
+        REQUIRE(queue.Command(i).Uniforms == (u32)(i - 1));
+        REQUIRE(queue.Changes(i) == 0);
+    }
+
+    REQUIRE(queue.GetStats().AvoidedMeshBinds == 10);
+}
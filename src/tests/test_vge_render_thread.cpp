@@ -0,0 +1,105 @@
+#include <catch.h>
+#include <vge_render_thread.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Render thread renders every frame in order", "[render_thread]")
+{
+    constexpr auto frame_count = 100;
+    constexpr auto render_id = VGE::Thread::MaxThreads - 1;
+
+    // Double buffered, like the static frames of the GFXManager.
+    int slots[VGE::RenderThread::FrameCount]{};
+    std::vector<int> rendered;
+    std::atomic<bool> started{};
+    std::atomic<bool> stopped{};
+    std::atomic<bool> wrong_thread{};
+
+    VGE::RenderThread render_thread(render_id);
+    render_thread.Start([&]()
+    {
+        started = true;
+        wrong_thread = wrong_thread || VGE::Thread::ThisThread::ID() != render_id;
+    },
+    [&](int slot)
+    {
+        wrong_thread = wrong_thread || VGE::Thread::ThisThread::ID() != render_id;
+        rendered.push_back(slots[slot]);
+
+        // Give the main thread time to overwrite the slot, which it must not.
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        rendered.push_back(slots[slot]);
+    },
+    [&]()
+    {
+        stopped = true;
+    });
+
+    REQUIRE(render_thread.IsRunning());
+    for (int i = 0; i < frame_count; i++)
+    {
+        const auto slot = render_thread.BeginFrame();
+        REQUIRE(slot == i % VGE::RenderThread::FrameCount);
+        slots[slot] = i;
+        render_thread.EndFrame();
+
+        // At most one frame in flight while recording the next.
+        REQUIRE(render_thread.SubmittedFrames() - render_thread.RenderedFrames() <= (u64)VGE::RenderThread::FrameCount);
+    }
+
+    // Frames handed over before stopping are still rendered.
+    render_thread.Stop();
+    REQUIRE_FALSE(render_thread.IsRunning());
+    REQUIRE(started);
+    REQUIRE(stopped);
+    REQUIRE_FALSE(wrong_thread);
+    REQUIRE(render_thread.RenderedFrames() == frame_count);
+
+    REQUIRE(rendered.size() == (size_t)frame_count * 2);
+    for (int i = 0; i < frame_count; i++)
+    {
+        REQUIRE(rendered[i * 2] == i);
+        REQUIRE(rendered[i * 2 + 1] == i);
+    }
+
+    REQUIRE_THROWS(render_thread.BeginFrame());
+}
+
+TEST_CASE("Render thread overlaps rendering with recording the next frame", "[render_thread]")
+{
+    VGE::RenderThread render_thread(VGE::Thread::MaxThreads - 1);
+
+    std::atomic<bool> recording_second{};
+    std::atomic<bool> overlapped{};
+    render_thread.Start(nullptr, [&](int slot)
+    {
+        if (slot != 0)
+            return;
+
+        // Frame 0 is only done once the main thread is recording frame 1.
+        const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!recording_second && std::chrono::steady_clock::now() < give_up)
+            std::this_thread::yield();
+
+        overlapped = recording_second.load();
+    });
+
+    REQUIRE(render_thread.BeginFrame() == 0);
+    render_thread.EndFrame();
+
+    REQUIRE(render_thread.BeginFrame() == 1);
+    recording_second = true;
+    render_thread.EndFrame();
+
+    render_thread.Flush();
+    REQUIRE(render_thread.RenderedFrames() == 2);
+    REQUIRE(overlapped);
+
+    REQUIRE(render_thread.BeginFrame() == 0);
+    REQUIRE_THROWS(render_thread.BeginFrame());
+    render_thread.EndFrame();
+    REQUIRE_THROWS(render_thread.EndFrame());
+    render_thread.Stop();
+}
@@ -1,5 +1,10 @@
 #include <catch.h>
 #include <vge_slot_map.h>
+#include <vge_array.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
 
 TEST_CASE("Size is empty upon creation", "[slot_map]")
 {
@@ -51,3 +56,261 @@ TEST_CASE("Ensure contiguous memory", "[slot_map]")
     map.Remove(idx);
     REQUIRE(map[0] == 1);
 }
+
+TEST_CASE("Handles stay valid when growing", "[slot_map]")
+{
+    VGE::SlotMap<std::string> map;
+    std::vector<VGE::SlotMap<std::string>::Handle> handles;
+    for (int i = 0; i < 1000; i++)
+        handles.push_back(map.Insert("item " + std::to_string(i)));
+
+    REQUIRE(map.Size() == 1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        REQUIRE(map[handles[i]]);
+        REQUIRE(*map[handles[i]] == "item " + std::to_string(i));
+    }
+}
+
+TEST_CASE("Handles stay valid when removing", "[slot_map]")
+{
+    VGE::SlotMap<std::string> map;
+    std::vector<VGE::SlotMap<std::string>::Handle> handles;
+    for (int i = 0; i < 64; i++)
+        handles.push_back(map.Insert(std::to_string(i)));
+
+    for (int i = 0; i < 64; i += 3)
+        map.Remove(handles[i]);
+
+    for (int i = 0; i < 64; i++)
+    {
+        if (i % 3 == 0)
+            REQUIRE(map[handles[i]] == nullptr);
+        else
+            REQUIRE(*map[handles[i]] == std::to_string(i));
+    }
+}
+
+TEST_CASE("Removed slots are reused with a new generation", "[slot_map]")
+{
+    VGE::SlotMap<int> map;
+    const auto first = map.Insert(1);
+    map.Insert(2);
+    map.Remove(first);
+
+    const auto capacity = map.Capacity();
+    const auto second = map.Insert(3);
+    REQUIRE(map.Capacity() == capacity);
+    REQUIRE(second.idx == first.idx);
+    REQUIRE(second.gen != first.gen);
+    REQUIRE(map[first] == nullptr);
+    REQUIRE(*map[second] == 3);
+}
+
+TEST_CASE("Nullptr on invalid handle", "[slot_map]")
+{
+    VGE::SlotMap<int> map;
+    map.Insert(1);
+    REQUIRE(map[VGE::SlotMap<int>::Handle{-1, 0}] == nullptr);
+    REQUIRE(map[VGE::SlotMap<int>::Handle{1 << 20, 0}] == nullptr);
+}
+
+TEST_CASE("Resolving handles", "[.][benchmark][slot_map]")
+{
+    constexpr auto count = 100000;
+
+    struct resource
+    {
+        int handle;
+        int payload[7];
+    };
+
+    VGE::SlotMap<resource> map;
+    VGE::Array<resource> table;
+    std::vector<VGE::SlotMap<resource>::Handle> handles;
+    for (int i = 0; i < count; i++)
+    {
+        handles.push_back(map.Insert({i, {i}}));
+        table.PushBack({i, {i}});
+    }
+
+    // Draw calls rarely come in the order the resources were created.
+    std::vector<int> order(count);
+    for (int i = 0; i < count; i++)
+        order[i] = (int)(((u64)i * 7919) % count);
+
+    BENCHMARK("SlotMap, 100k handles")
+    {
+        int sum = 0;
+        for (auto i : order)
+            sum += map[handles[i]]->payload[0];
+        REQUIRE(sum != 0);
+    }
+
+    // Only a hundredth of the handles, the search is linear in the number of resources.
+    BENCHMARK("Linear search, 1k of 100k handles")
+    {
+        int sum = 0;
+        for (int i = 0; i < count / 100; i++)
+        {
+            const auto handle = order[i];
+            sum += std::find_if(table.Begin(), table.End(), [=](const auto& item) { return item.handle == handle; })->payload[0];
+        }
+        REQUIRE(sum != 0);
+    }
+}
+
+TEST_CASE("Reserve keeps handles valid", "[slot_map]")
+{
+    VGE::SlotMap<std::string> map;
+    const auto first = map.Insert("first");
+    map.Reserve(100);
+    REQUIRE(map.Capacity() == 100);
+    REQUIRE(*map[first] == "first");
+
+    for (int i = 1; i < 100; i++)
+        map.Insert(std::to_string(i));
+    REQUIRE(map.Capacity() == 100);
+
+    map.Reserve(10);
+    REQUIRE(map.Capacity() == 100);
+}
+
+TEST_CASE("Iterating over dense data", "[slot_map]")
+{
+    VGE::SlotMap<int> map;
+    std::vector<VGE::SlotMap<int>::Handle> handles;
+    for (int i = 0; i < 100; i++)
+        handles.push_back(map.Insert(i));
+
+    for (int i = 0; i < 100; i += 2)
+        map.Remove(handles[i]);
+
+    int sum = 0;
+    for (auto it = map.Begin(); it != map.End(); it++)
+        sum += *it;
+    REQUIRE(sum == 50 * 50);
+    REQUIRE(map.End() - map.Begin() == map.Size());
+    REQUIRE(map.Data() == map.Begin());
+}
+
+TEST_CASE("Clear invalidates all handles", "[slot_map]")
+{
+    VGE::SlotMap<std::string> map;
+    std::vector<VGE::SlotMap<std::string>::Handle> handles;
+    for (int i = 0; i < 10; i++)
+        handles.push_back(map.Insert(std::to_string(i)));
+
+    const auto capacity = map.Capacity();
+    map.Clear();
+    REQUIRE(map.Size() == 0);
+    for (const auto& handle : handles)
+        REQUIRE(map[handle] == nullptr);
+
+    for (int i = 0; i < capacity; i++)
+        map.Insert(std::to_string(i));
+    REQUIRE(map.Capacity() == capacity);
+}
+
+TEST_CASE("Slots are reused under churn", "[slot_map]")
+{
+    VGE::SlotMap<int> map;
+    std::vector<VGE::SlotMap<int>::Handle> handles;
+    for (int i = 0; i < 1000; i++)
+        handles.push_back(map.Insert(i));
+
+    const auto capacity = map.Capacity();
+    for (int i = 0; i < 1000000; i++)
+    {
+        auto& handle = handles[i % handles.size()];
+        map.Remove(handle);
+        handle = map.Insert(i);
+    }
+    REQUIRE(map.Capacity() == capacity);
+    REQUIRE(map.Size() == 1000);
+}
+
+namespace
+{
+    struct counted
+    {
+        static inline int live = 0;
+
+        counted(int v) : value(std::make_unique<int>(v)) { live++; }
+        counted(const counted& other) : value(std::make_unique<int>(*other.value)) { live++; }
+        counted(counted&& other) noexcept : value(std::move(other.value)) { live++; }
+        counted& operator=(counted&& other) noexcept { value = std::move(other.value); return *this; }
+        ~counted() { live--; }
+
+        std::unique_ptr<int> value;
+    };
+
+    template<class T>
+    void
+    stress(int operations)
+    {
+        VGE::SlotMap<T> map;
+        std::vector<std::pair<typename VGE::SlotMap<T>::Handle, int>> live;
+        std::vector<typename VGE::SlotMap<T>::Handle> dead;
+
+        const auto value_of = [](const T& item)
+        {
+            if constexpr (std::is_same_v<T, counted>)
+                return *item.value;
+            else
+                return item;
+        };
+
+        u32 state = 1234;
+        for (int i = 0; i < operations; i++)
+        {
+            state = state * 1664525u + 1013904223u;
+
+            // Grows on average, but with long stretches of shrinking.
+            const auto remove = !live.empty() && ((state >> 8) % 100) < ((i / 100000) % 2 ? 70u : 40u);
+            if (remove)
+            {
+                const auto pick = (state >> 4) % live.size();
+                map.Remove(live[pick].first);
+                dead.push_back(live[pick].first);
+                live[pick] = live.back();
+                live.pop_back();
+            }
+            else
+            {
+                live.emplace_back(map.Insert(T(i)), i);
+            }
+        }
+
+        REQUIRE(map.Size() == (int)live.size());
+        for (const auto& [handle, value] : live)
+        {
+            const auto item = map[handle];
+            REQUIRE(item);
+            REQUIRE(value_of(*item) == value);
+        }
+
+        // A reused slot has a new generation, so none of the removed handles may resolve.
+        for (const auto& handle : dead)
+            REQUIRE(map[handle] == nullptr);
+
+        i64 sum = 0;
+        i64 expected = 0;
+        for (auto it = map.Begin(); it != map.End(); it++)
+            sum += value_of(*it);
+        for (const auto& [handle, value] : live)
+            expected += value;
+        REQUIRE(sum == expected);
+    }
+}
+
+TEST_CASE("Stress inserting and removing trivial elements", "[slot_map]")
+{
+    stress<int>(2000000);
+}
+
+TEST_CASE("Stress inserting and removing non trivial elements", "[slot_map]")
+{
+    stress<counted>(2000000);
+    REQUIRE(counted::live == 0);
+}
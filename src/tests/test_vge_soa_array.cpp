@@ -0,0 +1,137 @@
+#include <catch.h>
+#include <vge_soa_array.h>
+#include <vge_array.h>
+#include <string>
+
+namespace
+{
+    struct vec3
+    {
+        float x, y, z;
+    };
+}
+
+TEST_CASE("SoAArray is empty upon creation", "[soa_array]")
+{
+    VGE::SoAArray<int, float> array;
+    REQUIRE(array.Size() == 0);
+    REQUIRE(array.Begin() == array.End());
+    REQUIRE(array.Column<0>().Empty());
+}
+
+TEST_CASE("SoAArray columns grow together", "[soa_array]")
+{
+    VGE::SoAArray<vec3, double, char> array;
+    for (int i = 0; i < 1000; i++)
+        array.PushBack({(float)i, 0.0f, 0.0f}, i * 0.5, (char)(i % 128));
+
+    REQUIRE(array.Size() == 1000);
+    REQUIRE(array.Capacity() >= 1000);
+
+    const auto positions = array.Column<0>();
+    const auto weights = array.Column<1>();
+    const auto tags = array.Column<2>();
+    REQUIRE(positions.Size() == 1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        REQUIRE(positions[i].x == (float)i);
+        REQUIRE(weights[i] == i * 0.5);
+        REQUIRE(tags[i] == (char)(i % 128));
+    }
+
+    // Every column starts on its own cache line.
+    REQUIRE(VGE::IsAligned(positions.Data(), array.ColumnAlignment));
+    REQUIRE(VGE::IsAligned(weights.Data(), array.ColumnAlignment));
+    REQUIRE(VGE::IsAligned(tags.Data(), array.ColumnAlignment));
+}
+
+TEST_CASE("SoAArray zip iterators", "[soa_array]")
+{
+    VGE::SoAArray<int, std::string, float> array;
+    for (int i = 0; i < 100; i++)
+        array.PushBack(i, std::to_string(i), 0.0f);
+
+    for (auto [idx, name, value] : array)
+        value = (float)idx + (float)name.size();
+
+    int count = 0;
+    for (auto [idx, value] : array.Zip<0, 2>())
+    {
+        REQUIRE(value == (float)idx + (float)std::to_string(idx).size());
+        count++;
+    }
+    REQUIRE(count == 100);
+
+    const auto& const_array = array;
+    auto [idx, name, value] = const_array[42];
+    REQUIRE(idx == 42);
+    REQUIRE(name == "42");
+    REQUIRE(value == 44.0f);
+}
+
+TEST_CASE("SoAArray resize and clear non trivial columns", "[soa_array]")
+{
+    VGE::SoAArray<std::string, int> array;
+    array.PushBack("a string long enough to not fit in the small buffer", 1);
+    array.Resize(10);
+    REQUIRE(array.Size() == 10);
+    REQUIRE(std::get<0>(array[0]) == "a string long enough to not fit in the small buffer");
+    REQUIRE(std::get<0>(array[9]).empty());
+
+    array.Resize(1);
+    REQUIRE(array.Size() == 1);
+
+    auto moved = std::move(array);
+    REQUIRE(moved.Size() == 1);
+    REQUIRE(array.Size() == 0);
+
+    moved.Clear();
+    REQUIRE(moved.Size() == 0);
+    REQUIRE_THROWS(moved[0]);
+}
+
+TEST_CASE("SoAArray vs Array", "[.][benchmark][soa_array]")
+{
+    struct particle
+    {
+        vec3 position;
+        vec3 velocity;
+        vec3 color;
+        float age;
+        int flags[6];
+    };
+
+    constexpr auto count = 1 << 20;
+    VGE::Array<particle> aos;
+    VGE::SoAArray<vec3, vec3, vec3, float, int> soa;
+    aos.Reserve(count);
+    soa.Reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        aos.PushBack({{(float)i, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {}, 0.0f, {}});
+        soa.PushBack({(float)i, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {}, 0.0f, 0);
+    }
+
+    // Only touches the positions and velocities.
+    BENCHMARK("Array of structs, integrate 1M positions")
+    {
+        for (auto p = aos.Begin(); p != aos.End(); p++)
+        {
+            p->position.x += p->velocity.x * 0.016f;
+            p->position.y += p->velocity.y * 0.016f;
+            p->position.z += p->velocity.z * 0.016f;
+        }
+    }
+
+    BENCHMARK("SoAArray, integrate 1M positions")
+    {
+        for (auto [position, velocity] : soa.Zip<0, 1>())
+        {
+            position.x += velocity.x * 0.016f;
+            position.y += velocity.y * 0.016f;
+            position.z += velocity.z * 0.016f;
+        }
+    }
+
+    REQUIRE(aos[7].position.x == std::get<0>(soa[7]).x);
+}
@@ -0,0 +1,165 @@
+#include <catch.h>
+#include <vge_string.h>
+#include <vge_memory.h>
+#include <vge_thread.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+TEST_CASE("String is empty upon creation", "[string]")
+{
+    VGE::String str;
+    REQUIRE(str.Empty());
+    REQUIRE(str.Size() == 0);
+    REQUIRE(str.IsSmall());
+    REQUIRE(std::strcmp(str.CStr(), "") == 0);
+}
+
+TEST_CASE("Short strings are stored inline", "[string]")
+{
+    constexpr auto cap = 1024 * 1024;
+    auto memory = std::malloc(cap);
+    VGE::MemoryManager manager;
+    VGE::ThreadCachingAllocator allocator(memory, cap, "string", &manager);
+    {
+        VGE::String small("fifteen chars!!", allocator);
+        REQUIRE(small.Size() == VGE::String::SmallCapacity);
+        REQUIRE(small.IsSmall());
+        REQUIRE(allocator.AllocatedSize() == 0);
+
+        VGE::String large("sixteen chars!!!", allocator);
+        REQUIRE(!large.IsSmall());
+        REQUIRE(large == "sixteen chars!!!");
+        REQUIRE(allocator.AllocatedSize() > 0);
+
+        small += " and then some";
+        REQUIRE(!small.IsSmall());
+        REQUIRE(small == "fifteen chars!! and then some");
+    }
+    REQUIRE(allocator.AllocatedSize() == 0);
+    std::free(memory);
+}
+
+TEST_CASE("String copy and move", "[string]")
+{
+    for (auto text : {"short", "a string long enough to live on the heap"})
+    {
+        VGE::String a(text);
+        VGE::String b = a;
+        REQUIRE(b == text);
+        REQUIRE(b.CStr() != a.CStr());
+
+        VGE::String c = std::move(a);
+        REQUIRE(c == text);
+        REQUIRE(a.Empty());
+        REQUIRE(c.IsSmall() == (std::strlen(text) <= VGE::String::SmallCapacity));
+
+        a = c;
+        REQUIRE(a == text);
+        b = std::move(c);
+        REQUIRE(b == text);
+        REQUIRE(c.Empty());
+
+        b = b;
+        REQUIRE(b == text);
+    }
+}
+
+TEST_CASE("String append", "[string]")
+{
+    VGE::String str;
+    std::string expected;
+    for (int i = 0; i < 1000; i++)
+    {
+        const auto number = std::to_string(i);
+        str += number;
+        expected += number;
+    }
+    REQUIRE(str == expected);
+    REQUIRE(str.Size() == (i64)expected.size());
+    REQUIRE(str.CStr()[str.Size()] == '\0');
+
+    // Appending a view of itself survives the reallocation.
+    str.Append(str);
+    REQUIRE(str == expected + expected);
+
+    str.Clear();
+    REQUIRE(str.Empty());
+    REQUIRE(str.Capacity() >= (i64)expected.size() * 2);
+
+    str = "again";
+    REQUIRE(str == "again");
+    REQUIRE(str[0] == 'a');
+    REQUIRE_THROWS(str[5]);
+}
+
+TEST_CASE("String as hash map key", "[string]")
+{
+    VGE::HashMap<VGE::String, int> map;
+    map.Insert("a key long enough to live on the heap", 1);
+    map.Insert("short", 2);
+
+    REQUIRE(*map.Find("short") == 2);
+    REQUIRE(*map.Find(std::string_view("a key long enough to live on the heap")) == 1);
+    REQUIRE(!map.Contains("missing"));
+}
+
+TEST_CASE("Interned strings", "[string_id]")
+{
+    VGE::StringID empty;
+    REQUIRE(empty.Empty());
+    REQUIRE(std::strcmp(empty.CStr(), "") == 0);
+    REQUIRE(VGE::StringID("") == empty);
+
+    VGE::StringID a("projection");
+    VGE::StringID b(std::string("projection"));
+    VGE::StringID c("view");
+    REQUIRE(a == b);
+    REQUIRE(a != c);
+    REQUIRE(!a.Empty());
+    REQUIRE(a.CStr() == b.CStr());
+    REQUIRE(std::strcmp(c.CStr(), "view") == 0);
+
+    // Strings larger than a storage block.
+    std::string large(100 * 1024, 'x');
+    VGE::StringID d(large);
+    REQUIRE(d.CStr() == large);
+    REQUIRE(VGE::StringID(large) == d);
+}
+
+TEST_CASE("Interning from many threads", "[string_id]")
+{
+    constexpr auto thread_count = VGE::Thread::MaxThreads - 1;
+    constexpr auto count = 2000;
+    static u32 ids[thread_count][count];
+    std::atomic<bool> matching{true};
+
+    std::unique_ptr<VGE::Thread> threads[thread_count];
+    for (int t = 0; t < thread_count; t++)
+    {
+        threads[t] = std::make_unique<VGE::Thread>(t + 1);
+        threads[t]->Start([t, &matching]()
+        {
+            for (int i = 0; i < count; i++)
+            {
+                const auto str = "thread_string_" + std::to_string(i);
+                VGE::StringID id(str);
+                if (id.CStr() != str)
+                    matching.store(false);
+                ids[t][i] = id.Value();
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread->Join();
+
+    REQUIRE(matching.load());
+
+    // Every thread got the same id for the same string.
+    for (int t = 1; t < thread_count; t++)
+        for (int i = 0; i < count; i++)
+            REQUIRE(ids[t][i] == ids[0][i]);
+}
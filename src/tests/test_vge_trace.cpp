@@ -0,0 +1,81 @@
+#include <catch.h>
+#include <vge_trace.h>
+#include <vge_thread.h>
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    std::string
+    ReadFile(const char* filepath)
+    {
+        std::string result;
+        if (auto file = std::fopen(filepath, "r"))
+        {
+            char buffer[4096];
+            while (const auto read = std::fread(buffer, 1, sizeof(buffer), file))
+                result.append(buffer, read);
+            std::fclose(file);
+        }
+        return result;
+    }
+}
+
+TEST_CASE("Trace exporter writes events from every thread", "[profiler][trace]")
+{
+    static VGE::Profiler profiler;
+    VGE::TraceExporter exporter;
+    const char* filepath = "vge_test_trace.json";
+
+    REQUIRE(exporter.Start(filepath, &profiler, 1));
+    REQUIRE(exporter.IsRunning());
+
+    // Named after the start, still shows up in the trace.
+    profiler.SetThreadName(1, "Worker");
+
+    VGE::Thread thread(1);
+    thread.Start([]()
+    {
+        VGE::RAIIProfiler scope("worker \"quoted\"", __func__, __LINE__, &profiler);
+    });
+    const auto now = VGE::Clock::now();
+    profiler.PushProfileEvent(VGE::ProfileEvent("back\\slash", __func__, __LINE__, now, now));
+    thread.Join();
+
+    exporter.Stop();
+    REQUIRE_FALSE(exporter.IsRunning());
+    REQUIRE(exporter.WrittenEvents() == 2);
+    REQUIRE(exporter.DroppedEvents() == 0);
+
+    const auto trace = ReadFile(filepath);
+    std::remove(filepath);
+
+    REQUIRE(trace.find("\"traceEvents\":[") != std::string::npos);
+    REQUIRE(trace.find("\"tid\":1,") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"Worker (ThreadID: 1)\"") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"ThreadID: 0\"") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"worker \\\"quoted\\\"\"") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"back\\\\slash\"") != std::string::npos);
+    REQUIRE(trace.rfind("]}") != std::string::npos);
+}
+
+TEST_CASE("Trace exporter counts events that were overwritten before being flushed", "[profiler][trace]")
+{
+    static VGE::Profiler profiler;
+    VGE::TraceExporter exporter;
+    const char* filepath = "vge_test_trace_dropped.json";
+
+    REQUIRE(exporter.Start(filepath, &profiler, 60 * 1000));
+
+    const auto pushed = VGE::Profiler::MaxEvents * 2;
+    const auto now = VGE::Clock::now();
+    for (int i = 0; i < pushed; i++)
+        profiler.PushProfileEvent(VGE::ProfileEvent("event", __func__, __LINE__, now, now));
+
+    exporter.Stop();
+    std::remove(filepath);
+
+    REQUIRE(exporter.DroppedEvents() > 0);
+    REQUIRE(exporter.WrittenEvents() + exporter.DroppedEvents() == (u64)pushed);
+}
@@ -0,0 +1,101 @@
+#include <catch.h>
+#include <vge_uniform_arena.h>
+#include <cstring>
+
+namespace
+{
+    VGE::Uniform
+    make_uniform(VGE::UniformBlock block, int offset, int size)
+    {
+        VGE::Uniform uniform;
+        uniform.Block = block;
+        uniform.Offset = offset;
+        uniform.Size = (u16)size;
+        return uniform;
+    }
+}
+
+TEST_CASE("Draw commands are small", "[uniform_arena]")
+{
+    // Used to carry 16 uniforms of a name and a mat4 each, about 1.2 KB.
+    REQUIRE(sizeof(VGE::StaticDrawCommand) <= 48);
+    REQUIRE(sizeof(VGE::Uniform) <= 12);
+}
+
+TEST_CASE("Uniform blocks are aligned and zeroed", "[uniform_arena]")
+{
+    VGE::UniformArena arena;
+    arena.SetAlignment(256);
+    REQUIRE(arena.Size() == 0);
+
+    const auto first = arena.Allocate(64);
+    const auto second = arena.Allocate(100);
+    const auto third = arena.Allocate(16);
+    REQUIRE(first == 0);
+    REQUIRE(second == 256);
+    REQUIRE(third == 512);
+    REQUIRE(arena.Size() == 512 + 16);
+
+    for (int i = 0; i < arena.Size(); i++)
+        REQUIRE(arena.Data()[i] == 0);
+
+    REQUIRE_THROWS(arena.SetAlignment(100));
+    REQUIRE_THROWS(arena.Allocate(0));
+}
+
+TEST_CASE("Uniforms are written at their offset in the block", "[uniform_arena]")
+{
+    VGE::UniformArena arena;
+    arena.SetAlignment(64);
+
+    const auto frame = arena.Allocate(128);
+    const auto draw = arena.Allocate(80);
+
+    const auto projection = make_uniform(VGE::UniformBlock::Frame, 64, 16 * sizeof(float));
+    const auto model = make_uniform(VGE::UniformBlock::Draw, 0, 16 * sizeof(float));
+    const auto tint = make_uniform(VGE::UniformBlock::Draw, 64, 4 * sizeof(float));
+
+    float matrix[16];
+    for (int i = 0; i < 16; i++)
+        matrix[i] = (float)i;
+    const float color[4] = {1.0f, 0.5f, 0.25f, 1.0f};
+
+    arena.Write(frame, projection, matrix, sizeof(matrix));
+    arena.Write(draw, model, matrix, sizeof(matrix));
+    arena.Write(draw, tint, color, sizeof(color));
+
+    REQUIRE(std::memcmp(arena.Data() + frame + 64, matrix, sizeof(matrix)) == 0);
+    REQUIRE(std::memcmp(arena.Data() + draw, matrix, sizeof(matrix)) == 0);
+    REQUIRE(std::memcmp(arena.Data() + draw + 64, color, sizeof(color)) == 0);
+
+    // Uniforms the shader does not have are ignored, like location -1 in OpenGL.
+    arena.Write(draw, VGE::Uniform(), color, sizeof(color));
+
+    // Wrong size, or outside of the arena.
+    REQUIRE_THROWS(arena.Write(draw, tint, matrix, sizeof(matrix)));
+    REQUIRE_THROWS(arena.Write(draw + 64, model, matrix, sizeof(matrix)));
+    REQUIRE_THROWS(arena.Write(VGE::NoUniforms, model, matrix, sizeof(matrix)));
+
+    arena.Reset();
+    REQUIRE(arena.Size() == 0);
+    REQUIRE(arena.Allocate(16) == 0);
+}
+
+TEST_CASE("Uniform arena grows", "[uniform_arena]")
+{
+    VGE::UniformArena arena;
+    arena.SetAlignment(256);
+
+    const float value = 42.0f;
+    const auto uniform = make_uniform(VGE::UniformBlock::Draw, 0, sizeof(float));
+    for (int i = 0; i < 10000; i++)
+    {
+        const auto block = arena.Allocate(64);
+        REQUIRE(block == (u32)i * 256);
+        arena.Write(block, uniform, &value, sizeof(value));
+    }
+
+    float read;
+    std::memcpy(&read, arena.Data() + 9999 * 256, sizeof(read));
+    REQUIRE(read == value);
+}
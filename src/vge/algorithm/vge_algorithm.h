@@ -1 +1,43 @@
 #pragma once
+#include <functional>
+#include <vge_allocator.h>
+#include <vge_array.h>
+#include <vge_job_system.h>
+#include <vge_span.h>
+
+namespace VGE
+{
+    // Stable LSD radix sort on unsigned 32 or 64 bit keys, 8 bits pr pass.
+    // All histograms are built in a single pass over the keys, and passes where every key has the same digit are skipped,
+    // so keys that only use their low bits (like sort keys with unused high fields) cost fewer passes.
+    // The scratch memory is the size of the input, taken from and given back to the allocator.
+    template<class K>
+    void RadixSort(Span<K> keys, Allocator& scratch = *GetDefaultAllocator());
+
+    // Sorts the values along with their keys.
+    template<class K, class V>
+    void RadixSort(Span<K> keys, Span<V> values, Allocator& scratch = *GetDefaultAllocator());
+
+    template<class K>
+    void RadixSort(Array<K>& keys, Allocator& scratch = *GetDefaultAllocator());
+
+    template<class K, class V>
+    void RadixSort(Array<K>& keys, Array<V>& values, Allocator& scratch = *GetDefaultAllocator());
+
+    // Stable merge sort for trivially copyable types, for when the order is not given by an integer key.
+    template<class T, class Less = std::less<T>>
+    void MergeSort(Span<T> items, Less less = {}, Allocator& scratch = *GetDefaultAllocator());
+
+    template<class T, class Less = std::less<T>>
+    void MergeSort(Array<T>& items, Less less = {}, Allocator& scratch = *GetDefaultAllocator());
+
+    // Splits the sort into jobs until the ranges are small enough, and merges the sorted halves on the way back up.
+    // The calling thread helps running the jobs, so it also works when the job system has no workers.
+    template<class T, class Less = std::less<T>>
+    void ParallelMergeSort(Span<T> items, Less less = {}, Allocator& scratch = *GetDefaultAllocator(), JobSystem& job_system = gJobSystem);
+
+    template<class T, class Less = std::less<T>>
+    void ParallelMergeSort(Array<T>& items, Less less = {}, Allocator& scratch = *GetDefaultAllocator(), JobSystem& job_system = gJobSystem);
+}
+
+#include <vge_algorithm.tpp>
@@ -0,0 +1,260 @@
+#include <vge_assert.h>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace VGE::detail
+{
+    struct NoValues {};
+
+    template<class K, class V>
+    void
+    RadixSort(K* keys, V* values, int count, Allocator& allocator)
+    {
+        static_assert(std::is_unsigned_v<K> && (sizeof(K) == 4 || sizeof(K) == 8), "Radix sort needs unsigned 32 or 64 bit keys");
+        static_assert(std::is_trivially_copyable_v<V>, "Radix sort moves the values with memcpy");
+        constexpr auto has_values = !std::is_same_v<V, NoValues>;
+        constexpr auto pass_count = (int)sizeof(K);
+
+        if (count < 2)
+            return;
+
+        u32 histograms[pass_count][256]{};
+        for (int i = 0; i < count; i++)
+        {
+            const auto key = keys[i];
+            for (int pass = 0; pass < pass_count; pass++)
+                histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+
+        auto key_scratch = (K*)allocator.Allocate(sizeof(K) * count, alignof(K));
+        V* value_scratch = nullptr;
+        if constexpr (has_values)
+            value_scratch = (V*)allocator.Allocate(sizeof(V) * count, alignof(V));
+
+        K* src = keys;
+        K* dst = key_scratch;
+        V* value_src = values;
+        V* value_dst = value_scratch;
+
+        for (int pass = 0; pass < pass_count; pass++)
+        {
+            const auto shift = pass * 8;
+            auto& histogram = histograms[pass];
+
+            // Every key has the same digit, the pass would not move anything.
+            if (histogram[(src[0] >> shift) & 0xFF] == (u32)count)
+                continue;
+
+            u32 offsets[256];
+            u32 sum = 0;
+            for (int digit = 0; digit < 256; digit++)
+            {
+                offsets[digit] = sum;
+                sum += histogram[digit];
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                const auto idx = offsets[(src[i] >> shift) & 0xFF]++;
+                dst[idx] = src[i];
+                if constexpr (has_values)
+                    value_dst[idx] = value_src[i];
+            }
+
+            std::swap(src, dst);
+            std::swap(value_src, value_dst);
+        }
+
+        // Odd number of passes, the result is in the scratch memory.
+        if (src != keys)
+        {
+            std::memcpy(keys, src, sizeof(K) * count);
+            if constexpr (has_values)
+                std::memcpy(values, value_src, sizeof(V) * count);
+        }
+
+        allocator.Deallocate(key_scratch);
+        if constexpr (has_values)
+            allocator.Deallocate(value_scratch);
+    }
+
+    // Runs shorter than this are insertion sorted before merging.
+    constexpr auto InsertionSortSize = 32;
+
+    template<class T, class Less>
+    void
+    InsertionSort(T* items, int count, const Less& less)
+    {
+        for (int i = 1; i < count; i++)
+        {
+            auto item = items[i];
+            auto j = i;
+            for (; j > 0 && less(item, items[j - 1]); j--)
+                items[j] = items[j - 1];
+            items[j] = item;
+        }
+    }
+
+    // Takes from the left on ties, which is what keeps the sort stable.
+    template<class T, class Less>
+    void
+    Merge(const T* left, int left_count, const T* right, int right_count, T* out, const Less& less)
+    {
+        int l = 0;
+        int r = 0;
+        while (l < left_count && r < right_count)
+            *out++ = less(right[r], left[l]) ? right[r++] : left[l++];
+
+        std::memcpy(out, left + l, sizeof(T) * (left_count - l));
+        std::memcpy(out + (left_count - l), right + r, sizeof(T) * (right_count - r));
+    }
+
+    // Bottom up merge sort, going back and forth between the items and the scratch memory.
+    template<class T, class Less>
+    void
+    MergeSortRange(T* items, T* scratch, int count, const Less& less)
+    {
+        for (int i = 0; i < count; i += InsertionSortSize)
+            InsertionSort(items + i, std::min(InsertionSortSize, count - i), less);
+
+        T* src = items;
+        T* dst = scratch;
+        for (int width = InsertionSortSize; width < count; width *= 2)
+        {
+            for (int begin = 0; begin < count; begin += width * 2)
+            {
+                const auto mid = std::min(begin + width, count);
+                const auto end = std::min(begin + width * 2, count);
+                Merge(src + begin, mid - begin, src + mid, end - mid, dst + begin, less);
+            }
+
+            std::swap(src, dst);
+        }
+
+        if (src != items)
+            std::memcpy(items, src, sizeof(T) * count);
+    }
+
+    template<class T, class Less>
+    struct ParallelSortContext
+    {
+        T* Items;
+        T* Scratch;
+        const Less* LessThan;
+        JobSystem* Jobs;
+        int Cutoff; // Ranges of this size or smaller are sorted by a single job.
+    };
+
+    // Sorts [begin, end), leaving the result in the scratch memory when into_scratch is true.
+    template<class T, class Less>
+    void
+    ParallelMergeSortRange(const ParallelSortContext<T, Less>* context, int begin, int end, bool into_scratch)
+    {
+        const auto count = end - begin;
+        if (count <= context->Cutoff)
+        {
+            MergeSortRange(context->Items + begin, context->Scratch + begin, count, *context->LessThan);
+            if (into_scratch)
+                std::memcpy(context->Scratch + begin, context->Items + begin, sizeof(T) * count);
+            return;
+        }
+
+        // The halves are sorted into the other buffer, so the merge lands where it was asked for without copying back.
+        const auto mid = begin + count / 2;
+        JobCounter counter{};
+        auto job = context->Jobs->CreateJob([context, begin, mid, into_scratch]()
+        {
+            ParallelMergeSortRange(context, begin, mid, !into_scratch);
+        });
+        context->Jobs->Run(job, &counter);
+
+        ParallelMergeSortRange(context, mid, end, !into_scratch);
+        context->Jobs->WaitForCounter(&counter);
+
+        const auto src = into_scratch ? context->Items : context->Scratch;
+        const auto dst = into_scratch ? context->Scratch : context->Items;
+        Merge(src + begin, mid - begin, src + mid, end - mid, dst + begin, *context->LessThan);
+    }
+}
+
+template<class K>
+void
+VGE::RadixSort(Span<K> keys, Allocator& scratch)
+{
+    detail::RadixSort(keys.Data(), (detail::NoValues*)nullptr, keys.Size(), scratch);
+}
+
+template<class K, class V>
+void
+VGE::RadixSort(Span<K> keys, Span<V> values, Allocator& scratch)
+{
+    VGE_ASSERT(keys.Size() == values.Size(), "Got %d keys, but %d values", keys.Size(), values.Size());
+    detail::RadixSort(keys.Data(), values.Data(), keys.Size(), scratch);
+}
+
+template<class K>
+void
+VGE::RadixSort(Array<K>& keys, Allocator& scratch)
+{
+    RadixSort(Span<K>(keys.Data(), keys.Size()), scratch);
+}
+
+template<class K, class V>
+void
+VGE::RadixSort(Array<K>& keys, Array<V>& values, Allocator& scratch)
+{
+    RadixSort(Span<K>(keys.Data(), keys.Size()), Span<V>(values.Data(), values.Size()), scratch);
+}
+
+template<class T, class Less>
+void
+VGE::MergeSort(Span<T> items, Less less, Allocator& scratch)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Merge sort moves the items with memcpy");
+
+    if (items.Size() < 2)
+        return;
+
+    auto memory = (T*)scratch.Allocate(sizeof(T) * items.Size(), alignof(T));
+    detail::MergeSortRange(items.Data(), memory, items.Size(), less);
+    scratch.Deallocate(memory);
+}
+
+template<class T, class Less>
+void
+VGE::MergeSort(Array<T>& items, Less less, Allocator& scratch)
+{
+    MergeSort(Span<T>(items.Data(), items.Size()), less, scratch);
+}
+
+template<class T, class Less>
+void
+VGE::ParallelMergeSort(Span<T> items, Less less, Allocator& scratch, JobSystem& job_system)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Merge sort moves the items with memcpy");
+
+    // Below this there is not enough work to make up for the jobs.
+    constexpr auto min_job_size = 16 * 1024;
+
+    // A few jobs pr thread, so threads that finish early can steal from the others.
+    const auto cutoff = std::max(min_job_size, items.Size() / ((job_system.WorkerCount() + 1) * 4));
+    if (items.Size() <= cutoff)
+    {
+        MergeSort(items, less, scratch);
+        return;
+    }
+
+    auto memory = (T*)scratch.Allocate(sizeof(T) * items.Size(), alignof(T));
+    const detail::ParallelSortContext<T, Less> context{items.Data(), memory, &less, &job_system, cutoff};
+    detail::ParallelMergeSortRange(&context, 0, items.Size(), false);
+    scratch.Deallocate(memory);
+}
+
+template<class T, class Less>
+void
+VGE::ParallelMergeSort(Array<T>& items, Less less, Allocator& scratch, JobSystem& job_system)
+{
+    ParallelMergeSort(Span<T>(items.Data(), items.Size()), less, scratch, job_system);
+}
@@ -1,3 +1,4 @@
+#include <vge_assert.h>
 #include <cstring>
 #include <algorithm>
 
@@ -6,8 +7,9 @@ VGE::Array<T>::Array(Allocator& allocator)
     : mAllocator(&allocator)
     , mSize(0)
     , mCap(2)
-    , mData((T*)mAllocator->Allocate(sizeof(T) * mCap))
+    , mData((T*)mAllocator->Allocate(sizeof(T) * mCap, alignof(T)))
 {
+    VGE_ASSERT(IsAligned(mData, alignof(T)), "Allocator returned memory that is not aligned to %d", (int)alignof(T));
 }
 
 template<class T>
@@ -183,7 +185,8 @@ VGE::Array<T>::Reserve(int new_cap)
     if (new_cap < mCap)
         return;
 
-    auto new_begin = (T*)mAllocator->Allocate(new_cap * sizeof(T));
+    auto new_begin = (T*)mAllocator->Allocate(new_cap * sizeof(T), alignof(T));
+    VGE_ASSERT(IsAligned(new_begin, alignof(T)), "Allocator returned memory that is not aligned to %d", (int)alignof(T));
 
     if constexpr (std::is_trivially_copyable_v<T>)
     {
@@ -0,0 +1,24 @@
+#include <vge_hash_map.h>
+#include <cstring>
+
+u64
+VGE::HashBytes(const void* data, i64 size)
+{
+    const auto bytes = (const u8*)data;
+    u64 hash = 0x9e3779b97f4a7c15ull ^ (u64)size;
+
+    i64 i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        u64 chunk;
+        std::memcpy(&chunk, bytes + i, sizeof(chunk));
+        hash = (hash ^ HashMix(chunk)) * 0x9fb21c651e98df25ull;
+    }
+
+    // The tail, at most 7 bytes.
+    u64 tail = 0;
+    for (auto shift = 0; i < size; i++, shift += 8)
+        tail |= (u64)bytes[i] << shift;
+
+    return HashMix(hash ^ tail);
+}
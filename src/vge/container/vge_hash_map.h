@@ -0,0 +1,203 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vge_allocator.h>
+#include <vge_bits.h>
+
+// MSVC doesn't define __SSE2__, but x64 always has it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VGE_HASH_MAP_SSE2 1
+#else
+#define VGE_HASH_MAP_SSE2 0
+#endif
+
+namespace VGE
+{
+    // Hashes a range of bytes, 8 at a time.
+    u64 HashBytes(const void* data, i64 size);
+
+    // Spreads the bits of an integer, the hash map uses both the low and the high bits.
+    VGE_INLINE u64
+    HashMix(u64 value)
+    {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdull;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ull;
+        value ^= value >> 33;
+        return value;
+    }
+
+    template<class T>
+    struct Hash
+    {
+        static_assert(std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>, "No VGE::Hash specialization for this type");
+
+        u64 operator()(T value) const
+        {
+            if constexpr (std::is_pointer_v<T>)
+                return HashMix((u64)(uintptr_t)value);
+            else
+                return HashMix((u64)value);
+        }
+    };
+
+    template<class T>
+    struct Equal
+    {
+        bool operator()(const T& a, const T& b) const { return a == b; }
+    };
+
+    // String keys can be looked up with anything convertible to a std::string_view,
+    // so looking up by a const char* does not construct a temporary key.
+    struct StringHash
+    {
+        using is_transparent = void;
+        u64 operator()(std::string_view str) const { return HashBytes(str.data(), (i64)str.size()); }
+    };
+
+    struct StringEqual
+    {
+        using is_transparent = void;
+        bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+    };
+
+    template<> struct Hash<std::string> : StringHash {};
+    template<> struct Hash<std::string_view> : StringHash {};
+    template<> struct Hash<const char*> : StringHash {};
+    template<> struct Equal<std::string> : StringEqual {};
+    template<> struct Equal<std::string_view> : StringEqual {};
+    template<> struct Equal<const char*> : StringEqual {};
+
+    // Open addressing hash map in the style of the Swiss tables from Abseil,
+    // see: https://abseil.io/about/design/swisstables
+    // Every slot has a control byte, which is either empty, deleted or holds 7 bits of the hash.
+    // Lookups probe a group of 16 control bytes at a time with SSE2, and only compare the keys
+    // of the slots whose 7 bits match, so a miss rarely touches the keys at all.
+    // Pointers to entries are invalidated when the map grows.
+    template<class K, class V, class H = Hash<K>, class E = Equal<K>>
+    class HashMap
+    {
+    public:
+        static constexpr auto GroupWidth = 16;
+
+        struct Entry
+        {
+            K Key;
+            V Value;
+        };
+
+        class Iterator
+        {
+        public:
+            Iterator(const i8* ctrl, const i8* end, Entry* entry);
+
+            Entry& operator*() const;
+            Entry* operator->() const;
+            Iterator& operator++();
+
+            bool operator==(const Iterator& other) const;
+            bool operator!=(const Iterator& other) const;
+
+        private:
+            void SkipEmpty();
+
+            const i8* mCtrl;
+            const i8* mEnd;
+            Entry* mEntry;
+        };
+
+        HashMap(Allocator& allocator = *GetDefaultAllocator());
+        HashMap(HashMap&&);
+        HashMap& operator=(HashMap&&);
+        HashMap(const HashMap& other) = delete;
+        HashMap& operator=(const HashMap& other) = delete;
+        ~HashMap();
+
+        // Returns the entry of the key, and whether it was inserted. An existing value is left untouched.
+        std::pair<Entry*, bool> Insert(K key, V value);
+
+        // Inserts a default constructed value when the key is missing.
+        V& operator[](const K& key);
+
+        V* Find(const K& key);
+        const V* Find(const K& key) const;
+        bool Contains(const K& key) const;
+        bool Remove(const K& key);
+
+        // Heterogeneous lookup when the hash and equal functions are transparent.
+        template<class Q, class HH = H, class = typename HH::is_transparent>
+        V* Find(const Q& key);
+
+        template<class Q, class HH = H, class = typename HH::is_transparent>
+        const V* Find(const Q& key) const;
+
+        template<class Q, class HH = H, class = typename HH::is_transparent>
+        bool Contains(const Q& key) const;
+
+        template<class Q, class HH = H, class = typename HH::is_transparent>
+        bool Remove(const Q& key);
+
+        void Clear();
+
+        // Makes room for count entries without growing.
+        void Reserve(int count);
+
+        int Size() const;
+        int Capacity() const;
+
+        Iterator Begin();
+        Iterator End();
+
+        // For range based for loops.
+        Iterator begin();
+        Iterator end();
+
+    private:
+        static constexpr i8 Empty = -128;
+        static constexpr i8 Deleted = -2;
+
+        // Bit i is set for the slots of the group that match.
+        struct Group
+        {
+            explicit Group(const i8* ctrl);
+
+            u32 Match(i8 h2) const;
+            u32 MatchEmpty() const;
+            u32 MatchEmptyOrDeleted() const;
+
+            #if VGE_HASH_MAP_SSE2
+            __m128i mCtrl;
+            #else
+            const i8* mCtrl;
+            #endif
+        };
+
+        template<class Q>
+        int FindSlot(const Q& key, u64 hash) const;
+
+        template<class Q>
+        bool RemoveKey(const Q& key);
+
+        int FindInsertSlot(u64 hash) const;
+        void EraseSlot(int slot);
+        void Rehash(int new_cap);
+        void DestroyEntries();
+
+        static u64 H1(u64 hash) { return hash >> 7; }
+        static i8 H2(u64 hash) { return (i8)(hash & 0x7f); }
+
+        Allocator* mAllocator{};
+        void* mMemory{};
+        i8* mCtrl{};
+        Entry* mEntries{};
+        int mSize{};
+        int mDeleted{};
+        int mCap{}; // Always a power of two and a multiple of the group width, or 0.
+    };
+}
+
+#include <vge_hash_map.tpp>
@@ -0,0 +1,497 @@
+#include <vge_assert.h>
+#include <cstring>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////
+/// Group
+///////////////////////////////////////////////////////////
+#if VGE_HASH_MAP_SSE2
+template<class K, class V, class H, class E>
+VGE::HashMap<K, V, H, E>::Group::Group(const i8* ctrl)
+    : mCtrl(_mm_load_si128((const __m128i*)ctrl))
+{
+}
+
+template<class K, class V, class H, class E>
+u32
+VGE::HashMap<K, V, H, E>::Group::Match(i8 h2) const
+{
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), mCtrl));
+}
+
+template<class K, class V, class H, class E>
+u32
+VGE::HashMap<K, V, H, E>::Group::MatchEmpty() const
+{
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(Empty), mCtrl));
+}
+
+template<class K, class V, class H, class E>
+u32
+VGE::HashMap<K, V, H, E>::Group::MatchEmptyOrDeleted() const
+{
+    // Only empty and deleted have the sign bit set.
+    return (u32)_mm_movemask_epi8(mCtrl);
+}
+#else
+template<class K, class V, class H, class E>
+VGE::HashMap<K, V, H, E>::Group::Group(const i8* ctrl)
+    : mCtrl(ctrl)
+{
+}
+
+template<class K, class V, class H, class E>
+u32
+VGE::HashMap<K, V, H, E>::Group::Match(i8 h2) const
+{
+    u32 mask = 0;
+    for (int i = 0; i < GroupWidth; i++)
+        mask |= (u32)(mCtrl[i] == h2) << i;
+
+    return mask;
+}
+
+template<class K, class V, class H, class E>
+u32
+VGE::HashMap<K, V, H, E>::Group::MatchEmpty() const
+{
+    return Match(Empty);
+}
+
+template<class K, class V, class H, class E>
+u32
+VGE::HashMap<K, V, H, E>::Group::MatchEmptyOrDeleted() const
+{
+    u32 mask = 0;
+    for (int i = 0; i < GroupWidth; i++)
+        mask |= (u32)(mCtrl[i] < 0) << i;
+
+    return mask;
+}
+#endif
+
+///////////////////////////////////////////////////////////
+/// Iterator
+///////////////////////////////////////////////////////////
+template<class K, class V, class H, class E>
+VGE::HashMap<K, V, H, E>::Iterator::Iterator(const i8* ctrl, const i8* end, Entry* entry)
+    : mCtrl(ctrl)
+    , mEnd(end)
+    , mEntry(entry)
+{
+    SkipEmpty();
+}
+
+template<class K, class V, class H, class E> typename
+VGE::HashMap<K, V, H, E>::Entry&
+VGE::HashMap<K, V, H, E>::Iterator::operator*() const
+{
+    return *mEntry;
+}
+
+template<class K, class V, class H, class E> typename
+VGE::HashMap<K, V, H, E>::Entry*
+VGE::HashMap<K, V, H, E>::Iterator::operator->() const
+{
+    return mEntry;
+}
+
+template<class K, class V, class H, class E> typename
+VGE::HashMap<K, V, H, E>::Iterator&
+VGE::HashMap<K, V, H, E>::Iterator::operator++()
+{
+    mCtrl++;
+    mEntry++;
+    SkipEmpty();
+    return *this;
+}
+
+template<class K, class V, class H, class E>
+bool
+VGE::HashMap<K, V, H, E>::Iterator::operator==(const Iterator& other) const
+{
+    return mCtrl == other.mCtrl;
+}
+
+template<class K, class V, class H, class E>
+bool
+VGE::HashMap<K, V, H, E>::Iterator::operator!=(const Iterator& other) const
+{
+    return mCtrl != other.mCtrl;
+}
+
+template<class K, class V, class H, class E>
+void
+VGE::HashMap<K, V, H, E>::Iterator::SkipEmpty()
+{
+    while (mCtrl != mEnd && *mCtrl < 0)
+    {
+        mCtrl++;
+        mEntry++;
+    }
+}
+
+///////////////////////////////////////////////////////////
+/// HashMap
+///////////////////////////////////////////////////////////
+template<class K, class V, class H, class E>
+VGE::HashMap<K, V, H, E>::HashMap(Allocator& allocator)
+    : mAllocator(&allocator)
+{
+}
+
+template<class K, class V, class H, class E>
+VGE::HashMap<K, V, H, E>::HashMap(HashMap&& other)
+    : mAllocator(other.mAllocator)
+    , mMemory(other.mMemory)
+    , mCtrl(other.mCtrl)
+    , mEntries(other.mEntries)
+    , mSize(other.mSize)
+    , mDeleted(other.mDeleted)
+    , mCap(other.mCap)
+{
+    other.mMemory = nullptr;
+    other.mCtrl = nullptr;
+    other.mEntries = nullptr;
+    other.mSize = 0;
+    other.mDeleted = 0;
+    other.mCap = 0;
+}
+
+template<class K, class V, class H, class E>
+VGE::HashMap<K, V, H, E>&
+VGE::HashMap<K, V, H, E>::operator=(HashMap&& other)
+{
+    if (this != &other)
+    {
+        DestroyEntries();
+        if (mMemory)
+            mAllocator->Deallocate(mMemory);
+
+        mAllocator = other.mAllocator;
+        mMemory = other.mMemory;
+        mCtrl = other.mCtrl;
+        mEntries = other.mEntries;
+        mSize = other.mSize;
+        mDeleted = other.mDeleted;
+        mCap = other.mCap;
+
+        other.mMemory = nullptr;
+        other.mCtrl = nullptr;
+        other.mEntries = nullptr;
+        other.mSize = 0;
+        other.mDeleted = 0;
+        other.mCap = 0;
+    }
+
+    return *this;
+}
+
+template<class K, class V, class H, class E>
+VGE::HashMap<K, V, H, E>::~HashMap()
+{
+    DestroyEntries();
+    if (mMemory)
+        mAllocator->Deallocate(mMemory);
+}
+
+template<class K, class V, class H, class E>
+template<class Q>
+int
+VGE::HashMap<K, V, H, E>::FindSlot(const Q& key, u64 hash) const
+{
+    if (!mCap)
+        return -1;
+
+    // Triangular probing over the groups visits every group once, as the group count is a power of two.
+    const auto group_mask = (u64)(mCap / GroupWidth - 1);
+    auto group = H1(hash) & group_mask;
+    for (u64 step = 1; ; step++)
+    {
+        const auto base = (int)group * GroupWidth;
+        const Group g(mCtrl + base);
+        for (auto match = g.Match(H2(hash)); match; match &= match - 1)
+        {
+            const auto slot = base + VGE::CountTrailingZeros(match);
+            if (VGE_LIKELY(E()(mEntries[slot].Key, key)))
+                return slot;
+        }
+
+        // The key would have been placed in the first group with room for it.
+        if (g.MatchEmpty())
+            return -1;
+
+        group = (group + step) & group_mask;
+    }
+}
+
+template<class K, class V, class H, class E>
+int
+VGE::HashMap<K, V, H, E>::FindInsertSlot(u64 hash) const
+{
+    const auto group_mask = (u64)(mCap / GroupWidth - 1);
+    auto group = H1(hash) & group_mask;
+    for (u64 step = 1; ; step++)
+    {
+        const auto base = (int)group * GroupWidth;
+        if (const auto match = Group(mCtrl + base).MatchEmptyOrDeleted())
+            return base + VGE::CountTrailingZeros(match);
+
+        group = (group + step) & group_mask;
+    }
+}
+
+template<class K, class V, class H, class E>
+std::pair<typename VGE::HashMap<K, V, H, E>::Entry*, bool>
+VGE::HashMap<K, V, H, E>::Insert(K key, V value)
+{
+    const auto hash = H()(key);
+    if (const auto slot = FindSlot(key, hash); slot >= 0)
+        return {&mEntries[slot], false};
+
+    // Keep the load, including deleted slots, below 7/8 so there is always an empty slot to end a probe.
+    if ((mSize + mDeleted + 1) * 8 > mCap * 7)
+    {
+        // When enough of the load is deleted slots they are cleaned out without growing.
+        const auto new_cap = ((mSize + 1) * 32 > mCap * 25) ? std::max(mCap * 2, GroupWidth) : mCap;
+        Rehash(new_cap);
+    }
+
+    const auto slot = FindInsertSlot(hash);
+    if (mCtrl[slot] == Deleted)
+        mDeleted--;
+
+    mCtrl[slot] = H2(hash);
+    new(&mEntries[slot])Entry{std::move(key), std::move(value)};
+    mSize++;
+
+    return {&mEntries[slot], true};
+}
+
+template<class K, class V, class H, class E>
+V&
+VGE::HashMap<K, V, H, E>::operator[](const K& key)
+{
+    if (const auto slot = FindSlot(key, H()(key)); slot >= 0)
+        return mEntries[slot].Value;
+
+    return Insert(key, V()).first->Value;
+}
+
+template<class K, class V, class H, class E>
+V*
+VGE::HashMap<K, V, H, E>::Find(const K& key)
+{
+    const auto slot = FindSlot(key, H()(key));
+    return (slot >= 0) ? &mEntries[slot].Value : nullptr;
+}
+
+template<class K, class V, class H, class E>
+const V*
+VGE::HashMap<K, V, H, E>::Find(const K& key) const
+{
+    const auto slot = FindSlot(key, H()(key));
+    return (slot >= 0) ? &mEntries[slot].Value : nullptr;
+}
+
+template<class K, class V, class H, class E>
+bool
+VGE::HashMap<K, V, H, E>::Contains(const K& key) const
+{
+    return FindSlot(key, H()(key)) >= 0;
+}
+
+template<class K, class V, class H, class E>
+bool
+VGE::HashMap<K, V, H, E>::Remove(const K& key)
+{
+    return RemoveKey(key);
+}
+
+template<class K, class V, class H, class E>
+template<class Q, class HH, class>
+V*
+VGE::HashMap<K, V, H, E>::Find(const Q& key)
+{
+    const auto slot = FindSlot(key, H()(key));
+    return (slot >= 0) ? &mEntries[slot].Value : nullptr;
+}
+
+template<class K, class V, class H, class E>
+template<class Q, class HH, class>
+const V*
+VGE::HashMap<K, V, H, E>::Find(const Q& key) const
+{
+    const auto slot = FindSlot(key, H()(key));
+    return (slot >= 0) ? &mEntries[slot].Value : nullptr;
+}
+
+template<class K, class V, class H, class E>
+template<class Q, class HH, class>
+bool
+VGE::HashMap<K, V, H, E>::Contains(const Q& key) const
+{
+    return FindSlot(key, H()(key)) >= 0;
+}
+
+template<class K, class V, class H, class E>
+template<class Q, class HH, class>
+bool
+VGE::HashMap<K, V, H, E>::Remove(const Q& key)
+{
+    return RemoveKey(key);
+}
+
+template<class K, class V, class H, class E>
+template<class Q>
+bool
+VGE::HashMap<K, V, H, E>::RemoveKey(const Q& key)
+{
+    const auto slot = FindSlot(key, H()(key));
+    if (slot < 0)
+        return false;
+
+    EraseSlot(slot);
+    return true;
+}
+
+template<class K, class V, class H, class E>
+void
+VGE::HashMap<K, V, H, E>::EraseSlot(int slot)
+{
+    mEntries[slot].~Entry();
+    mSize--;
+
+    // A probe only continues past a group without empty slots, so if this group has one,
+    // no probe can pass through it and the slot can be empty rather than deleted.
+    const auto base = slot & ~(GroupWidth - 1);
+    if (Group(mCtrl + base).MatchEmpty())
+    {
+        mCtrl[slot] = Empty;
+    }
+    else
+    {
+        mCtrl[slot] = Deleted;
+        mDeleted++;
+    }
+}
+
+template<class K, class V, class H, class E>
+void
+VGE::HashMap<K, V, H, E>::Clear()
+{
+    DestroyEntries();
+    if (mCap)
+        std::memset(mCtrl, Empty, mCap);
+
+    mSize = 0;
+    mDeleted = 0;
+}
+
+template<class K, class V, class H, class E>
+void
+VGE::HashMap<K, V, H, E>::Reserve(int count)
+{
+    auto new_cap = GroupWidth;
+    while (count * 8 > new_cap * 7)
+        new_cap *= 2;
+
+    if (new_cap > mCap)
+        Rehash(new_cap);
+}
+
+template<class K, class V, class H, class E>
+int
+VGE::HashMap<K, V, H, E>::Size() const
+{
+    return mSize;
+}
+
+template<class K, class V, class H, class E>
+int
+VGE::HashMap<K, V, H, E>::Capacity() const
+{
+    return mCap;
+}
+
+template<class K, class V, class H, class E> typename
+VGE::HashMap<K, V, H, E>::Iterator
+VGE::HashMap<K, V, H, E>::Begin()
+{
+    return {mCtrl, mCtrl + mCap, mEntries};
+}
+
+template<class K, class V, class H, class E> typename
+VGE::HashMap<K, V, H, E>::Iterator
+VGE::HashMap<K, V, H, E>::End()
+{
+    return {mCtrl + mCap, mCtrl + mCap, mEntries + mCap};
+}
+
+template<class K, class V, class H, class E> typename
+VGE::HashMap<K, V, H, E>::Iterator
+VGE::HashMap<K, V, H, E>::begin()
+{
+    return Begin();
+}
+
+template<class K, class V, class H, class E> typename
+VGE::HashMap<K, V, H, E>::Iterator
+VGE::HashMap<K, V, H, E>::end()
+{
+    return End();
+}
+
+template<class K, class V, class H, class E>
+void
+VGE::HashMap<K, V, H, E>::Rehash(int new_cap)
+{
+    VGE_ASSERT(new_cap >= GroupWidth && (new_cap & (new_cap - 1)) == 0, "Hash map capacity must be a power of two of at least %d, got: %d", GroupWidth, new_cap);
+
+    // The control bytes come first, followed by the entries.
+    constexpr i64 alignment = std::max<i64>(GroupWidth, alignof(Entry));
+    const auto entries_offset = ((i64)new_cap + alignment - 1) & ~(alignment - 1);
+    const auto memory = (char*)mAllocator->Allocate(entries_offset + new_cap * (i64)sizeof(Entry), alignment);
+    VGE_ASSERT(IsAligned(memory, alignment), "Allocator returned memory that is not aligned to %d", (int)alignment);
+
+    const auto old_memory = mMemory;
+    const auto old_ctrl = mCtrl;
+    const auto old_entries = mEntries;
+    const auto old_cap = mCap;
+
+    mMemory = memory;
+    mCtrl = (i8*)memory;
+    mEntries = (Entry*)(memory + entries_offset);
+    mCap = new_cap;
+    mDeleted = 0;
+    std::memset(mCtrl, Empty, new_cap);
+
+    for (int i = 0; i < old_cap; i++)
+    {
+        if (old_ctrl[i] < 0)
+            continue;
+
+        const auto hash = H()(old_entries[i].Key);
+        const auto slot = FindInsertSlot(hash);
+        mCtrl[slot] = H2(hash);
+        new(&mEntries[slot])Entry(std::move(old_entries[i]));
+        old_entries[i].~Entry();
+    }
+
+    if (old_memory)
+        mAllocator->Deallocate(old_memory);
+}
+
+template<class K, class V, class H, class E>
+void
+VGE::HashMap<K, V, H, E>::DestroyEntries()
+{
+    if constexpr (!std::is_trivially_destructible_v<Entry>)
+    {
+        for (int i = 0; i < mCap; i++)
+        {
+            if (mCtrl[i] >= 0)
+                mEntries[i].~Entry();
+        }
+    }
+}
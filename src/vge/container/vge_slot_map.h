@@ -1,11 +1,14 @@
 #pragma once
+#include <type_traits>
 #include <vge_assert.h>
 #include <vge_allocator.h>
 
 // Implementation inspired by: https://www.youtube.com/watch?v=SHaAR7XPtNU
 namespace VGE
 {
-    // Want tests for this thing!, particularly to test that it actually only allocates new elements when it needs to
+    // Densely packed storage with stable, generational handles.
+    // Insert, Remove and lookup through a handle are O(1), and the elements can be iterated
+    // as a contiguous array through Data() and Size(), but their order changes on Remove.
     template<class T>
     class SlotMap
     {
@@ -17,13 +20,24 @@ namespace VGE
         };
 
         SlotMap(VGE::Allocator& allocator = *(GetDefaultAllocator()));
+        ~SlotMap();
+
+        SlotMap(const SlotMap&) = delete;
+        SlotMap& operator=(const SlotMap&) = delete;
 
         Handle
         Insert(const T& item);
 
+        Handle
+        Insert(T&& item);
+
         void
         Remove(const Handle& handle);
 
+        // Removes every element, all handles handed out are invalidated.
+        void
+        Clear();
+
         T*
         operator[](const Handle& handle);
 
@@ -42,35 +56,41 @@ namespace VGE
         int
         Capacity() const;
 
+        // Handles stay valid, only the elements are moved.
+        void
+        Reserve(int new_cap);
+
         T* Data();
+        const T* Data() const;
+
+        T* Begin();
+        T* End();
+        const T* Begin() const;
+        const T* End() const;
 
     private:
+        template<class U>
+        Handle Emplace(U&& item);
+
         void Reallocate(int new_size);
 
-        // Move over to using raw memory here.
         VGE::Allocator* mAllocator;
+
+        // The handle effectively works 2 ways,
+        // the index in the handle we get from the user is used to index into the mHandles array,
+        // while the index of a handle within the mHandles array is the index into the mData array.
+        // For free slots the index instead links to the next slot on the free-list.
         Handle* mHandles;
         T* mData;
-        int* mErase; // TODO: Find better name, an object located at the same place as a piece of data in mData here, holds the index to the corresponding handle in mHandles
+        int* mErase; // Located at the same index as its element in mData, holds the index of the corresponding slot in mHandles
         int mSize;
         int mCap;
 
-        //VGE::Array<Handle> mHandles;
-        //VGE::Array<T> mData;
-        //VGE::Array<int> mErase; // To map from mData back to mHandles
-
+        // There are as many slots as elements, so the free-list is empty when the map is full.
+        // The tail links to itself, and slots are pushed on the tail to delay reusing them.
         int mFreeListHead;
         int mFreeListTail;
-
-        // Add FreeList
-        // The handle effectivly works 2 ways,
-        // the index in the handle we get from the user is used to index into the mHandles array
-        // the index existing within the handles within mHandles table is a handle into the mData array
-
-
-
     };
 }
 
 #include <vge_slot_map.tpp>
-
@@ -3,36 +3,62 @@
 template<class T>
 VGE::SlotMap<T>::SlotMap(VGE::Allocator& allocator)
     : mAllocator(&allocator)
-    , mHandles((Handle*)allocator.Allocate(2 * sizeof(Handle)))
-    , mData((T*)allocator.Allocate(2 * sizeof(T)))
-    , mErase((int*)allocator.Allocate(2 * sizeof(int)))
+    , mHandles((Handle*)allocator.Allocate(2 * sizeof(Handle), alignof(Handle)))
+    , mData((T*)allocator.Allocate(2 * sizeof(T), alignof(T)))
+    , mErase((int*)allocator.Allocate(2 * sizeof(int), alignof(int)))
     , mSize(0)
     , mCap(2)
     , mFreeListHead(0)
     , mFreeListTail(1)
 {
+    VGE_ASSERT(IsAligned(mData, alignof(T)), "Allocator returned memory that is not aligned to %d", (int)alignof(T));
+
     mHandles[mFreeListHead].idx = mFreeListTail;
     mHandles[mFreeListHead].gen = 0;
     mHandles[mFreeListTail].idx = mFreeListTail;
     mHandles[mFreeListTail].gen = 0;
 }
 
+template<class T>
+VGE::SlotMap<T>::~SlotMap()
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+        for (int i = 0; i < mSize; i++)
+            mData[i].~T();
+
+    mAllocator->Deallocate(mHandles);
+    mAllocator->Deallocate(mErase);
+    mAllocator->Deallocate(mData);
+}
+
 template<class T> typename
 VGE::SlotMap<T>::Handle
 VGE::SlotMap<T>::Insert(const T& item)
+{
+    return Emplace(item);
+}
+
+template<class T> typename
+VGE::SlotMap<T>::Handle
+VGE::SlotMap<T>::Insert(T&& item)
+{
+    return Emplace(std::move(item));
+}
+
+template<class T>
+template<class U> typename
+VGE::SlotMap<T>::Handle
+VGE::SlotMap<T>::Emplace(U&& item)
 {
     if (mSize == mCap)
-    {
         Reallocate(mCap * 2);
-        // Need to re-assign mFreeListHead in this case, as it probably is the same as mFreeListTail at this point!
-    }
 
     // Allocate
     const auto slot_idx = mFreeListHead;
-    new(&mData[mSize])T(item);
+    new(&mData[mSize])T(std::forward<U>(item));
     mErase[mSize] = slot_idx;
 
-    // Pop off free-list
+    // Pop off free-list, the tail links to itself.
     const auto new_head = mHandles[mFreeListHead].idx;
     mFreeListHead = new_head;
     mHandles[slot_idx].idx = mSize++;
@@ -44,26 +70,60 @@ template<class T>
 void
 VGE::SlotMap<T>::Remove(const Handle& handle)
 {
+    VGE_ASSERT(handle.idx >= 0 && handle.idx < mCap, "Trying to remove element with invalid handle: %d", handle.idx);
     VGE_ASSERT(mHandles[handle.idx].gen == handle.gen, "Trying to doubly free element: %d", handle.idx);
 
     mHandles[handle.idx].gen++;
-    auto idx = mHandles[handle.idx].idx;
+    const auto idx = mHandles[handle.idx].idx;
+    const auto last = mSize - 1;
 
+    // Keep the data dense by moving the last element into the hole.
+    if (idx != last)
+    {
+        mData[idx] = std::move(mData[last]);
+        mErase[idx] = mErase[last];
+        mHandles[mErase[idx]].idx = idx;
+    }
 
-    // TODO: Fix this if T is trivial.
-    mData[idx].~T();
-    new(&mData[idx])T(std::move(mData[mSize - 1]));
-    mErase[idx] = mErase[mSize - 1];
+    if constexpr (!std::is_trivially_destructible_v<T>)
+        mData[last].~T();
+
+    // Push onto the back of the free-list, so the same slot is not reused right away.
+    if (mSize == mCap)
+        mFreeListHead = handle.idx;
+    else
+        mHandles[mFreeListTail].idx = handle.idx;
 
-    // TODO: Update tail etc here.
+    mHandles[handle.idx].idx = handle.idx;
+    mFreeListTail = handle.idx;
     mSize--;
 }
 
+template<class T>
+void
+VGE::SlotMap<T>::Clear()
+{
+    for (int i = 0; i < mSize; i++)
+    {
+        mHandles[mErase[i]].gen++;
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            mData[i].~T();
+    }
+
+    for (int i = 0; i < mCap; i++)
+        mHandles[i].idx = i + 1;
+    mHandles[mCap - 1].idx = mCap - 1;
+
+    mFreeListHead = 0;
+    mFreeListTail = mCap - 1;
+    mSize = 0;
+}
+
 template<class T>
 T*
 VGE::SlotMap<T>::operator[](const Handle& handle)
 {
-    if (mHandles[handle.idx].gen != handle.gen)
+    if (handle.idx < 0 || handle.idx >= mCap || mHandles[handle.idx].gen != handle.gen)
         return nullptr;
 
     return &mData[mHandles[handle.idx].idx];
@@ -73,7 +133,7 @@ template<class T>
 const T*
 VGE::SlotMap<T>::operator[](const Handle& handle) const
 {
-    if (mHandles[handle.idx].gen != handle.gen)
+    if (handle.idx < 0 || handle.idx >= mCap || mHandles[handle.idx].gen != handle.gen)
         return nullptr;
 
     return &mData[mHandles[handle.idx].idx];
@@ -83,6 +143,7 @@ template<class T>
 T&
 VGE::SlotMap<T>::operator[](int idx)
 {
+    VGE_ASSERT(idx >= 0 && idx < mSize, "idx: %d is not in valid range: [0, %d)", idx, mSize);
     return mData[idx];
 }
 
@@ -90,6 +151,7 @@ template<class T>
 const T&
 VGE::SlotMap<T>::operator[](int idx) const
 {
+    VGE_ASSERT(idx >= 0 && idx < mSize, "idx: %d is not in valid range: [0, %d)", idx, mSize);
     return mData[idx];
 }
 
@@ -107,29 +169,105 @@ VGE::SlotMap<T>::Capacity() const
     return mCap;
 }
 
+template<class T>
+void
+VGE::SlotMap<T>::Reserve(int new_cap)
+{
+    // we already have more capacity than the suggested new
+    if (new_cap <= mCap)
+        return;
+
+    Reallocate(new_cap);
+}
+
+template<class T>
+T*
+VGE::SlotMap<T>::Data()
+{
+    return mData;
+}
+
+template<class T>
+const T*
+VGE::SlotMap<T>::Data() const
+{
+    return mData;
+}
+
+template<class T>
+T*
+VGE::SlotMap<T>::Begin()
+{
+    return mData;
+}
+
+template<class T>
+T*
+VGE::SlotMap<T>::End()
+{
+    return mData + mSize;
+}
+
+template<class T>
+const T*
+VGE::SlotMap<T>::Begin() const
+{
+    return mData;
+}
+
+template<class T>
+const T*
+VGE::SlotMap<T>::End() const
+{
+    return mData + mSize;
+}
+
 template<class T>
 void
 VGE::SlotMap<T>::Reallocate(int new_size)
 {
-    auto new_handles = (Handle*)mAllocator->Allocate(new_size * sizeof(Handle));
-    auto new_data = (T*)mAllocator->Allocate(new_size * sizeof(T));
-    auto new_erase = (int*)mAllocator->Allocate(new_size * sizeof(int));
+    auto new_handles = (Handle*)mAllocator->Allocate(new_size * sizeof(Handle), alignof(Handle));
+    auto new_data = (T*)mAllocator->Allocate(new_size * sizeof(T), alignof(T));
+    auto new_erase = (int*)mAllocator->Allocate(new_size * sizeof(int), alignof(int));
+    VGE_ASSERT(IsAligned(new_data, alignof(T)), "Allocator returned memory that is not aligned to %d", (int)alignof(T));
 
     std::memcpy(new_handles, mHandles, mCap * sizeof(Handle));
     std::memcpy(new_erase, mErase, mCap * sizeof(int));
 
-    // TODO: Deal with trivial classes
-    std::memcpy(new_data, mData, mSize * sizeof(T));
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        std::memcpy(new_data, mData, mSize * sizeof(T));
+    }
+    else
+    {
+        for (int i = 0; i < mSize; i++)
+        {
+            new(&new_data[i])T(std::move(mData[i]));
+            mData[i].~T();
+        }
+    }
 
     mAllocator->Deallocate(mHandles);
     mAllocator->Deallocate(mErase);
-
-    // TODO: Deal with trivial classes
     mAllocator->Deallocate(mData);
 
     mHandles = new_handles;
     mErase = new_erase;
     mData = new_data;
 
+    // Link the new slots onto the back of the free-list.
+    for (int i = mCap; i < new_size; i++)
+    {
+        mHandles[i].idx = i + 1;
+        mHandles[i].gen = 0;
+    }
+    mHandles[new_size - 1].idx = new_size - 1;
+
+    if (mSize == mCap)
+        mFreeListHead = mCap;
+    else
+        mHandles[mFreeListTail].idx = mCap;
+
+    mFreeListTail = new_size - 1;
     mCap = new_size;
 }
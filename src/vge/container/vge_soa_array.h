@@ -0,0 +1,119 @@
+#pragma once
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vge_allocator.h>
+#include <vge_span.h>
+
+namespace VGE
+{
+    // Walks several columns in lockstep, dereferences to a tuple of references,
+    // so it works with structured bindings: for (auto [position, normal] : array.Zip<0, 2>())
+    template<class... Ts>
+    class ZipIterator
+    {
+    public:
+        ZipIterator(std::tuple<Ts*...> pointers);
+
+        std::tuple<Ts&...> operator*() const;
+        ZipIterator& operator++();
+
+        bool operator==(const ZipIterator& other) const;
+        bool operator!=(const ZipIterator& other) const;
+
+    private:
+        std::tuple<Ts*...> mPointers;
+    };
+
+    template<class... Ts>
+    class ZipRange
+    {
+    public:
+        ZipRange(ZipIterator<Ts...> begin, ZipIterator<Ts...> end);
+
+        ZipIterator<Ts...> Begin() const;
+        ZipIterator<Ts...> End() const;
+
+        // For range based for loops.
+        ZipIterator<Ts...> begin() const;
+        ZipIterator<Ts...> end() const;
+
+    private:
+        ZipIterator<Ts...> mBegin;
+        ZipIterator<Ts...> mEnd;
+    };
+
+    // Dynamically resizable structure of arrays, one column pr type.
+    // All columns live in a single allocation and grow together, each starting on a cache line,
+    // so a loop only touching a few of the fields only streams those columns.
+    template<class... Ts>
+    class SoAArray
+    {
+    public:
+        static_assert(sizeof...(Ts) > 0, "SoAArray needs at least one column");
+
+        static constexpr auto ColumnAlignment = 64;
+        static constexpr auto ColumnCount = (int)sizeof...(Ts);
+
+        template<int I>
+        using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+        SoAArray(Allocator& allocator = *GetDefaultAllocator());
+        SoAArray(SoAArray&&);
+        SoAArray& operator=(SoAArray&&);
+        SoAArray(const SoAArray& other) = delete;
+        SoAArray& operator=(const SoAArray& other) = delete;
+        ~SoAArray();
+
+        void PushBack(const Ts&... items);
+        void Clear();
+
+        std::tuple<Ts&...> operator[](int idx);
+        std::tuple<const Ts&...> operator[](int idx) const;
+
+        template<int I>
+        Span<ColumnType<I>> Column();
+
+        template<int I>
+        Span<const ColumnType<I>> Column() const;
+
+        // Iterates a subset of the columns.
+        template<int... Is>
+        ZipRange<ColumnType<Is>...> Zip();
+
+        template<int... Is>
+        ZipRange<const ColumnType<Is>...> Zip() const;
+
+        ZipIterator<Ts...> Begin();
+        ZipIterator<Ts...> End();
+        ZipIterator<const Ts...> Begin() const;
+        ZipIterator<const Ts...> End() const;
+
+        // For range based for loops.
+        ZipIterator<Ts...> begin();
+        ZipIterator<Ts...> end();
+        ZipIterator<const Ts...> begin() const;
+        ZipIterator<const Ts...> end() const;
+
+        void Resize(int new_size);
+        int Size() const;
+
+        void Reserve(int new_cap);
+        int Capacity() const;
+
+    private:
+        template<size_t... Is>
+        void Reallocate(int new_cap, std::index_sequence<Is...>);
+
+        template<size_t... Is>
+        void Destroy(int begin, int end, std::index_sequence<Is...>);
+
+        Allocator* mAllocator{};
+        void* mMemory{};
+        std::tuple<Ts*...> mColumns{};
+        int mSize{};
+        int mCap{};
+    };
+}
+
+#include <vge_soa_array.tpp>
@@ -0,0 +1,365 @@
+#include <vge_assert.h>
+#include <cstring>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////
+/// Zip iterator
+///////////////////////////////////////////////////////////
+template<class... Ts>
+VGE::ZipIterator<Ts...>::ZipIterator(std::tuple<Ts*...> pointers)
+    : mPointers(pointers)
+{
+}
+
+template<class... Ts>
+std::tuple<Ts&...>
+VGE::ZipIterator<Ts...>::operator*() const
+{
+    return std::apply([](auto*... pointers) { return std::tuple<Ts&...>(*pointers...); }, mPointers);
+}
+
+template<class... Ts>
+VGE::ZipIterator<Ts...>&
+VGE::ZipIterator<Ts...>::operator++()
+{
+    std::apply([](auto*&... pointers) { (++pointers, ...); }, mPointers);
+    return *this;
+}
+
+template<class... Ts>
+bool
+VGE::ZipIterator<Ts...>::operator==(const ZipIterator& other) const
+{
+    // All columns move in lockstep, so the first one decides.
+    return std::get<0>(mPointers) == std::get<0>(other.mPointers);
+}
+
+template<class... Ts>
+bool
+VGE::ZipIterator<Ts...>::operator!=(const ZipIterator& other) const
+{
+    return !(*this == other);
+}
+
+template<class... Ts>
+VGE::ZipRange<Ts...>::ZipRange(ZipIterator<Ts...> begin, ZipIterator<Ts...> end)
+    : mBegin(begin)
+    , mEnd(end)
+{
+}
+
+template<class... Ts>
+VGE::ZipIterator<Ts...>
+VGE::ZipRange<Ts...>::Begin() const
+{
+    return mBegin;
+}
+
+template<class... Ts>
+VGE::ZipIterator<Ts...>
+VGE::ZipRange<Ts...>::End() const
+{
+    return mEnd;
+}
+
+template<class... Ts>
+VGE::ZipIterator<Ts...>
+VGE::ZipRange<Ts...>::begin() const
+{
+    return mBegin;
+}
+
+template<class... Ts>
+VGE::ZipIterator<Ts...>
+VGE::ZipRange<Ts...>::end() const
+{
+    return mEnd;
+}
+
+///////////////////////////////////////////////////////////
+/// SoAArray
+///////////////////////////////////////////////////////////
+template<class... Ts>
+VGE::SoAArray<Ts...>::SoAArray(Allocator& allocator)
+    : mAllocator(&allocator)
+{
+}
+
+template<class... Ts>
+VGE::SoAArray<Ts...>::SoAArray(SoAArray&& other)
+    : mAllocator(other.mAllocator)
+    , mMemory(other.mMemory)
+    , mColumns(other.mColumns)
+    , mSize(other.mSize)
+    , mCap(other.mCap)
+{
+    other.mMemory = nullptr;
+    other.mColumns = {};
+    other.mSize = 0;
+    other.mCap = 0;
+}
+
+template<class... Ts>
+VGE::SoAArray<Ts...>&
+VGE::SoAArray<Ts...>::operator=(SoAArray&& other)
+{
+    if (this != &other)
+    {
+        Clear();
+        mAllocator->Deallocate(mMemory);
+        mAllocator = other.mAllocator;
+        mMemory = other.mMemory;
+        mColumns = other.mColumns;
+        mSize = other.mSize;
+        mCap = other.mCap;
+
+        other.mMemory = nullptr;
+        other.mColumns = {};
+        other.mSize = 0;
+        other.mCap = 0;
+    }
+
+    return *this;
+}
+
+template<class... Ts>
+VGE::SoAArray<Ts...>::~SoAArray()
+{
+    Clear();
+    if (mMemory)
+        mAllocator->Deallocate(mMemory);
+}
+
+template<class... Ts>
+void
+VGE::SoAArray<Ts...>::PushBack(const Ts&... items)
+{
+    // If we need to grow
+    if (mSize == mCap)
+        Reserve(std::max(mCap * 2, 8));
+
+    std::apply([&](auto*... columns) { (new(&columns[mSize])Ts(items), ...); }, mColumns);
+    mSize++;
+}
+
+template<class... Ts>
+void
+VGE::SoAArray<Ts...>::Clear()
+{
+    Destroy(0, mSize, std::index_sequence_for<Ts...>());
+    mSize = 0;
+}
+
+template<class... Ts>
+std::tuple<Ts&...>
+VGE::SoAArray<Ts...>::operator[](int idx)
+{
+    VGE_ASSERT(idx >= 0 && idx < Size(), "idx: %d is not in valid range: [0, %d)", idx, Size());
+    return std::apply([=](auto*... columns) { return std::tuple<Ts&...>(columns[idx]...); }, mColumns);
+}
+
+template<class... Ts>
+std::tuple<const Ts&...>
+VGE::SoAArray<Ts...>::operator[](int idx) const
+{
+    VGE_ASSERT(idx >= 0 && idx < Size(), "idx: %d is not in valid range: [0, %d)", idx, Size());
+    return std::apply([=](auto*... columns) { return std::tuple<const Ts&...>(columns[idx]...); }, mColumns);
+}
+
+template<class... Ts>
+template<int I>
+VGE::Span<typename VGE::SoAArray<Ts...>::template ColumnType<I>>
+VGE::SoAArray<Ts...>::Column()
+{
+    return {std::get<I>(mColumns), mSize};
+}
+
+template<class... Ts>
+template<int I>
+VGE::Span<const typename VGE::SoAArray<Ts...>::template ColumnType<I>>
+VGE::SoAArray<Ts...>::Column() const
+{
+    return {std::get<I>(mColumns), mSize};
+}
+
+template<class... Ts>
+template<int... Is>
+VGE::ZipRange<typename VGE::SoAArray<Ts...>::template ColumnType<Is>...>
+VGE::SoAArray<Ts...>::Zip()
+{
+    return {std::tuple(std::get<Is>(mColumns)...), std::tuple((std::get<Is>(mColumns) + mSize)...)};
+}
+
+template<class... Ts>
+template<int... Is>
+VGE::ZipRange<const typename VGE::SoAArray<Ts...>::template ColumnType<Is>...>
+VGE::SoAArray<Ts...>::Zip() const
+{
+    using Pointers = std::tuple<const ColumnType<Is>*...>;
+    return {Pointers(std::get<Is>(mColumns)...), Pointers((std::get<Is>(mColumns) + mSize)...)};
+}
+
+template<class... Ts>
+VGE::ZipIterator<Ts...>
+VGE::SoAArray<Ts...>::Begin()
+{
+    return mColumns;
+}
+
+template<class... Ts>
+VGE::ZipIterator<Ts...>
+VGE::SoAArray<Ts...>::End()
+{
+    return std::apply([=](auto*... columns) { return std::tuple<Ts*...>((columns + mSize)...); }, mColumns);
+}
+
+template<class... Ts>
+VGE::ZipIterator<const Ts...>
+VGE::SoAArray<Ts...>::Begin() const
+{
+    return std::tuple<const Ts*...>(mColumns);
+}
+
+template<class... Ts>
+VGE::ZipIterator<const Ts...>
+VGE::SoAArray<Ts...>::End() const
+{
+    return std::apply([=](auto*... columns) { return std::tuple<const Ts*...>((columns + mSize)...); }, mColumns);
+}
+
+template<class... Ts>
+VGE::ZipIterator<Ts...>
+VGE::SoAArray<Ts...>::begin()
+{
+    return Begin();
+}
+
+template<class... Ts>
+VGE::ZipIterator<Ts...>
+VGE::SoAArray<Ts...>::end()
+{
+    return End();
+}
+
+template<class... Ts>
+VGE::ZipIterator<const Ts...>
+VGE::SoAArray<Ts...>::begin() const
+{
+    return Begin();
+}
+
+template<class... Ts>
+VGE::ZipIterator<const Ts...>
+VGE::SoAArray<Ts...>::end() const
+{
+    return End();
+}
+
+template<class... Ts>
+void
+VGE::SoAArray<Ts...>::Resize(int new_size)
+{
+    if (new_size > mCap)
+        Reserve(new_size);
+
+    if (new_size < mSize)
+        Destroy(new_size, mSize, std::index_sequence_for<Ts...>());
+
+    std::apply([=](auto*... columns)
+    {
+        const auto construct = [=](auto* column)
+        {
+            using T = std::remove_pointer_t<decltype(column)>;
+            if constexpr (!std::is_trivial_v<T>)
+                for (int i = mSize; i < new_size; i++)
+                    new(&column[i])T();
+        };
+        (construct(columns), ...);
+    }, mColumns);
+
+    mSize = new_size;
+}
+
+template<class... Ts>
+int
+VGE::SoAArray<Ts...>::Size() const
+{
+    return mSize;
+}
+
+template<class... Ts>
+void
+VGE::SoAArray<Ts...>::Reserve(int new_cap)
+{
+    // we already have more capacity than the suggested new
+    if (new_cap <= mCap)
+        return;
+
+    Reallocate(new_cap, std::index_sequence_for<Ts...>());
+}
+
+template<class... Ts>
+int
+VGE::SoAArray<Ts...>::Capacity() const
+{
+    return mCap;
+}
+
+template<class... Ts>
+template<size_t... Is>
+void
+VGE::SoAArray<Ts...>::Reallocate(int new_cap, std::index_sequence<Is...>)
+{
+    constexpr i64 alignment = std::max({(i64)ColumnAlignment, (i64)alignof(Ts)...});
+    const auto column_size = [=](i64 size) { return (size + alignment - 1) & ~(alignment - 1); };
+
+    const auto total = (column_size(new_cap * (i64)sizeof(Ts)) + ...);
+    const auto memory = (char*)mAllocator->Allocate(total, alignment);
+    VGE_ASSERT(IsAligned(memory, alignment), "Allocator returned memory that is not aligned to %d", (int)alignment);
+
+    // Columns are laid out back to back in the order of the types.
+    std::tuple<Ts*...> columns;
+    i64 offset = 0;
+    ((std::get<Is>(columns) = (Ts*)(memory + offset), offset += column_size(new_cap * (i64)sizeof(Ts))), ...);
+
+    const auto relocate = [this](auto* from, auto* to)
+    {
+        using T = std::remove_pointer_t<decltype(from)>;
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (mSize)
+                std::memcpy(to, from, mSize * sizeof(T));
+        }
+        else
+        {
+            for (int i = 0; i != mSize; i++)
+            {
+                new(&to[i])T(std::move(from[i]));
+                from[i].~T();
+            }
+        }
+    };
+    (relocate(std::get<Is>(mColumns), std::get<Is>(columns)), ...);
+
+    if (mMemory)
+        mAllocator->Deallocate(mMemory);
+
+    mMemory = memory;
+    mColumns = columns;
+    mCap = new_cap;
+}
+
+template<class... Ts>
+template<size_t... Is>
+void
+VGE::SoAArray<Ts...>::Destroy(int begin, int end, std::index_sequence<Is...>)
+{
+    const auto destroy = [=](auto* column)
+    {
+        using T = std::remove_pointer_t<decltype(column)>;
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            for (int i = begin; i != end; i++)
+                column[i].~T();
+    };
+    (destroy(std::get<Is>(mColumns)), ...);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <vge_assert.h>
+
+namespace VGE
+{
+    // Non owning view of a contiguous range of elements.
+    template<class T>
+    class Span
+    {
+    public:
+        Span() = default;
+
+        Span(T* data, int size)
+            : mData(data)
+            , mSize(size)
+        {
+        }
+
+        T& operator[](int idx) const
+        {
+            VGE_ASSERT(idx >= 0 && idx < mSize, "idx: %d is not in valid range: [0, %d)", idx, mSize);
+            return mData[idx];
+        }
+
+        T* Data() const { return mData; }
+        int Size() const { return mSize; }
+        bool Empty() const { return mSize == 0; }
+
+        T* Begin() const { return mData; }
+        T* End() const { return mData + mSize; }
+
+        // For range based for loops.
+        T* begin() const { return Begin(); }
+        T* end() const { return End(); }
+
+    private:
+        T* mData{};
+        int mSize{};
+    };
+}
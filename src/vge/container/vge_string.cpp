@@ -0,0 +1,319 @@
+#include <vge_string.h>
+#include <vge_assert.h>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+///////////////////////////////////////////////////////////
+/// String
+///////////////////////////////////////////////////////////
+VGE::String::String(Allocator& allocator)
+    : mAllocator(&allocator)
+    , mData(mBuffer)
+    , mSize(0)
+{
+    mBuffer[0] = '\0';
+}
+
+VGE::String::String(const char* str, Allocator& allocator)
+    : String(std::string_view(str ? str : ""), allocator)
+{
+}
+
+VGE::String::String(std::string_view str, Allocator& allocator)
+    : String(allocator)
+{
+    Append(str);
+}
+
+VGE::String::String(const String& other)
+    : String(std::string_view(other), *other.mAllocator)
+{
+}
+
+VGE::String::String(String&& other)
+    : mAllocator(other.mAllocator)
+    , mSize(other.mSize)
+{
+    if (other.IsSmall())
+    {
+        mData = mBuffer;
+        std::memcpy(mBuffer, other.mBuffer, mSize + 1);
+    }
+    else
+    {
+        mData = other.mData;
+        mCap = other.mCap;
+    }
+
+    other.mData = other.mBuffer;
+    other.mSize = 0;
+    other.mBuffer[0] = '\0';
+}
+
+VGE::String&
+VGE::String::operator=(const String& other)
+{
+    if (this != &other)
+        *this = std::string_view(other);
+
+    return *this;
+}
+
+VGE::String&
+VGE::String::operator=(String&& other)
+{
+    if (this != &other)
+    {
+        this->~String();
+        new(this)String(std::move(other));
+    }
+
+    return *this;
+}
+
+VGE::String&
+VGE::String::operator=(std::string_view str)
+{
+    // The view may point into this string.
+    if (str.data() >= mData && str.data() <= mData + mSize)
+    {
+        std::memmove(mData, str.data(), str.size());
+        mSize = (i64)str.size();
+        mData[mSize] = '\0';
+        return *this;
+    }
+
+    Clear();
+    Append(str);
+    return *this;
+}
+
+VGE::String&
+VGE::String::operator=(const char* str)
+{
+    return *this = std::string_view(str ? str : "");
+}
+
+VGE::String::~String()
+{
+    if (!IsSmall())
+        mAllocator->Deallocate(mData);
+}
+
+void
+VGE::String::Append(std::string_view str)
+{
+    const auto new_size = mSize + (i64)str.size();
+    if (new_size > Capacity())
+    {
+        // Appending a view into this string has to survive the reallocation.
+        const auto offset = str.data() - mData;
+        const auto aliased = offset >= 0 && offset <= mSize;
+        Reserve(std::max(new_size, Capacity() * 2));
+        if (aliased)
+            str = std::string_view(mData + offset, str.size());
+    }
+
+    std::memmove(mData + mSize, str.data(), str.size());
+    mSize = new_size;
+    mData[mSize] = '\0';
+}
+
+VGE::String&
+VGE::String::operator+=(std::string_view str)
+{
+    Append(str);
+    return *this;
+}
+
+void
+VGE::String::Reserve(i64 new_cap)
+{
+    // we already have more capacity than the suggested new
+    if (new_cap <= Capacity())
+        return;
+
+    auto new_data = (char*)mAllocator->Allocate(new_cap + 1, alignof(char));
+    std::memcpy(new_data, mData, mSize + 1);
+
+    if (!IsSmall())
+        mAllocator->Deallocate(mData);
+
+    mData = new_data;
+    mCap = new_cap;
+}
+
+void
+VGE::String::Clear()
+{
+    mSize = 0;
+    mData[0] = '\0';
+}
+
+char&
+VGE::String::operator[](i64 idx)
+{
+    VGE_ASSERT(idx >= 0 && idx < mSize, "idx: %lld is not in valid range: [0, %lld)", (long long)idx, (long long)mSize);
+    return mData[idx];
+}
+
+const char&
+VGE::String::operator[](i64 idx) const
+{
+    VGE_ASSERT(idx >= 0 && idx < mSize, "idx: %lld is not in valid range: [0, %lld)", (long long)idx, (long long)mSize);
+    return mData[idx];
+}
+
+char*
+VGE::String::Data()
+{
+    return mData;
+}
+
+const char*
+VGE::String::CStr() const
+{
+    return mData;
+}
+
+i64
+VGE::String::Size() const
+{
+    return mSize;
+}
+
+i64
+VGE::String::Capacity() const
+{
+    return IsSmall() ? SmallCapacity : mCap;
+}
+
+bool
+VGE::String::Empty() const
+{
+    return mSize == 0;
+}
+
+bool
+VGE::String::IsSmall() const
+{
+    return mData == mBuffer;
+}
+
+VGE::String::operator std::string_view() const
+{
+    return {mData, (size_t)mSize};
+}
+
+bool
+VGE::String::operator==(std::string_view other) const
+{
+    return std::string_view(*this) == other;
+}
+
+bool
+VGE::String::operator!=(std::string_view other) const
+{
+    return !(*this == other);
+}
+
+///////////////////////////////////////////////////////////
+/// StringID
+///////////////////////////////////////////////////////////
+namespace
+{
+    class StringTable
+    {
+    public:
+        static constexpr auto PageSize = 4096; // Ids pr page
+        static constexpr auto MaxPages = 1024;
+        static constexpr auto BlockSize = 64 * 1024; // Characters are stored in blocks that are never freed.
+
+        StringTable()
+        {
+            Intern("");
+        }
+
+        u32
+        Intern(std::string_view str)
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            if (const auto id = mIds.Find(str))
+                return *id;
+
+            VGE_ASSERT(mCount < PageSize * MaxPages, "Interned more than %d strings", PageSize * MaxPages);
+
+            const auto size = (i64)str.size() + 1;
+            if (mBlockUsed + size > mBlockSize)
+            {
+                mBlockSize = std::max<i64>(BlockSize, size);
+                mBlock = (char*)VGE::GetDefaultAllocator()->Allocate(mBlockSize, alignof(char));
+                mBlockUsed = 0;
+            }
+
+            const auto chars = mBlock + mBlockUsed;
+            std::memcpy(chars, str.data(), str.size());
+            chars[str.size()] = '\0';
+            mBlockUsed += size;
+
+            auto& page = mPages[mCount / PageSize];
+            if (!page)
+                page = (const char**)VGE::GetDefaultAllocator()->Allocate(PageSize * sizeof(const char*), alignof(const char*));
+
+            const auto id = mCount++;
+            page[id % PageSize] = chars;
+            mIds.Insert(std::string_view(chars, str.size()), id);
+
+            return id;
+        }
+
+        const char*
+        CStr(u32 id) const
+        {
+            // Pages never move, and an id is only handed out once its page is written.
+            return mPages[id / PageSize][id % PageSize];
+        }
+
+    private:
+        std::mutex mLock;
+        VGE::HashMap<std::string_view, u32> mIds;
+        const char** mPages[MaxPages]{};
+        u32 mCount{};
+
+        char* mBlock{};
+        i64 mBlockSize{};
+        i64 mBlockUsed{};
+    };
+
+    StringTable&
+    GetStringTable()
+    {
+        // Never destroyed, so ids stay valid in static destructors.
+        static auto table = new StringTable();
+        return *table;
+    }
+}
+
+VGE::StringID::StringID(std::string_view str)
+    : mId(GetStringTable().Intern(str))
+{
+}
+
+const char*
+VGE::StringID::CStr() const
+{
+    return GetStringTable().CStr(mId);
+}
+
+u32
+VGE::StringID::Value() const
+{
+    return mId;
+}
+
+bool
+VGE::StringID::Empty() const
+{
+    return mId == 0;
+}
@@ -1,13 +1,86 @@
 #pragma once
+#include <string_view>
+#include <vge_allocator.h>
+#include <vge_hash_map.h>
 
-// Look into how to do copy on write optimization
 namespace VGE
 {
+    // Owning, null terminated string.
+    // Strings of up to SmallCapacity characters are stored inline, longer ones are allocated from the allocator.
     class String
     {
     public:
-        String(const char* str);
+        static constexpr auto SmallCapacity = 15;
 
+        String(Allocator& allocator = *GetDefaultAllocator());
+        String(const char* str, Allocator& allocator = *GetDefaultAllocator());
+        String(std::string_view str, Allocator& allocator = *GetDefaultAllocator());
+        String(const String& other); // Uses the allocator of other.
+        String(String&& other);
+        String& operator=(const String& other);
+        String& operator=(String&& other);
+        String& operator=(std::string_view str);
+        String& operator=(const char* str);
+        ~String();
+
+        void Append(std::string_view str);
+        String& operator+=(std::string_view str);
+
+        void Reserve(i64 new_cap);
+        void Clear();
+
+        char& operator[](i64 idx);
+        const char& operator[](i64 idx) const;
+
+        char* Data();
+        const char* CStr() const;
+        i64 Size() const;
+        i64 Capacity() const;
+        bool Empty() const;
+        bool IsSmall() const;
+
+        operator std::string_view() const;
+        bool operator==(std::string_view other) const;
+        bool operator!=(std::string_view other) const;
+
+    private:
+        Allocator* mAllocator;
+        char* mData; // Points to mBuffer for small strings.
+        i64 mSize;
+        union
+        {
+            i64 mCap;
+            char mBuffer[SmallCapacity + 1];
+        };
+    };
+
+    // Interned string, the characters are stored once in a global table, and never freed.
+    // Comparing two ids is an integer compare, the default id is the empty string.
+    // Interning takes a lock, reading the characters of an id does not.
+    class StringID
+    {
+    public:
+        StringID() = default;
+        explicit StringID(std::string_view str);
+
+        const char* CStr() const;
+        u32 Value() const;
+        bool Empty() const;
+
+        bool operator==(StringID other) const { return mId == other.mId; }
+        bool operator!=(StringID other) const { return mId != other.mId; }
+        bool operator<(StringID other) const { return mId < other.mId; }
+
+    private:
+        u32 mId{};
     };
-}
 
+    template<> struct Hash<String> : StringHash {};
+    template<> struct Equal<String> : StringEqual {};
+
+    template<>
+    struct Hash<StringID>
+    {
+        u64 operator()(StringID id) const { return HashMix(id.Value()); }
+    };
+}
@@ -49,6 +49,23 @@
 #define VGE_NO_INLINE
 #endif
 
+///////////////////////////////////////////////////////////
+/// \ingroup vge_core
+///
+/// \brief
+///     VGE_RETURN_ADDRESS is a platform independent macro
+///     giving the address the current function returns to,
+///     used to identify call sites.
+///////////////////////////////////////////////////////////
+#if defined(__GNUC__) || defined(__clang__)
+#define VGE_RETURN_ADDRESS() __builtin_return_address(0)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define VGE_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define VGE_RETURN_ADDRESS() nullptr
+#endif
+
 ///////////////////////////////////////////////////////////
 /// \ingroup vge_core
 ///
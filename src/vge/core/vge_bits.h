@@ -0,0 +1,23 @@
+#pragma once
+#include <vge_attributes.h>
+#include <vge_types.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace VGE
+{
+    // Index of the lowest set bit, value must not be zero.
+    VGE_INLINE int
+    CountTrailingZeros(u32 value)
+    {
+        #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long idx;
+        _BitScanForward(&idx, value);
+        return (int)idx;
+        #else
+        return __builtin_ctz(value);
+        #endif
+    }
+}
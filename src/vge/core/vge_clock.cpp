@@ -0,0 +1,77 @@
+#include <vge_clock.h>
+#include <vge_attributes.h>
+
+#if VGE_CLOCK_TSC && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+u64 VGE::Clock::sBaseTicks = 0;
+u64 VGE::Clock::sScale = 0;
+bool VGE::Clock::sUseTSC = false;
+
+static bool
+has_invariant_tsc()
+{
+    #if VGE_CLOCK_TSC
+    // CPUID.80000007H:EDX[8], the counter runs at a constant rate regardless of power states.
+    unsigned regs[4]{};
+    #ifdef _MSC_VER
+    __cpuid((int*)regs, 0x80000000);
+    if (regs[0] < 0x80000007)
+        return false;
+    __cpuid((int*)regs, 0x80000007);
+    #else
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007)
+        return false;
+    __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+    #endif
+    return (regs[3] & (1 << 8)) != 0;
+    #else
+    return false;
+    #endif
+}
+
+static void
+calibrate_clock()
+{
+    using Steady = std::chrono::steady_clock;
+    VGE::Clock::sUseTSC = has_invariant_tsc();
+    if (!VGE::Clock::sUseTSC)
+    {
+        // Ticks are steady_clock ticks, so the scale is known up front.
+        VGE::Clock::sScale = (u64)((double)Steady::period::num * 1e9 / Steady::period::den * 4294967296.0);
+        VGE::Clock::sBaseTicks = VGE::Clock::Ticks();
+        return;
+    }
+
+    // Spin for a short while, long enough for the error of steady_clock to be negligible.
+    constexpr auto calibration_time = std::chrono::milliseconds(10);
+
+    const auto steady_begin = Steady::now();
+    const auto ticks_begin = VGE::Clock::Ticks();
+
+    auto steady_end = steady_begin;
+    while (steady_end - steady_begin < calibration_time)
+        steady_end = Steady::now();
+
+    const auto ticks_end = VGE::Clock::Ticks();
+
+    const auto nanoseconds = std::chrono::duration<double, std::nano>(steady_end - steady_begin).count();
+    VGE::Clock::sScale = (u64)(nanoseconds / (double)(ticks_end - ticks_begin) * 4294967296.0);
+    VGE::Clock::sBaseTicks = ticks_begin;
+}
+
+// Runs during static initialization, so the clock is usable from main.
+VGE_UNUSED static const bool sCalibrated = (calibrate_clock(), true);
+
+bool
+VGE::Clock::UsesTSC()
+{
+    return sUseTSC;
+}
+
+double
+VGE::Clock::TicksPerSecond()
+{
+    return 1e9 * 4294967296.0 / (double)sScale;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <vge_attributes.h>
+#include <vge_types.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define VGE_CLOCK_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define VGE_CLOCK_TSC 1
+#else
+#define VGE_CLOCK_TSC 0
+#endif
+
+namespace VGE
+{
+    // Cheap clock based on the time stamp counter, meant for profiling.
+    // The counter is calibrated against std::chrono::steady_clock once at startup,
+    // after which now() is just an rdtsc and a fixed point multiply.
+    // Falls back to steady_clock if the CPU lacks an invariant TSC.
+    // Usable as a regular std::chrono clock, with time points counted in nanoseconds from startup.
+    struct Clock
+    {
+        using rep = i64;
+        using period = std::nano;
+        using duration = std::chrono::duration<rep, period>;
+        using time_point = std::chrono::time_point<Clock>;
+        static constexpr bool is_steady = true;
+
+        static time_point now();
+
+        // Raw counter value, only meaningful relative to other calls of Ticks().
+        static u64 Ticks();
+        static duration TicksToDuration(u64 ticks);
+
+        static bool UsesTSC();
+        static double TicksPerSecond();
+
+        // Members
+        // Filled in by the calibration during static initialization.
+        // Anything calling now() before that happens will get the epoch.
+        static u64 sBaseTicks;
+        static u64 sScale; // Nanoseconds per tick, as 32.32 fixed point.
+        static bool sUseTSC;
+    };
+}
+
+VGE_INLINE u64
+VGE::Clock::Ticks()
+{
+    #if VGE_CLOCK_TSC
+    if (sUseTSC)
+        return __rdtsc();
+    #endif
+
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+VGE_INLINE VGE::Clock::duration
+VGE::Clock::TicksToDuration(u64 ticks)
+{
+    #if defined(__SIZEOF_INT128__)
+    return duration((rep)(((unsigned __int128)ticks * sScale) >> 32));
+    #else
+    const auto high = (ticks >> 32) * sScale;
+    const auto low = ((ticks & 0xFFFFFFFF) * sScale) >> 32;
+    return duration((rep)(high + low));
+    #endif
+}
+
+VGE_INLINE VGE::Clock::time_point
+VGE::Clock::now()
+{
+    return time_point(TicksToDuration(Ticks() - sBaseTicks));
+}
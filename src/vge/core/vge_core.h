@@ -1,4 +1,6 @@
 #pragma once
 #include <vge_attributes.h>
 #include <vge_types.h>
+#include <vge_bits.h>
+#include <vge_clock.h>
 #include <vge_thread.h>
@@ -0,0 +1,72 @@
+#include <vge_fiber.h>
+#include <vge_debug.h>
+
+#ifdef WIN32
+#include <windows.h>
+
+namespace local
+{
+    VOID WINAPI
+    fiber_entry(LPVOID function)
+    {
+        ((VGE::Fiber::Function)function)();
+    }
+}
+
+VGE::Fiber::~Fiber()
+{
+    if (mOwned)
+        DeleteFiber(mFiber);
+}
+
+void
+VGE::Fiber::Init(void* stack, int stack_size, Function function)
+{
+    VGE_ASSERT(stack && stack_size > 0, "Fiber needs a stack");
+    VGE_ASSERT(!mOwned, "Fiber is already initialized");
+
+    mFiber = CreateFiber(stack_size, &local::fiber_entry, (LPVOID)function);
+    VGE_ASSERT(mFiber, "CreateFiber failed with error %lu", GetLastError());
+    mOwned = true;
+}
+
+void
+VGE::Fiber::Switch(Fiber* from, Fiber* to)
+{
+    // We are running on from, so whatever fiber is current is its context. A thread has to become a fiber before it can switch.
+    from->mFiber = IsThreadAFiber() ? GetCurrentFiber() : ConvertThreadToFiber(nullptr);
+    VGE_ASSERT(from->mFiber, "ConvertThreadToFiber failed with error %lu", GetLastError());
+    SwitchToFiber(to->mFiber);
+}
+
+#else
+
+VGE::Fiber::~Fiber()
+{
+
+}
+
+void
+VGE::Fiber::Init(void* stack, int stack_size, Function function)
+{
+    VGE_ASSERT(stack && stack_size > 0, "Fiber needs a stack");
+
+    const auto res = getcontext(&mContext);
+    VGE_ASSERT(res == 0, "getcontext failed");
+    (void)res;
+
+    mContext.uc_stack.ss_sp = stack;
+    mContext.uc_stack.ss_size = stack_size;
+    mContext.uc_link = nullptr;
+    makecontext(&mContext, function, 0);
+}
+
+void
+VGE::Fiber::Switch(Fiber* from, Fiber* to)
+{
+    const auto res = swapcontext(&from->mContext, &to->mContext);
+    VGE_ASSERT(res == 0, "swapcontext failed");
+    (void)res;
+}
+
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+#include <vge_core.h>
+
+#ifndef WIN32
+#include <ucontext.h>
+#endif
+
+namespace VGE
+{
+    // Thin wrapper around ucontext, or the fibers of the OS on windows. A Fiber is an execution context with its own stack,
+    // which can be switched to and from on any thread.
+    // A fiber that hasn't been initialized can still be switched away from,
+    // which is how a thread stores its own context before running a fiber.
+    class Fiber
+    {
+    public:
+        using Function = void(*)();
+
+        Fiber() = default;
+        ~Fiber();
+        Fiber(const Fiber&) = delete;
+        Fiber& operator=(const Fiber&) = delete;
+
+        // The function is not allowed to return, switch back to another fiber instead.
+        // Note: Windows allocates the stack of a fiber itself, only the size is used there.
+        void Init(void* stack, int stack_size, Function function);
+
+        static void Switch(Fiber* from, Fiber* to);
+
+    private:
+        #ifdef WIN32
+        void* mFiber{}; // Created by Init, or the running thread converted to a fiber when switched away from.
+        bool mOwned{};
+        #else
+        ucontext_t mContext{};
+        #endif
+    };
+}
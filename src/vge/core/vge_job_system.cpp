@@ -0,0 +1,439 @@
+#include <vge_job_system.h>
+#include <vge_allocator.h>
+#include <vge_debug.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+/////////////////////////////////////////////////
+/// Work Stealing Queue
+/////////////////////////////////////////////////
+void
+VGE::WorkStealingQueue::Push(Job* job)
+{
+    const auto bottom = mBottom.load(std::memory_order_relaxed);
+    const auto top = mTop.load(std::memory_order_acquire);
+    VGE_ASSERT(bottom - top < Capacity, "Work stealing queue is full, %d jobs in flight", Capacity);
+
+    mJobs[bottom & Mask].store(job, std::memory_order_relaxed);
+    mBottom.store(bottom + 1, std::memory_order_release);
+}
+
+VGE::Job*
+VGE::WorkStealingQueue::Pop()
+{
+    const auto bottom = mBottom.load(std::memory_order_relaxed) - 1;
+    mBottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = mTop.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        // Queue was already empty
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto job = mJobs[bottom & Mask].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // Last item, we are racing against stealers for it.
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+VGE::Job*
+VGE::WorkStealingQueue::Steal()
+{
+    auto top = mTop.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = mBottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+        return nullptr;
+
+    auto job = mJobs[top & Mask].load(std::memory_order_relaxed);
+    if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr; // Lost the race against another stealer or the owner.
+
+    return job;
+}
+
+int
+VGE::WorkStealingQueue::Size() const
+{
+    const auto bottom = mBottom.load(std::memory_order_relaxed);
+    const auto top = mTop.load(std::memory_order_relaxed);
+    return (int)std::max<i64>(bottom - top, 0);
+}
+
+/////////////////////////////////////////////////
+/// Job System
+/////////////////////////////////////////////////
+void
+VGE::JobSystem::Init(int worker_count)
+{
+    Init(worker_count, nullptr);
+}
+
+void
+VGE::JobSystem::Init(int worker_count,
+                     Allocator* fiber_allocator,
+                     int fiber_count,
+                     int fiber_stack_size)
+{
+    VGE_ASSERT(VGE::Thread::ThisThread::ID() == 0, "Job system must be initialized from the main thread");
+    VGE_ASSERT(!mRunning.load(), "Job system is already running");
+
+    if (worker_count < 0)
+        worker_count = (int)std::thread::hardware_concurrency() - 1;
+
+    worker_count = std::clamp(worker_count, 0, VGE::Thread::MaxThreads - 1);
+
+    mWorkerCount = worker_count;
+
+    if (fiber_allocator)
+    {
+        VGE_ASSERT(fiber_count > 0 && fiber_stack_size > 0, "Invalid fiber pool, count: %d, stack size: %d", fiber_count, fiber_stack_size);
+
+        // Keep stacks 16 byte aligned, as required by the ABI.
+        fiber_stack_size = (fiber_stack_size + 15) & ~15;
+
+        mFiberAllocator = fiber_allocator;
+        mFiberCount = fiber_count;
+        mFiberStacks = (char*)mFiberAllocator->Allocate((i64)fiber_count * fiber_stack_size, 16);
+        mFibers = (JobFiber*)mFiberAllocator->Allocate(fiber_count * sizeof(JobFiber), alignof(JobFiber));
+        mFreeFibers = (JobFiber**)mFiberAllocator->Allocate(fiber_count * sizeof(JobFiber*), alignof(JobFiber*));
+        mWaitingFibers = (JobFiber**)mFiberAllocator->Allocate(fiber_count * sizeof(JobFiber*), alignof(JobFiber*));
+
+        for (int i = 0; i < fiber_count; i++)
+        {
+            auto fiber = new(&mFibers[i])JobFiber();
+            fiber->Owner = this;
+            fiber->Context.Init(mFiberStacks + (i * fiber_stack_size), fiber_stack_size, &FiberMain);
+            mFreeFibers[i] = fiber;
+        }
+
+        mFreeFiberCount = fiber_count;
+        mWaitingFiberCount = 0;
+    }
+
+    mRunning.store(true, std::memory_order_release);
+
+    for (int i = 0; i < mWorkerCount; i++)
+    {
+        const auto id = i + 1;
+        mWorkers[id].emplace(id);
+        mWorkers[id]->Start([this]()
+        {
+            while (mRunning.load(std::memory_order_acquire))
+            {
+                if (!RunOne())
+                    std::this_thread::yield();
+            }
+        });
+    }
+}
+
+void
+VGE::JobSystem::Shutdown()
+{
+    mRunning.store(false, std::memory_order_release);
+
+    for (auto& worker : mWorkers)
+    {
+        if (worker)
+        {
+            worker->Join();
+            worker.reset();
+        }
+    }
+
+    mWorkerCount = 0;
+
+    if (mFiberAllocator)
+    {
+        VGE_ASSERT(mFreeFiberCount == mFiberCount, "Shutting down with %d fibers still in use", mFiberCount - mFreeFiberCount);
+
+        for (int i = 0; i < mFiberCount; i++)
+            mFibers[i].~JobFiber();
+
+        mFiberAllocator->Deallocate(mWaitingFibers);
+        mFiberAllocator->Deallocate(mFreeFibers);
+        mFiberAllocator->Deallocate(mFibers);
+        mFiberAllocator->Deallocate(mFiberStacks);
+
+        mFiberAllocator = nullptr;
+        mFiberStacks = nullptr;
+        mFibers = nullptr;
+        mFreeFibers = nullptr;
+        mWaitingFibers = nullptr;
+        mFiberCount = 0;
+        mFreeFiberCount = 0;
+        mWaitingFiberCount = 0;
+    }
+}
+
+VGE::Job*
+VGE::JobSystem::CreateJob(JobFunction function, Job* parent)
+{
+    auto job = AllocateJob();
+    job->Function = function;
+    job->Parent = parent;
+    job->Counter = nullptr;
+    job->UnfinishedJobs.store(1, std::memory_order_relaxed);
+
+    if (parent)
+        parent->UnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+
+    return job;
+}
+
+VGE::Job*
+VGE::JobSystem::CreateJob(JobFunction function, const void* data, int size, Job* parent)
+{
+    VGE_ASSERT(size >= 0 && size <= (int)Job::DataSize, "Job data of size: %d does not fit in job (max %d)", size, (int)Job::DataSize);
+
+    auto job = CreateJob(function, parent);
+    std::memcpy(job->Data, data, size);
+    return job;
+}
+
+void
+VGE::JobSystem::Run(Job* job, JobCounter* counter)
+{
+    if (counter)
+    {
+        counter->fetch_add(1, std::memory_order_relaxed);
+        job->Counter = counter;
+    }
+
+    mQueues[VGE::Thread::ThisThread::ID()].Push(job);
+}
+
+void
+VGE::JobSystem::Wait(const Job* job)
+{
+    WaitForCounter(&job->UnfinishedJobs);
+}
+
+void
+VGE::JobSystem::WaitForCounter(const JobCounter* counter, int value)
+{
+    while (counter->load(std::memory_order_acquire) > value)
+    {
+        // Note: Always look up the state again, as we might have been resumed on another thread.
+        auto& state = mFiberStates[VGE::Thread::ThisThread::ID()];
+        if (auto fiber = (mFibers) ? state.Current : nullptr)
+        {
+            // Suspend, the scheduler puts us on the wait list once we have switched away.
+            fiber->WaitCounter = counter;
+            fiber->WaitValue = value;
+            state.Suspended = fiber;
+            Fiber::Switch(&fiber->Context, &state.Scheduler);
+        }
+        else if (!RunOne())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool
+VGE::JobSystem::RunOne()
+{
+    if (mFibers)
+        return RunOneFiber();
+
+    auto job = GetJob();
+    if (!job)
+        return false;
+
+    Execute(job);
+    return true;
+}
+
+int
+VGE::JobSystem::WorkerCount() const
+{
+    return mWorkerCount;
+}
+
+bool
+VGE::JobSystem::UsesFibers() const
+{
+    return mFibers != nullptr;
+}
+
+void
+VGE::JobSystem::Execute(Job* job)
+{
+    job->Function(job, job->Data);
+    Finish(job);
+}
+
+void
+VGE::JobSystem::Finish(Job* job)
+{
+    // Read these out before decrementing, as the job can be reused as soon as it hits 0.
+    auto parent = job->Parent;
+    auto counter = job->Counter;
+
+    if (job->UnfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        if (counter)
+            counter->fetch_sub(1, std::memory_order_release);
+
+        if (parent)
+            Finish(parent);
+    }
+}
+
+VGE::Job*
+VGE::JobSystem::AllocateJob()
+{
+    const auto thread_id = VGE::Thread::ThisThread::ID();
+    const auto idx = mAllocatedJobs[thread_id]++ & (MaxJobs - 1);
+    auto job = &mJobs[thread_id][idx];
+
+    VGE_ASSERT(job->UnfinishedJobs.load(std::memory_order_acquire) == 0, "Job pool for thread: %d wrapped around while jobs are still in flight", thread_id);
+    return job;
+}
+
+VGE::Job*
+VGE::JobSystem::GetJob()
+{
+    const auto thread_id = VGE::Thread::ThisThread::ID();
+    if (auto job = mQueues[thread_id].Pop())
+        return job;
+
+    // Nothing to do locally, try to steal from a random thread, starting the search from that thread.
+    static thread_local u32 random_state = 2463534242u + thread_id;
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+
+    // Check all threads, not just the workers, as any VGE::Thread can push jobs.
+    const auto begin = (int)(random_state % VGE::Thread::MaxThreads);
+    for (int i = 0; i < VGE::Thread::MaxThreads; i++)
+    {
+        const auto victim = (begin + i) % VGE::Thread::MaxThreads;
+        if (victim == thread_id)
+            continue;
+
+        if (auto job = mQueues[victim].Steal())
+            return job;
+    }
+
+    return nullptr;
+}
+
+/////////////////////////////////////////////////
+/// Fibers
+/////////////////////////////////////////////////
+// Lets a fiber that is started for the first time find itself, as ucontext only allows passing ints.
+static thread_local VGE::JobSystem::JobFiber* sStartingFiber = nullptr;
+
+bool
+VGE::JobSystem::RunOneFiber()
+{
+    // Prioritize fibers that are done waiting, they are holding on to a stack.
+    if (auto fiber = PopReadyFiber())
+    {
+        SwitchToFiber(fiber);
+        return true;
+    }
+
+    auto job = GetJob();
+    if (!job)
+        return false;
+
+    auto fiber = AcquireFiber();
+    if (!fiber)
+    {
+        // Every fiber is busy, put it back, we are the owner of our own queue, so this is allowed.
+        mQueues[VGE::Thread::ThisThread::ID()].Push(job);
+        return false;
+    }
+
+    fiber->RunningJob = job;
+    SwitchToFiber(fiber);
+    return true;
+}
+
+void
+VGE::JobSystem::SwitchToFiber(JobFiber* fiber)
+{
+    // We are on the scheduler, which never leaves its thread, so the state stays valid across the switch.
+    auto& state = mFiberStates[VGE::Thread::ThisThread::ID()];
+    VGE_ASSERT(!state.Current, "Trying to switch to a fiber from within a fiber");
+
+    state.Current = fiber;
+    sStartingFiber = fiber;
+    Fiber::Switch(&state.Scheduler, &fiber->Context);
+    state.Current = nullptr;
+
+    if (state.Suspended || state.Finished)
+    {
+        std::lock_guard<std::mutex> lock(mFiberLock);
+        if (state.Suspended)
+            mWaitingFibers[mWaitingFiberCount++] = state.Suspended;
+
+        if (state.Finished)
+            mFreeFibers[mFreeFiberCount++] = state.Finished;
+    }
+
+    state.Suspended = nullptr;
+    state.Finished = nullptr;
+}
+
+VGE::JobSystem::JobFiber*
+VGE::JobSystem::AcquireFiber()
+{
+    std::lock_guard<std::mutex> lock(mFiberLock);
+    return (mFreeFiberCount > 0)
+        ? mFreeFibers[--mFreeFiberCount]
+        : nullptr;
+}
+
+VGE::JobSystem::JobFiber*
+VGE::JobSystem::PopReadyFiber()
+{
+    std::lock_guard<std::mutex> lock(mFiberLock);
+    for (int i = 0; i < mWaitingFiberCount; i++)
+    {
+        auto fiber = mWaitingFibers[i];
+        if (fiber->WaitCounter->load(std::memory_order_acquire) <= fiber->WaitValue)
+        {
+            mWaitingFibers[i] = mWaitingFibers[--mWaitingFiberCount];
+            return fiber;
+        }
+    }
+
+    return nullptr;
+}
+
+void
+VGE::JobSystem::FiberMain()
+{
+    // Only entered once per fiber, the first time it is switched to.
+    // After that the fiber stays in this loop, and gets a new job every time it is switched to.
+    auto fiber = sStartingFiber;
+    auto system = fiber->Owner;
+
+    while (true)
+    {
+        system->Execute(fiber->RunningJob);
+        fiber->RunningJob = nullptr;
+
+        // We might have been suspended and resumed on another thread while running the job.
+        auto& state = system->mFiberStates[VGE::Thread::ThisThread::ID()];
+        state.Finished = fiber;
+        Fiber::Switch(&fiber->Context, &state.Scheduler);
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <vge_core.h>
+#include <vge_fiber.h>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+
+// Job system loosely based on the series by Stefan Reinalter:
+// https://blog.molecular-matters.com/2015/08/24/job-system-2-0-lock-free-work-stealing-part-1-basics/
+// Every VGE::Thread::ThreadID owns a work stealing queue and a pool of jobs,
+// so anything that keys per-thread tables on ThisThread::ID() keeps working when run inside a job.
+namespace VGE
+{
+    class Allocator;
+    struct Job;
+
+    using JobFunction = void(*)(Job* job, const void* data);
+    using JobCounter = std::atomic<int>;
+
+    struct alignas(64) Job
+    {
+        JobFunction Function{};
+        Job* Parent{};
+        JobCounter* Counter{}; // Optional, decremented when the job and all of its children are done.
+        JobCounter UnfinishedJobs{}; // Counts itself and all children that have not finished yet.
+
+        static constexpr auto DataSize = 64 - sizeof(JobFunction) - sizeof(Job*) - sizeof(JobCounter*) - sizeof(JobCounter);
+        char Data[DataSize];
+    };
+
+    static_assert(sizeof(Job) == 64, "Job should fit in exactly one cache line");
+
+    // Chase-Lev deque, see: "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al.)
+    // Push and Pop can only be called by the owning thread, Steal can be called by anyone.
+    // Fixed capacity, as the jobs themselves are also taken from a fixed pool.
+    class WorkStealingQueue
+    {
+    public:
+        static constexpr auto Capacity = 4096;
+
+        void Push(Job* job);
+        Job* Pop();
+        Job* Steal();
+
+        int Size() const;
+
+    private:
+        static constexpr auto Mask = Capacity - 1;
+        static_assert((Capacity & Mask) == 0, "Capacity must be a power of two");
+
+        alignas(64) std::atomic<i64> mTop{};
+        alignas(64) std::atomic<i64> mBottom{};
+        alignas(64) std::atomic<Job*> mJobs[Capacity]{};
+    };
+
+    struct JobSystem
+    {
+        // Starts worker_count worker threads, getting the ThreadIDs [1, worker_count].
+        // A negative count means using all hardware threads (bounded by VGE::Thread::MaxThreads).
+        void Init(int worker_count = -1);
+
+        // Fiber mode, every job runs on a fiber from a pool preallocated through the allocator.
+        // Waiting inside a job suspends the fiber instead of blocking the worker, and the suspended
+        // fiber can later be resumed by any thread, ThisThread::ID() always reports the thread it is currently on.
+        void Init(int worker_count,
+                  Allocator* fiber_allocator,
+                  int fiber_count = DefaultFiberCount,
+                  int fiber_stack_size = DefaultFiberStackSize);
+
+        void Shutdown();
+
+        // The job is taken from the pool of the calling thread, and is only valid until it has finished.
+        // If a parent is given, the parent will not be considered finished before this job is done.
+        Job* CreateJob(JobFunction function, Job* parent = nullptr);
+        Job* CreateJob(JobFunction function, const void* data, int size, Job* parent = nullptr);
+
+        // Convenience for lambdas, the lambda is copied into the Job::Data, so it needs to be small.
+        // Can either take no arguments, or the Job* it is running in (for spawning children).
+        template<class F>
+        Job* CreateJob(F function, Job* parent = nullptr);
+
+        // If a counter is supplied it will be incremented now, and decremented once the job is done.
+        void Run(Job* job, JobCounter* counter = nullptr);
+
+        // Runs other jobs while waiting, so it is safe to call from within a job.
+        void Wait(const Job* job);
+        void WaitForCounter(const JobCounter* counter, int value = 0);
+
+        // Runs at most one job, returns false if there was no work to be found.
+        bool RunOne();
+
+        int WorkerCount() const;
+        bool UsesFibers() const;
+
+        // Members
+        static constexpr auto MaxJobs = WorkStealingQueue::Capacity;
+        static constexpr auto DefaultFiberCount = 128;
+        static constexpr auto DefaultFiberStackSize = 64 * 1024;
+
+        struct JobFiber
+        {
+            Fiber Context;
+            JobSystem* Owner{};
+            VGE::Job* RunningJob{};
+            const JobCounter* WaitCounter{};
+            int WaitValue{};
+        };
+
+        // Only touched by the thread with the corresponding ThreadID.
+        struct alignas(64) FiberThreadState
+        {
+            Fiber Scheduler; // The context of the thread itself, fibers return here when they suspend or finish.
+            JobFiber* Current{};
+            JobFiber* Suspended{}; // Published to the wait list once we are back on the scheduler.
+            JobFiber* Finished{};
+        };
+
+        void Execute(Job* job);
+        void Finish(Job* job);
+        Job* AllocateJob();
+        Job* GetJob();
+
+        bool RunOneFiber();
+        void SwitchToFiber(JobFiber* fiber);
+        JobFiber* AcquireFiber();
+        JobFiber* PopReadyFiber();
+        static void FiberMain();
+
+        WorkStealingQueue mQueues[VGE::Thread::MaxThreads];
+
+        // Each thread allocates from its own ring of jobs, assuming that no thread has more than MaxJobs in flight.
+        Job mJobs[VGE::Thread::MaxThreads][MaxJobs];
+        u32 mAllocatedJobs[VGE::Thread::MaxThreads]{};
+
+        std::optional<VGE::Thread> mWorkers[VGE::Thread::MaxThreads];
+        int mWorkerCount{};
+        std::atomic<bool> mRunning{};
+
+        // Fiber mode
+        Allocator* mFiberAllocator{};
+        char* mFiberStacks{};
+        JobFiber* mFibers{};
+        int mFiberCount{};
+
+        std::mutex mFiberLock;
+        JobFiber** mFreeFibers{};
+        int mFreeFiberCount{};
+        JobFiber** mWaitingFibers{};
+        int mWaitingFiberCount{};
+
+        FiberThreadState mFiberStates[VGE::Thread::MaxThreads];
+    };
+
+    inline JobSystem gJobSystem;
+}
+
+template<class F>
+VGE::Job*
+VGE::JobSystem::CreateJob(F function, Job* parent)
+{
+    static_assert(sizeof(F) <= Job::DataSize, "Lambda captures too much to be stored inside a job");
+    static_assert(std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>, "Lambda needs to be trivially copyable, as it is never destroyed");
+
+    const auto trampoline = [](Job* job, const void* data)
+    {
+        const auto& f = *static_cast<const F*>(data);
+        if constexpr (std::is_invocable_v<const F&, Job*>)
+            f(job);
+        else
+            f();
+    };
+
+    return CreateJob(trampoline, &function, sizeof(F), parent);
+}
@@ -13,7 +13,9 @@ namespace VGE
 
         struct ThisThread
         {
-            static VGE::Thread::ThreadID ID();
+            // Never inlined, as fibers can move between threads, and the compiler is allowed
+            // to cache the address of a thread_local across calls (such as a fiber switch).
+            VGE_NO_INLINE static VGE::Thread::ThreadID ID();
         };
 
         Thread(ThreadID id);
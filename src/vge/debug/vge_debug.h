@@ -3,6 +3,7 @@
 #include <vge_imgui.h>
 #include <vge_log.h>
 #include <vge_profiler.h>
+#include <vge_trace.h>
 #include <vge_memory.h>
 #include <vge_gfx.h>
 
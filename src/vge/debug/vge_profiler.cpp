@@ -2,51 +2,371 @@
 #include <vge_profiler.h>
 #include <vge_assert.h>
 
+#include <cstdint>
+#include <cstdio>
+
 void
 VGE::Profiler::PushProfileEvent(const VGE::ProfileEvent& event)
 {
-    auto thread_id = VGE::Thread::ThisThread::ID();
-    auto& curr_count = mEventsCount[thread_id];
-    VGE_ASSERT(curr_count < MaxEvents, "Trying to push more events than there are room for!");
+    auto& events = mThreadEvents[VGE::Thread::ThisThread::ID()];
+
+    // Only the owning thread writes to the ring, so no need for anything stronger than a release.
+    const auto head = events.Head.load(std::memory_order_relaxed);
+    events.Events[head & (MaxEvents - 1)] = event;
+    events.Head.store(head + 1, std::memory_order_release);
+}
+
+void
+VGE::Profiler::SetThreadName(int thread_id, const char* name)
+{
+    VGE_ASSERT(thread_id >= 0 && thread_id < VGE::Thread::MaxThreads, "Naming thread %d, which is not a VGE ThreadID", thread_id);
+    mThreadNames[thread_id].store(name, std::memory_order_release);
+}
 
-    mEvents[thread_id][curr_count++] = event;
+const char*
+VGE::Profiler::ThreadName(int thread_id) const
+{
+    return mThreadNames[thread_id].load(std::memory_order_acquire);
 }
 
 void
 VGE::Profiler::BeginFrame()
 {
-    for (int i = 0; i < std::size(mEventsCount); i++)
-        mEventsCount[i] = 0;
-    mFrameStart = std::chrono::high_resolution_clock::now();
+    // Close the previous frame if EndFrame wasn't called.
+    if (mFrameCount > 0 && mFrames[(mFrameCount - 1) % MaxFrames].End == ProfileTimePoint())
+        EndFrame();
+
+    auto& frame = mFrames[mFrameCount % MaxFrames];
+    frame.Begin = VGE::Clock::now();
+    frame.End = ProfileTimePoint();
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+        frame.FirstEvent[t] = mThreadEvents[t].Head.load(std::memory_order_acquire);
+
+    mFrameCount++;
+}
+
+void
+VGE::Profiler::EndFrame()
+{
+    VGE_ASSERT(mFrameCount > 0, "Ending frame before any frame has begun");
+
+    auto& frame = mFrames[(mFrameCount - 1) % MaxFrames];
+    VGE_ASSERT(frame.End == ProfileTimePoint(), "Frame has already ended");
+    frame.End = VGE::Clock::now();
+
+    if (IsOverBudget(frame))
+        mOverBudgetFrames++;
+
+    UpdateCallSites(mFrameCount - 1);
+}
+
+void
+VGE::Profiler::UpdateCallSites(u64 frame_number)
+{
+    const auto slot = frame_number % MaxFrames;
+
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+    {
+        const auto head = mThreadEvents[t].Head.load(std::memory_order_acquire);
+        const auto oldest = (head > (u64)MaxEvents) ? head - MaxEvents : 0;
+
+        ProfileEvent event;
+        for (auto idx = std::max(mCallSiteCursors[t], oldest); idx < head; idx++)
+        {
+            if (!ReadEvent(t, idx, event))
+                continue;
+
+            auto site = FindCallSite(event.Function, event.Line, true);
+            if (!site)
+                continue;
+
+            if (!site->Label)
+                site->Label = event.Label;
+
+            if (site->FrameNumber[slot] != frame_number || site->Count[slot] == 0)
+            {
+                site->FrameNumber[slot] = frame_number;
+                site->Count[slot] = 0;
+                site->Total[slot] = 0;
+                site->Min[slot] = INT64_MAX;
+                site->Max[slot] = 0;
+            }
+
+            const auto duration = (event.End - event.Begin).count();
+            site->Count[slot]++;
+            site->Total[slot] += duration;
+            site->Min[slot] = std::min(site->Min[slot], duration);
+            site->Max[slot] = std::max(site->Max[slot], duration);
+
+            site->Samples[site->SampleCount % MaxSamples] = {duration, frame_number};
+            site->SampleCount++;
+        }
+
+        mCallSiteCursors[t] = head;
+    }
+
+    mStatsFrameCount = frame_number + 1;
+}
+
+VGE::Profiler::CallSite*
+VGE::Profiler::FindCallSite(const char* function, int line, bool create)
+{
+    if (!function)
+        return nullptr;
+
+    // Open addressing with linear probing, the function name has a unique address pr function.
+    auto idx = (((uintptr_t)function >> 3) ^ ((uintptr_t)line * 0x9E3779B1u)) & (MaxCallSites - 1);
+    for (int i = 0; i < MaxCallSites; i++, idx = (idx + 1) & (MaxCallSites - 1))
+    {
+        auto& site = mCallSites[idx];
+        if (site.Function == function && site.Line == line)
+            return &site;
+
+        if (!site.Function)
+        {
+            if (!create)
+                return nullptr;
+
+            site.Function = function;
+            site.Line = line;
+            mCallSiteCount++;
+            return &site;
+        }
+    }
+
+    return nullptr;
+}
+
+VGE::Profiler::CallSiteStats
+VGE::Profiler::ComputeStats(const CallSite& site, int window) const
+{
+    window = std::clamp(window, 1, MaxFrames);
+
+    const auto last = mStatsFrameCount;
+    const auto first = (last > (u64)window) ? last - window : 0;
+
+    CallSiteStats stats;
+    i64 min = INT64_MAX;
+    i64 max = 0;
+    i64 total = 0;
+
+    for (auto frame = first; frame < last; frame++)
+    {
+        const auto slot = frame % MaxFrames;
+        if (site.FrameNumber[slot] != frame || site.Count[slot] == 0)
+            continue;
+
+        stats.Count += site.Count[slot];
+        total += site.Total[slot];
+        min = std::min(min, site.Min[slot]);
+        max = std::max(max, site.Max[slot]);
+    }
+
+    if (stats.Count == 0)
+        return stats;
+
+    stats.Total = ProfileDuration(total);
+    stats.Min = ProfileDuration(min);
+    stats.Max = ProfileDuration(max);
+    stats.Mean = ProfileDuration(total / (i64)stats.Count);
+
+    i64 durations[MaxSamples];
+    int durations_count = 0;
+
+    const auto samples_count = std::min(site.SampleCount, (u64)MaxSamples);
+    for (u64 i = 0; i < samples_count; i++)
+    {
+        const auto& sample = site.Samples[i];
+        if (sample.FrameNumber >= first && sample.FrameNumber < last)
+            durations[durations_count++] = sample.Duration;
+    }
+
+    if (durations_count == 0)
+        return stats;
+
+    std::sort(durations, durations + durations_count);
+
+    // Nearest rank.
+    const auto percentile = [&](int p)
+    {
+        const auto rank = (durations_count * p + 99) / 100;
+        return ProfileDuration(durations[std::max(rank, 1) - 1]);
+    };
+
+    stats.P50 = percentile(50);
+    stats.P95 = percentile(95);
+    stats.P99 = percentile(99);
+
+    return stats;
+}
+
+bool
+VGE::Profiler::IsOverBudget(const Frame& frame) const
+{
+    const auto duration = std::chrono::duration<float, std::milli>(frame.End - frame.Begin).count();
+    return duration > mFrameBudgetMs;
+}
+
+bool
+VGE::Profiler::ReadEvent(int thread_id, u64 idx, ProfileEvent& out) const
+{
+    const auto& events = mThreadEvents[thread_id];
+    out = events.Events[idx & (MaxEvents - 1)];
+
+    // If the writer has lapped us while copying, the event might be torn.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto head = events.Head.load(std::memory_order_acquire);
+    return head <= idx + MaxEvents - 1;
+}
+
+const VGE::Profiler::Frame*
+VGE::Profiler::GetFrame(int frames_back) const
+{
+    // The current frame is still in progress, unless EndFrame has been called.
+    const auto current = (i64)mFrameCount - 1;
+    const auto has_ended = current >= 0 && mFrames[current % MaxFrames].End != ProfileTimePoint();
+    const auto idx = current - frames_back - (has_ended ? 0 : 1);
+
+    if (idx < 0 || frames_back >= MaxFrames - 1)
+        return nullptr;
+
+    return &mFrames[idx % MaxFrames];
 }
 
 void
 VGE::Profiler::DrawProfiler()
+{
+    static int frames_back = 0;
+    static int mode = 0;
+
+    // First draw all of the frame times.
+    DrawFrameTimes(frames_back);
+
+    ImGui::RadioButton("Timeline", &mode, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("Statistics", &mode, 1);
+
+    if (mode == 0)
+        DrawTimeline(frames_back);
+    else
+        DrawStatistics();
+}
+
+void
+VGE::Profiler::DrawFrameTimes(int& frames_back)
+{
+    const auto to_milli = [](const Frame& frame)
+    { return std::chrono::duration<float, std::milli>(frame.End - frame.Begin).count(); };
+
+    // Oldest frame first.
+    float frame_times[MaxFrames];
+    int frames_count = 0;
+    int over_budget_count = 0;
+    int last_over_budget = -1;
+    float max_frame_time = 0.0f;
+
+    for (int i = MaxFrames - 2; i >= 0; i--)
+    {
+        const auto frame = GetFrame(i);
+        if (!frame)
+            continue;
+
+        frame_times[frames_count++] = to_milli(*frame);
+        max_frame_time = std::max(max_frame_time, to_milli(*frame));
+
+        if (IsOverBudget(*frame))
+        {
+            over_budget_count++;
+            last_over_budget = i;
+        }
+    }
+
+    ImGui::SliderFloat("Frame budget (ms)", &mFrameBudgetMs, 1.0f, 100.0f);
+
+    char overlay[64];
+    std::sprintf(overlay, "Budget: %.2f ms", mFrameBudgetMs);
+    const auto scale_max = std::max(mFrameBudgetMs * 1.5f, max_frame_time);
+    ImGui::PlotHistogram("##frame_times", frame_times, frames_count, 0, overlay, 0.0f, scale_max, ImVec2(0.0f, 80.0f));
+
+    // Draw the budget on top of the histogram.
+    {
+        const auto plot_min = ImGui::GetItemRectMin();
+        const auto plot_max = ImGui::GetItemRectMax();
+        const auto y = plot_max.y - (plot_max.y - plot_min.y) * (mFrameBudgetMs / scale_max);
+        ImGui::GetWindowDrawList()->AddLine(ImVec2(plot_min.x, y), ImVec2(plot_max.x, y), 0xFF0000FF);
+    }
+
+    if (frames_count > 0)
+    {
+        std::sort(frame_times, frame_times + frames_count);
+        const auto percentile = [&](int p) { return frame_times[std::max((frames_count * p + 99) / 100, 1) - 1]; };
+
+        ImGui::Text("Frame time p50: %.2f ms, p95: %.2f ms, p99: %.2f ms, max: %.2f ms",
+                    percentile(50),
+                    percentile(95),
+                    percentile(99),
+                    max_frame_time);
+    }
+
+    ImGui::Text("Over budget: %d of the last %d frames (%llu in total)",
+                over_budget_count,
+                frames_count,
+                (unsigned long long)mOverBudgetFrames);
+
+    if (last_over_budget >= 0)
+    {
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Show last"))
+            frames_back = last_over_budget;
+    }
+}
+
+void
+VGE::Profiler::DrawTimeline(int& frames_back)
 {
     constexpr auto DurToMilli = [](ProfileTimePoint begin, ProfileTimePoint end)
     { return std::chrono::duration<float, std::chrono::milliseconds::period>(end - begin).count(); };
 
-    const auto frame_stop = std::chrono::high_resolution_clock::now();
+    ImGui::SliderInt("Frames back", &frames_back, 0, MaxFrames - 2);
+
+    const auto frame = GetFrame(frames_back);
+    if (!frame)
+    {
+        ImGui::Text("Frame has not been recorded");
+        return;
+    }
+
     const float window_width = ImGui::GetContentRegionAvailWidth();
 
-    const auto frame_duration = DurToMilli(mFrameStart, frame_stop);
+    const auto frame_duration = DurToMilli(frame->Begin, frame->End);
     const float milli_pr_pixel = frame_duration / window_width;
     ImGui::Text("frame_duration: %f, microsec_pr_pixel: %f", frame_duration, milli_pr_pixel);
 
-    // First draw all of the frame times.
-
-
+    if (IsOverBudget(*frame))
+        ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Frame is %.2f ms over budget", frame_duration - mFrameBudgetMs);
 
-    // Then, draw all timelines in collapsable headers.
+    // Draw all timelines in collapsable headers.
     auto list = ImGui::GetWindowDrawList();
     const auto window_x_begin = ImGui::GetCursorScreenPos().x;
 
+    // Scratch space for the events of one thread, too large for the stack.
+    static ProfileEvent events[MaxEvents];
+
     for (int t = 0; t < VGE::Thread::MaxThreads; t++)
     {
         char buffer[64];
-        std::sprintf(buffer, "ThreadID: %d", t);
+        if (const auto name = ThreadName(t))
+            std::snprintf(buffer, sizeof(buffer), "%s (ThreadID: %d)", name, t);
+        else
+            std::sprintf(buffer, "ThreadID: %d", t);
         if (ImGui::CollapsingHeader(buffer, ImGuiTreeNodeFlags_DefaultOpen))
         {
+            int events_count = 0;
+            ForEachEvent(*frame, t, [&](const ProfileEvent& event)
+            {
+                events[events_count++] = event;
+            });
+
             const auto text_height = ImGui::GetTextLineHeightWithSpacing();
             // Draw Whole duration
             {
@@ -75,25 +395,28 @@ VGE::Profiler::DrawProfiler()
 
             auto window_begin = ImGui::GetCursorScreenPos().y;
 
-            ProfileTimePoint stack[256];
-            stack[0] = mFrameStart;
+            // Events are ordered by when they ended, so going backwards visits parents before their children.
+            // The stack holds the chain of events enclosing the current one.
+            const ProfileEvent* stack[256];
             int layer = 0;
 
-            for (int i = mEventsCount[t] - 1, c = 0; i >= 0; i--, c = (c + 1) % (sizeof(colors) / sizeof(colors[0])))
+            for (int i = events_count - 1, c = 0; i >= 0; i--, c = (c + 1) % (sizeof(colors) / sizeof(colors[0])))
             {
+                const auto& event = events[i];
+
                 // Find correct layer to put event on.
-                while (mEvents[t][i].Begin < stack[layer])
+                while (layer > 0 && !(stack[layer - 1]->Begin <= event.Begin && event.End <= stack[layer - 1]->End))
                     layer--;
 
-                if (mEvents[t][i].Begin > stack[layer])
-                    layer++;
-                stack[layer] = mEvents[t][i].Begin;
-
                 VGE_ASSERT(layer < 256, "Callstack to deep, or malfunction in layering algorithm");
+                stack[layer++] = &event;
+
+                // Draw the events, clipped to the frame, as they can span multiple frames.
+                const auto begin = std::max(event.Begin, frame->Begin);
+                const auto end = std::min(event.End, frame->End);
 
-                // Draw the events
-                const auto x_begin = window_x_begin + (DurToMilli(mFrameStart, mEvents[t][i].Begin) / milli_pr_pixel);
-                const auto x_end = window_x_begin + (DurToMilli(mFrameStart, mEvents[t][i].End) / milli_pr_pixel);
+                const auto x_begin = window_x_begin + (DurToMilli(frame->Begin, begin) / milli_pr_pixel);
+                const auto x_end = window_x_begin + (DurToMilli(frame->Begin, end) / milli_pr_pixel);
                 const auto y_begin = window_begin + (text_height * (layer - 1));
                 const auto y_end = y_begin + text_height;
 
@@ -106,16 +429,16 @@ VGE::Profiler::DrawProfiler()
                 {
                     ImGui::BeginTooltip();
 
-                    const auto duration = DurToMilli(mEvents[t][i].Begin, mEvents[t][i].End);
+                    const auto duration = DurToMilli(event.Begin, event.End);
                     ImGui::Text("Event: %s\nDuration: %.4f (%.2f%%)",
-                                mEvents[t][i].Label,
+                                event.Label,
                                 duration,
-                                duration / frame_duration);
+                                (duration / frame_duration) * 100.0f);
 
                     ImGui::EndTooltip();
                 }
                 ImGui::SetCursorScreenPos({x_begin, y_begin});
-                ImGui::Text("%s", mEvents[t][i].Label);
+                ImGui::Text("%s", event.Label);
             }
             ImGui::NewLine();
             ImGui::NewLine();
@@ -125,8 +448,74 @@ VGE::Profiler::DrawProfiler()
 
 
     // TODO: Find way to make it less Jittery?
-    // TODO: Add button for "locking" frame-time
-    // TODO: Display warning if exceeding frame-time when having locked frame-time.
     // TODO: Do one child window pr thread, and label them properly!
 
 }
+
+void
+VGE::Profiler::DrawStatistics()
+{
+    const auto to_micro = [](ProfileDuration duration)
+    { return std::chrono::duration<float, std::micro>(duration).count(); };
+
+    ImGui::SliderInt("Window (frames)", &mStatsWindow, 1, MaxFrames);
+
+    static CallSiteStats stats[MaxCallSites];
+    static const CallSite* sites[MaxCallSites];
+    static int order[MaxCallSites];
+    int count = 0;
+
+    for (const auto& site : mCallSites)
+    {
+        if (!site.Function)
+            continue;
+
+        const auto site_stats = ComputeStats(site, mStatsWindow);
+        if (site_stats.Count == 0)
+            continue;
+
+        sites[count] = &site;
+        stats[count] = site_stats;
+        order[count] = count;
+        count++;
+    }
+
+    // Most expensive call sites first.
+    std::sort(order, order + count, [](int a, int b) { return stats[a].Total > stats[b].Total; });
+
+    constexpr const char* headers[] = {"Call site", "Count", "Total", "Min", "Max", "Mean", "p50", "p95", "p99"};
+    constexpr int columns = sizeof(headers) / sizeof(headers[0]);
+
+    ImGui::Text("Times in microseconds, over the last %d frames", mStatsWindow);
+    ImGui::Columns(columns, "call_sites");
+    ImGui::Separator();
+    for (auto header : headers)
+    {
+        ImGui::Text("%s", header);
+        ImGui::NextColumn();
+    }
+    ImGui::Separator();
+
+    for (int i = 0; i < count; i++)
+    {
+        const auto& site = *sites[order[i]];
+        const auto& s = stats[order[i]];
+
+        ImGui::Text("%s (%s:%d)", site.Function, site.Label, site.Line);
+        ImGui::NextColumn();
+        ImGui::Text("%llu", (unsigned long long)s.Count);
+        ImGui::NextColumn();
+
+        for (auto duration : {s.Total, s.Min, s.Max, s.Mean, s.P50, s.P95, s.P99})
+        {
+            ImGui::Text("%.2f", to_micro(duration));
+            ImGui::NextColumn();
+        }
+    }
+
+    ImGui::Columns(1);
+    ImGui::Separator();
+
+    if (mCallSiteCount == MaxCallSites)
+        ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Call site table is full, new call sites are ignored");
+}
@@ -3,15 +3,14 @@
 #include <vge_allocator.h>
 #include <vge_log.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <cstring>
-
-// TODO: Create a clock class.
-// TODO: Set a max for how many Profiling events we should keep.
 
 namespace VGE
 {
-    using ProfileTimePoint = std::chrono::high_resolution_clock::time_point;
+    using ProfileTimePoint = VGE::Clock::time_point;
+    using ProfileDuration = VGE::Clock::duration;
 
     struct ProfileEvent
     {
@@ -35,27 +34,121 @@ namespace VGE
             {}
     };
 
-    // TODO: Want a way to log profiling data to disk, so I can use the profiler in chrome.
-    // Important: This is currently just a frame profiler. I.e. it doesn't work with stuff that takes more than one frame.
+    // See VGE::TraceExporter for writing the events to disk.
+    // Every thread pushes into its own ring of events, so pushing never takes a lock.
+    // BeginFrame only marks where each ring was when the frame started, so the last MaxFrames frames
+    // can be inspected, as long as the rings haven't wrapped around since.
+    // When a frame ends, the events of all threads are also aggregated pr call site (Function, Line),
+    // giving statistics over a rolling window of frames.
+    // Note: Threads not started through VGE::Thread share ThreadID 0, and must not push events concurrently with the main thread.
     struct Profiler
     {
         // Think of having init and shutdown functions
         void PushProfileEvent(const ProfileEvent& event);
 
+        // Names the lane of a thread in the timeline and in traces, e.g. "Render". The string must outlive the profiler.
+        void SetThreadName(int thread_id, const char* name);
+        const char* ThreadName(int thread_id) const; // nullptr if the thread was never named.
+
+        // Only to be called from the main thread.
         void BeginFrame();
         void EndFrame();
         void DrawProfiler();
 
         // Members
-        // Temporary, find a better solution, or set off space for more.
-        constexpr static auto MaxEvents = 256;
+        constexpr static auto MaxEvents = 1 << 14; // Per thread, must be a power of two.
         constexpr static auto MaxFrames = 90;
+        constexpr static auto MaxCallSites = 256; // Must be a power of two.
+        constexpr static auto MaxSamples = 1024; // Pr call site, used for the percentiles.
+
+        struct CallSiteStats
+        {
+            u64 Count{};
+            ProfileDuration Total{};
+            ProfileDuration Min{};
+            ProfileDuration Max{};
+            ProfileDuration Mean{};
+            ProfileDuration P50{};
+            ProfileDuration P95{};
+            ProfileDuration P99{};
+        };
+
+        struct CallSite
+        {
+            const char* Function{};
+            const char* Label{};
+            int Line{};
+
+            // Aggregates of every frame in the history, indexed by frame number % MaxFrames.
+            u64 FrameNumber[MaxFrames]{};
+            u32 Count[MaxFrames]{};
+            i64 Total[MaxFrames]{};
+            i64 Min[MaxFrames]{};
+            i64 Max[MaxFrames]{};
+
+            // The most recent durations, percentiles are only computed over these,
+            // so call sites hit more than MaxSamples times in the window get approximate percentiles.
+            struct Sample
+            {
+                i64 Duration{};
+                u64 FrameNumber{};
+            };
+            Sample Samples[MaxSamples]{};
+            u64 SampleCount{};
+        };
+
+        struct Frame
+        {
+            ProfileTimePoint Begin{};
+            ProfileTimePoint End{};
+            u64 FirstEvent[VGE::Thread::MaxThreads]{}; // Head of each thread's ring when the frame began.
+        };
+
+        // Single producer ring, aligned so that threads never write to the same cache line.
+        struct alignas(64) ThreadEvents
+        {
+            std::atomic<u64> Head{}; // Total number of events ever pushed, the ring index is Head % MaxEvents.
+            ProfileEvent Events[MaxEvents] = {};
+        };
+
+        // Copies out the event at the given index, returns false if it has been overwritten.
+        bool ReadEvent(int thread_id, u64 idx, ProfileEvent& out) const;
+
+        // Frame n frames back in time, 0 being the last finished frame. nullptr if not recorded.
+        const Frame* GetFrame(int frames_back) const;
+
+        // Calls func for every event of thread_id which overlaps with the frame, including events that begin or end outside of it.
+        template<class F>
+        void ForEachEvent(const Frame& frame, int thread_id, F func) const;
+
+        // Aggregates the events that ended since the last call into the call sites, called when a frame ends.
+        void UpdateCallSites(u64 frame_number);
+        CallSite* FindCallSite(const char* function, int line, bool create);
+
+        // Statistics over the last window frames that have ended.
+        CallSiteStats ComputeStats(const CallSite& site, int window) const;
+
+        bool IsOverBudget(const Frame& frame) const;
+
+        void DrawFrameTimes(int& frames_back);
+        void DrawTimeline(int& frames_back);
+        void DrawStatistics();
+
+        ThreadEvents mThreadEvents[VGE::Thread::MaxThreads];
+        std::atomic<const char*> mThreadNames[VGE::Thread::MaxThreads]{};
 
-        // These should be aligned based on cacheline, to avoid false sharing.
-        ProfileEvent mEvents[VGE::Thread::MaxThreads][MaxEvents] = {};
-        int mEventsCount[VGE::Thread::MaxThreads]{};
+        Frame mFrames[MaxFrames];
+        u64 mFrameCount{}; // Total number of frames begun, mFrames[(mFrameCount - 1) % MaxFrames] is the current.
 
-        ProfileTimePoint mFrameStart{};
+        // Statistics
+        CallSite mCallSites[MaxCallSites];
+        int mCallSiteCount{};
+        u64 mCallSiteCursors[VGE::Thread::MaxThreads]{}; // How far into each ring the call sites have been updated.
+        u64 mStatsFrameCount{}; // Number of frames aggregated into the call sites.
+        int mStatsWindow{60};
+
+        float mFrameBudgetMs{1000.0f / 60.0f};
+        u64 mOverBudgetFrames{};
     };
 
     inline Profiler gProfiler;
@@ -66,22 +159,16 @@ namespace VGE
                      const char* function,
                      int line,
                      Profiler* profiler = &gProfiler)
-            : Begin(std::chrono::high_resolution_clock::now())
+            : Begin(VGE::Clock::now())
+            , Label(label)
             , Function(function)
             , Receiver(profiler)
             , Line(line)
-        {
-            #ifdef WIN32
-            Label = std::strrchr(label, '\\');
-            #else
-            Label = std::strrchr(label, '/');
-            #endif
-            Label = (Label) ? Label + 1 : label;
-        }
+        {}
 
         ~RAIIProfiler()
         {
-            ProfileEvent e(Label, Function, Line, Begin, std::chrono::high_resolution_clock::now());
+            ProfileEvent e(Label, Function, Line, Begin, VGE::Clock::now());
             Receiver->PushProfileEvent(e);
         }
 
@@ -92,10 +179,46 @@ namespace VGE
         int Line;
     };
 
+    template<class F>
+    void
+    Profiler::ForEachEvent(const Frame& frame, int thread_id, F func) const
+    {
+        // Events are pushed when they end, so events beginning in this frame can be found after the next frame started.
+        // Therefore scan everything from the start of the frame up to the current head.
+        const auto head = mThreadEvents[thread_id].Head.load(std::memory_order_acquire);
+        const auto oldest = (head > (u64)MaxEvents) ? head - MaxEvents : 0;
+
+        ProfileEvent event;
+        for (auto idx = std::max(frame.FirstEvent[thread_id], oldest); idx < head; idx++)
+        {
+            if (!ReadEvent(thread_id, idx, event))
+                continue;
+
+            if (event.Begin < frame.End && event.End > frame.Begin)
+                func(event);
+        }
+    }
+
     #define VGE_MACRO_APPEND_(a, b) a ## b
     #define VGE_MACRO_APPEND(a, b) VGE_MACRO_APPEND_(a, b)
 
-    #define VGE_PROFILE() auto VGE_MACRO_APPEND(profiler, __LINE__) = VGE::RAIIProfiler(__FILE__, __func__, __LINE__)
+    // Strips the directories of a path, meant to be evaluated at compile time.
+    constexpr const char*
+    Basename(const char* path)
+    {
+        auto result = path;
+        for (auto it = path; *it; it++)
+        {
+            if (*it == '/' || *it == '\\')
+                result = it + 1;
+        }
+        return result;
+    }
+
+    // The lambda forces the basename of the file to be a constant expression, so no work is done when entering the scope.
+    #define VGE_PROFILE_FILENAME_() [] { constexpr auto filename = VGE::Basename(__FILE__); return filename; }()
+
+    #define VGE_PROFILE() auto VGE_MACRO_APPEND(profiler, __LINE__) = VGE::RAIIProfiler(VGE_PROFILE_FILENAME_(), __func__, __LINE__)
     #define VGE_PROFILE_LABEL(x) auto VGE_MACRO_APPEND(profiler, __LINE__) = VGE::RAIIProfiler((x), __func__, __LINE__)
 
 }
@@ -0,0 +1,178 @@
+#include <vge_trace.h>
+#include <vge_assert.h>
+#include <vge_log.h>
+
+#include <chrono>
+
+static void
+write_json_string(std::FILE* file, const char* str)
+{
+    std::fputc('"', file);
+    for (; str && *str; str++)
+    {
+        const auto c = *str;
+        if (c == '"' || c == '\\')
+        {
+            std::fputc('\\', file);
+            std::fputc(c, file);
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            std::fprintf(file, "\\u%04x", (unsigned)c);
+        }
+        else
+        {
+            std::fputc(c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+bool
+VGE::TraceExporter::Start(const char* filepath, Profiler* profiler, int flush_interval_ms)
+{
+    VGE_ASSERT(!IsRunning(), "Trace exporter is already running");
+    VGE_ASSERT(profiler, "Trace exporter needs a profiler to export from");
+    VGE_ASSERT(flush_interval_ms > 0, "Flush interval must be positive, got: %d", flush_interval_ms);
+
+    mFile = std::fopen(filepath, "w");
+    if (!mFile)
+    {
+        VGE_WARN("Failed to open trace file: %s", filepath);
+        return false;
+    }
+
+    mProfiler = profiler;
+    mFlushIntervalMs = flush_interval_ms;
+    mStartTime = VGE::Clock::now();
+    mWrittenEvents.store(0);
+    mDroppedEvents.store(0);
+    mFirstEvent = true;
+
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+        mCursors[t] = profiler->mThreadEvents[t].Head.load(std::memory_order_acquire);
+
+    std::fprintf(mFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    mRunning = true;
+    mThread = std::thread([this]() { Run(); });
+    return true;
+}
+
+void
+VGE::TraceExporter::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mRunning = false;
+    }
+    mWakeup.notify_one();
+    mThread.join();
+
+    // The exporter thread is gone, so events pushed since its last flush are drained here.
+    Flush();
+
+    // Name the lanes last, as threads may have been named after the trace started.
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+    {
+        char name[64];
+        if (const auto thread_name = mProfiler->ThreadName(t))
+            std::snprintf(name, sizeof(name), "%s (ThreadID: %d)", thread_name, t);
+        else
+            std::snprintf(name, sizeof(name), "ThreadID: %d", t);
+
+        std::fprintf(mFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":",
+                     mFirstEvent ? "" : ",\n", t);
+        write_json_string(mFile, name);
+        std::fprintf(mFile, "}}");
+        mFirstEvent = false;
+    }
+
+    std::fprintf(mFile, "\n]}\n");
+    std::fclose(mFile);
+    mFile = nullptr;
+
+    if (const auto dropped = mDroppedEvents.load())
+        VGE_WARN("Trace exporter dropped %llu events, consider a shorter flush interval", (unsigned long long)dropped);
+}
+
+bool
+VGE::TraceExporter::IsRunning() const
+{
+    return mFile != nullptr;
+}
+
+u64
+VGE::TraceExporter::WrittenEvents() const
+{
+    return mWrittenEvents.load(std::memory_order_relaxed);
+}
+
+u64
+VGE::TraceExporter::DroppedEvents() const
+{
+    return mDroppedEvents.load(std::memory_order_relaxed);
+}
+
+void
+VGE::TraceExporter::Run()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    while (mRunning)
+    {
+        lock.unlock();
+        Flush();
+        lock.lock();
+
+        mWakeup.wait_for(lock, std::chrono::milliseconds(mFlushIntervalMs), [this]() { return !mRunning; });
+    }
+}
+
+void
+VGE::TraceExporter::Flush()
+{
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+    {
+        const auto head = mProfiler->mThreadEvents[t].Head.load(std::memory_order_acquire);
+        auto& cursor = mCursors[t];
+
+        // Everything older than one ring behind the head has already been overwritten.
+        if (head - cursor > (u64)Profiler::MaxEvents)
+        {
+            mDroppedEvents.fetch_add(head - Profiler::MaxEvents - cursor, std::memory_order_relaxed);
+            cursor = head - Profiler::MaxEvents;
+        }
+
+        ProfileEvent event;
+        for (; cursor < head; cursor++)
+        {
+            if (mProfiler->ReadEvent(t, cursor, event))
+                WriteEvent(t, event);
+            else
+                mDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::fflush(mFile);
+}
+
+void
+VGE::TraceExporter::WriteEvent(int thread_id, const ProfileEvent& event)
+{
+    using Micro = std::chrono::duration<double, std::micro>;
+    const auto ts = Micro(event.Begin - mStartTime).count();
+    const auto dur = Micro(event.End - event.Begin).count();
+
+    std::fprintf(mFile, "%s{\"ph\":\"X\",\"cat\":\"vge\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                 mFirstEvent ? "" : ",\n", thread_id, ts, dur);
+    write_json_string(mFile, event.Label);
+    std::fprintf(mFile, ",\"args\":{\"function\":");
+    write_json_string(mFile, event.Function);
+    std::fprintf(mFile, ",\"line\":%d}}", event.Line);
+
+    mFirstEvent = false;
+    mWrittenEvents.fetch_add(1, std::memory_order_relaxed);
+}
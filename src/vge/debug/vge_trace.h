@@ -0,0 +1,57 @@
+#pragma once
+#include <vge_core.h>
+#include <vge_profiler.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace VGE
+{
+    // Streams every ProfileEvent pushed to a profiler into a Chrome JSON trace,
+    // which can be opened in chrome://tracing or https://ui.perfetto.dev.
+    // The rings are drained by a background thread, so the threads pushing events never touch the file system.
+    // If a ring wraps around before it has been drained, the overwritten events are dropped and counted.
+    struct TraceExporter
+    {
+        constexpr static auto DefaultFlushIntervalMs = 5;
+
+        // Only events pushed after Start are written. Returns false if the file could not be opened.
+        bool Start(const char* filepath, Profiler* profiler = &gProfiler, int flush_interval_ms = DefaultFlushIntervalMs);
+
+        // Drains whatever is left in the rings and closes the file.
+        void Stop();
+
+        bool IsRunning() const;
+        u64 WrittenEvents() const;
+        u64 DroppedEvents() const;
+
+        // Members
+        void Run();
+        void Flush();
+        void WriteEvent(int thread_id, const ProfileEvent& event);
+
+        Profiler* mProfiler{};
+        std::FILE* mFile{};
+        ProfileTimePoint mStartTime{};
+        int mFlushIntervalMs{};
+
+        // Only touched by the exporter thread while running.
+        u64 mCursors[VGE::Thread::MaxThreads]{};
+        bool mFirstEvent{};
+
+        std::atomic<u64> mWrittenEvents{};
+        std::atomic<u64> mDroppedEvents{};
+
+        // Not a VGE::Thread, as it should not take a ThreadID from the job system.
+        // It never pushes events or touches any per-thread tables.
+        std::thread mThread{};
+        std::mutex mLock;
+        std::condition_variable mWakeup;
+        bool mRunning{};
+    };
+
+    inline TraceExporter gTraceExporter;
+}
@@ -0,0 +1,100 @@
+#include <vge_command_buffer.h>
+#include <vge_assert.h>
+
+VGE::CommandBuffer::CommandBuffer(Allocator& allocator)
+    : mCommands(allocator)
+    , mUniforms(allocator)
+{
+}
+
+void
+VGE::CommandBuffer::Submit(const StaticDrawCommand& command)
+{
+    mCommands.PushBack(command);
+}
+
+u32
+VGE::CommandBuffer::AllocateUniforms(int size)
+{
+    return mUniforms.Allocate(size);
+}
+
+void
+VGE::CommandBuffer::WriteUniform(u32 block, const Uniform& uniform, const void* data, int size)
+{
+    mUniforms.Write(block, uniform, data, size);
+}
+
+void
+VGE::CommandBuffer::SetAlignment(int alignment)
+{
+    mUniforms.SetAlignment(alignment);
+}
+
+void
+VGE::CommandBuffer::Clear()
+{
+    mCommands.Clear();
+    mUniforms.Reset();
+}
+
+int
+VGE::CommandBuffer::Size() const
+{
+    return mCommands.Size();
+}
+
+const VGE::StaticDrawCommand&
+VGE::CommandBuffer::Command(int idx) const
+{
+    return mCommands[idx];
+}
+
+const VGE::UniformArena&
+VGE::CommandBuffer::Uniforms() const
+{
+    return mUniforms;
+}
+
+VGE::CommandBuffer&
+VGE::ThreadCommandBuffers::ThisThread()
+{
+    return Buffer(Thread::ThisThread::ID());
+}
+
+VGE::CommandBuffer&
+VGE::ThreadCommandBuffers::Buffer(Thread::ThreadID id)
+{
+    VGE_ASSERT(id >= 0 && id < Thread::MaxThreads, "No command buffer for thread %d", id);
+    return mBuffers[id];
+}
+
+void
+VGE::ThreadCommandBuffers::SetAlignment(int alignment)
+{
+    for (auto& buffer : mBuffers)
+        buffer.SetAlignment(alignment);
+}
+
+int
+VGE::ThreadCommandBuffers::Merge(RenderQueue& queue, UniformArena& uniforms)
+{
+    int merged = 0;
+    for (auto& buffer : mBuffers)
+    {
+        const auto base = uniforms.Append(buffer.Uniforms());
+        for (int i = 0; i < buffer.Size(); i++)
+        {
+            auto command = buffer.Command(i);
+            if (command.Uniforms != NoUniforms)
+                command.Uniforms += base;
+
+            queue.Submit(command);
+        }
+
+        merged += buffer.Size();
+        buffer.Clear();
+    }
+
+    return merged;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <vge_core.h>
+#include <vge_array.h>
+#include <vge_draw_cmd.h>
+#include <vge_render_queue.h>
+#include <vge_uniform_arena.h>
+
+namespace VGE
+{
+    // The static draw commands recorded by one thread, along with the uniform blocks they point into.
+    // Knows nothing about OpenGL, so commands can be recorded on any thread, and tested without a GPU.
+    // Aligned to a cache line, as neighbouring buffers are written by different threads.
+    class alignas(64) CommandBuffer
+    {
+    public:
+        CommandBuffer(Allocator& allocator = *GetDefaultAllocator());
+
+        void Submit(const StaticDrawCommand& command);
+
+        // Offsets are local to this buffer until it is merged.
+        u32 AllocateUniforms(int size);
+        void WriteUniform(u32 block, const Uniform& uniform, const void* data, int size);
+
+        // Should match the alignment of the arena it is merged into.
+        void SetAlignment(int alignment);
+
+        void Clear();
+
+        int Size() const;
+        const StaticDrawCommand& Command(int idx) const;
+        const UniformArena& Uniforms() const;
+
+    private:
+        Array<StaticDrawCommand> mCommands;
+        UniformArena mUniforms;
+    };
+
+    // One command buffer pr VGE::Thread, picked with ThisThread::ID(), so any number of threads can record at once without locking.
+    // Once recording is done, a single thread merges all of them into the render queue and uniform arena of the frame.
+    // Note: A block of uniforms has to be written by the thread that allocated it, so don't wait on a job counter in between.
+    class ThreadCommandBuffers
+    {
+    public:
+        CommandBuffer& ThisThread();
+        CommandBuffer& Buffer(Thread::ThreadID id);
+
+        void SetAlignment(int alignment);
+
+        // Thread 0 first, then 1, 2, ..., each in submission order, so the merged order only depends on which thread recorded what.
+        // Which thread that is changes from frame to frame, so give the commands a Sequence if the draw order of equal keys matters.
+        // The uniforms are appended to the arena, and the offsets in the commands moved along with them.
+        // Returns the number of commands merged, and clears all the buffers.
+        int Merge(RenderQueue& queue, UniformArena& uniforms);
+
+    private:
+        CommandBuffer mBuffers[Thread::MaxThreads];
+    };
+}
@@ -1,46 +1,32 @@
 #pragma once
 #include <vge_gfx_types.h>
-#include <vge_debug.h>
+#include <vge_color.h>
 
 namespace VGE
 {
-    struct Uniform
+    // The uniform blocks a shader can declare, each bound to the binding point of the same value.
+    // Declared in the shader as: layout(std140) uniform PerFrame { ... }; and layout(std140) uniform PerDraw { ... };
+    enum class UniformBlock : u8
     {
-        Uniform()
-        {}
-
-        Uniform(const char* name)
-        {
-            VGE_ASSERT(std::strlen(name) < sizeof(Name), "Uniform name: %s is longer than %zu", std::strlen(name), sizeof(Name));
-            std::strcpy(Name, name);
-        }
-
-        char Name[64]{};
-
-        enum UniformType
-        {
-            Int,
-            Float,
-            Vec2,
-            Vec3,
-            Vec4,
-            Mat4,
-            Sampler2D,
-        };
+        Frame, // Written once pr frame, shared by all draws.
+        Draw, // Written for every draw.
+        Count,
+    };
 
-        UniformType Type;
+    // Where a uniform lives inside the uniform blocks of a shader, resolved once when the shader is linked.
+    struct Uniform
+    {
+        UniformBlock Block{UniformBlock::Count};
+        u16 Size{}; // In bytes
+        u32 Type{}; // The GLenum of the uniform type
+        i32 Offset{-1}; // In bytes, from the start of the block
 
-        union
-        {
-            int AsInt;
-            float AsFloat;
-            glm::vec2 AsVec2;
-            glm::vec3 AsVec3;
-            glm::vec4 AsVec4;
-            glm::mat4 AsMat4;
-        };
+        bool Valid() const { return Offset >= 0; }
     };
 
+    // Offset of a uniform block that has not been allocated.
+    constexpr u32 NoUniforms = 0xFFFFFFFF;
+
     // At the moment, only support 2 textures
     struct StaticDrawCommand
     {
@@ -48,9 +34,9 @@ namespace VGE
         ShaderHandle Shader{};
         TextureHandle UV0{};
         TextureHandle UV1{};
-
-        Uniform Uniforms[16];
-        int UniformCount{};
+        float Depth{}; // Distance from the camera, draws sharing state are drawn front to back.
+        u32 Uniforms{NoUniforms}; // Offset of the PerDraw block in the uniform arena of the frame
+        u32 Sequence{}; // Set by the caller, e.g. the job or object index. Orders draws with equal sort keys, whichever thread recorded them.
     };
 
     // This need to be extended to also allow for triangles.
@@ -61,9 +47,7 @@ namespace VGE
         glm::vec3* Vertices{};
         Color* Colors{};
         int VerticesCount{};
-
-        Uniform Uniforms[16];
-        int UniformCount{};
+        u32 Uniforms{NoUniforms};
     };
 
 
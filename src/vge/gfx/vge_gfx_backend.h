@@ -0,0 +1,68 @@
+#pragma once
+#include <vge_core.h>
+#include <vge_hash_map.h>
+#include <vge_string.h>
+#include <vge_draw_cmd.h>
+#include <vge_gfx_types.h>
+
+namespace VGE
+{
+    // The objects backing a mesh, named by the backend, 0 being none.
+    struct MeshBuffers
+    {
+        u32 VAO{};
+        u32 VBO{};
+        u32 EBO{};
+        u32 uv0TBO{};
+        u32 uv1TBO{};
+        int IndexCount{};
+    };
+
+    // Everything the GFXManager asks of the graphics API, so it can run on something other than OpenGL.
+    // The GFXManager keeps the resource tables and handles, the backend only creates, binds and draws the objects behind them.
+    // Objects are named by u32s handed out by the backend, 0 being none, as in OpenGL.
+    // Only called from the thread owning the context (the render thread, if there is one).
+    class GFXBackend
+    {
+    public:
+        virtual ~GFXBackend() = default;
+
+        virtual const char* Name() const = 0;
+
+        // immediate_size is the size in bytes of the vertex buffer behind DrawLines.
+        virtual void Init(int immediate_size) = 0;
+
+        // Offsets given to BindUniforms have to be a multiple of this.
+        virtual int UniformBufferAlignment() const = 0;
+
+        // Positions go in attribute 0, and uv0 in attribute 1.
+        virtual MeshBuffers CreateMesh(const MeshData& data) = 0;
+        virtual void DestroyMesh(const MeshBuffers& mesh) = 0;
+
+        // 8 bits pr channel, 3 channels is RGB and 4 is RGBA.
+        virtual TextureID CreateTexture(const void* pixels, int width, int height, int channels) = 0;
+
+        virtual ProgramID CreateProgram() = 0;
+
+        // Compile errors are logged, the shader is returned either way.
+        virtual ShaderID CompileShader(const char* source, GLenum type) = 0;
+        virtual void AttachShader(ProgramID program, ShaderID shader) = 0;
+        virtual bool LinkProgram(ProgramID program) = 0;
+
+        // Binds the PerFrame and PerDraw blocks of a linked program to their UniformBlock index,
+        // and fills in the size of each block and where every uniform in them lives.
+        virtual void ReflectUniforms(ProgramID program, HashMap<StringID, Uniform>& uniforms, int (&block_sizes)[(int)UniformBlock::Count]) = 0;
+
+        // Replaces the contents of the uniform buffer, without waiting on draws still reading the old contents.
+        virtual void UploadUniforms(const void* data, int size) = 0;
+        virtual void BindUniforms(UniformBlock block, u32 offset, int size) = 0;
+
+        virtual void BindProgram(ProgramID program) = 0;
+        virtual void BindTexture(int unit, TextureID texture) = 0;
+        virtual void BindMesh(const MeshBuffers& mesh) = 0; // An empty MeshBuffers unbinds.
+        virtual void DrawIndexed(int index_count) = 0;
+
+        // Vertices are GFXManager::Vertex, drawn as a list of lines.
+        virtual void DrawLines(const void* vertices, int vertex_count, int vertex_size) = 0;
+    };
+}
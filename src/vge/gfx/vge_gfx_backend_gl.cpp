@@ -0,0 +1,274 @@
+#include <vge_gfx_backend_gl.h>
+#include <vge_gfx_gl.h>
+#include <vge_assert.h>
+#include <vge_log.h>
+
+#include <algorithm>
+#include <cstring>
+#include <glm/glm.hpp>
+
+namespace local
+{
+    // Size in bytes of the uniform types that can be written to a uniform block, 0 if not supported.
+    int
+    uniform_size(GLenum type)
+    {
+        switch (type)
+        {
+            case GL_INT:        return sizeof(GLint);
+            case GL_FLOAT:      return sizeof(GLfloat);
+            case GL_FLOAT_VEC2: return sizeof(glm::vec2);
+            case GL_FLOAT_VEC3: return sizeof(glm::vec3);
+            case GL_FLOAT_VEC4: return sizeof(glm::vec4);
+            case GL_FLOAT_MAT4: return sizeof(glm::mat4);
+            default:            return 0;
+        }
+    }
+}
+
+const char*
+VGE::GLBackend::Name() const
+{
+    return "OpenGL";
+}
+
+void
+VGE::GLBackend::Init(int immediate_size)
+{
+    glGenVertexArrays(1, &mDynamicVAO);
+    glBindVertexArray(mDynamicVAO);
+
+    glCreateBuffers(1, &mDynamicVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, mDynamicVBO);
+    glBufferData(GL_ARRAY_BUFFER, immediate_size, nullptr, GL_STREAM_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    mDynamicVBOSize = immediate_size;
+
+    glBindVertexArray(0);
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &mUniformAlignment);
+    glCreateBuffers(1, &mUniformBuffer);
+}
+
+int
+VGE::GLBackend::UniformBufferAlignment() const
+{
+    return mUniformAlignment;
+}
+
+VGE::MeshBuffers
+VGE::GLBackend::CreateMesh(const MeshData& data)
+{
+    MeshBuffers new_data;
+    new_data.IndexCount = data.triangle_count;
+
+    glGenVertexArrays(1, &new_data.VAO);
+    glBindVertexArray(new_data.VAO); // Bind VAO to start "recording" binding calls
+
+    glGenBuffers(1, &new_data.EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, new_data.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * data.triangle_count, data.triangles, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &new_data.VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, new_data.VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * data.vertex_count, data.vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glGenBuffers(1, &new_data.uv0TBO);
+    glBindBuffer(GL_ARRAY_BUFFER, new_data.uv0TBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2) * data.vertex_count, data.uv0, GL_STATIC_DRAW);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+
+    glBindVertexArray(0); // Unbind VAO to avoid messing it up by binding other stuff.
+
+    return new_data;
+}
+
+void
+VGE::GLBackend::DestroyMesh(const MeshBuffers& mesh)
+{
+    glDeleteVertexArrays(1, &mesh.VAO);
+    glDeleteBuffers(1, &mesh.VBO);
+    glDeleteBuffers(1, &mesh.EBO);
+    glDeleteBuffers(1, &mesh.uv0TBO);
+}
+
+VGE::TextureID
+VGE::GLBackend::CreateTexture(const void* pixels, int width, int height, int channels)
+{
+    TextureID texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    const auto fmt = (channels < 4) ? GL_RGB : GL_RGBA;
+
+    glTexImage2D(GL_TEXTURE_2D, 0, fmt, width, height, 0, fmt, GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    return texture;
+}
+
+VGE::ProgramID
+VGE::GLBackend::CreateProgram()
+{
+    return glCreateProgram();
+}
+
+VGE::ShaderID
+VGE::GLBackend::CompileShader(const char* source, GLenum type)
+{
+    auto shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    int success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        GLchar info_log[512];
+        glGetShaderInfoLog(shader, 512, NULL, info_log);
+        VGE_WARN("%s", info_log);
+    }
+    return shader;
+}
+
+void
+VGE::GLBackend::AttachShader(ProgramID program, ShaderID shader)
+{
+    glAttachShader(program, shader);
+}
+
+bool
+VGE::GLBackend::LinkProgram(ProgramID program)
+{
+    glLinkProgram(program);
+
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        GLchar info_log[512];
+        glGetProgramInfoLog(program, 512, nullptr, info_log);
+        VGE_WARN("%s", info_log);
+    }
+    return success;
+}
+
+void
+VGE::GLBackend::ReflectUniforms(ProgramID program, HashMap<StringID, Uniform>& uniforms, int (&block_sizes)[(int)UniformBlock::Count])
+{
+    const char* block_names[] = {"PerFrame", "PerDraw"};
+    static_assert(sizeof(block_names) / sizeof(block_names[0]) == (int)UniformBlock::Count, "Every uniform block needs a name");
+
+    GLuint block_indices[(int)UniformBlock::Count];
+    for (int block = 0; block < (int)UniformBlock::Count; block++)
+    {
+        block_indices[block] = glGetUniformBlockIndex(program, block_names[block]);
+        block_sizes[block] = 0;
+        if (block_indices[block] == GL_INVALID_INDEX)
+            continue;
+
+        glUniformBlockBinding(program, block_indices[block], block);
+        glGetActiveUniformBlockiv(program, block_indices[block], GL_UNIFORM_BLOCK_DATA_SIZE, &block_sizes[block]);
+    }
+
+    uniforms.Clear();
+
+    GLint uniform_count;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniform_count);
+    for (GLuint i = 0; i < (GLuint)uniform_count; i++)
+    {
+        GLint block_index;
+        glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_BLOCK_INDEX, &block_index);
+
+        const auto block = std::find(block_indices, block_indices + (int)UniformBlock::Count, (GLuint)block_index) - block_indices;
+        if (block_index < 0 || block == (int)UniformBlock::Count)
+            continue; // Not in one of our blocks, these are set directly on the program.
+
+        char name[64];
+        GLint array_size;
+        GLenum type;
+        glGetActiveUniform(program, i, sizeof(name), nullptr, &array_size, &type, name);
+
+        const auto size = local::uniform_size(type);
+        if (size == 0)
+        {
+            VGE_WARN("Uniform %s has type %s, which can't be written to a uniform block yet", name, GFX::GLEnumToString(type));
+            continue;
+        }
+
+        GLint offset;
+        glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_OFFSET, &offset);
+
+        Uniform uniform;
+        uniform.Block = (UniformBlock)block;
+        uniform.Size = (u16)size;
+        uniform.Type = type;
+        uniform.Offset = offset;
+        uniforms.Insert(StringID(name), uniform);
+    }
+}
+
+// The buffer is orphaned first, so we don't wait on draws still reading the last frame.
+void
+VGE::GLBackend::UploadUniforms(const void* data, int size)
+{
+    if (size > mUniformBufferSize)
+        mUniformBufferSize = std::max(size, mUniformBufferSize * 2);
+
+    glNamedBufferData(mUniformBuffer, mUniformBufferSize, nullptr, GL_STREAM_DRAW);
+    glNamedBufferSubData(mUniformBuffer, 0, size, data);
+}
+
+void
+VGE::GLBackend::BindUniforms(UniformBlock block, u32 offset, int size)
+{
+    glBindBufferRange(GL_UNIFORM_BUFFER, (GLuint)block, mUniformBuffer, offset, size);
+}
+
+void
+VGE::GLBackend::BindProgram(ProgramID program)
+{
+    glUseProgram(program);
+}
+
+void
+VGE::GLBackend::BindTexture(int unit, TextureID texture)
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void
+VGE::GLBackend::BindMesh(const MeshBuffers& mesh)
+{
+    glBindVertexArray(mesh.VAO);
+}
+
+void
+VGE::GLBackend::DrawIndexed(int index_count)
+{
+    glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, 0);
+}
+
+void
+VGE::GLBackend::DrawLines(const void* vertices, int vertex_count, int vertex_size)
+{
+    VGE_ASSERT(vertex_count * vertex_size <= mDynamicVBOSize, "Trying to draw %d bytes of lines, the buffer only holds %d", vertex_count * vertex_size, mDynamicVBOSize);
+
+    auto buffer = glMapNamedBuffer(mDynamicVBO, GL_WRITE_ONLY);
+    std::memcpy(buffer, vertices, vertex_count * vertex_size);
+    glUnmapNamedBuffer(mDynamicVBO);
+    glBindVertexArray(mDynamicVAO);
+    glDrawArrays(GL_LINES, 0, vertex_count);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <vge_gfx_backend.h>
+#include <glad/glad.h>
+
+namespace VGE
+{
+    // The OpenGL 4.5 backend, needs a current context with glad loaded.
+    class GLBackend
+        : public GFXBackend
+    {
+    public:
+        virtual const char* Name() const override;
+        virtual void Init(int immediate_size) override;
+        virtual int UniformBufferAlignment() const override;
+
+        virtual MeshBuffers CreateMesh(const MeshData& data) override;
+        virtual void DestroyMesh(const MeshBuffers& mesh) override;
+
+        virtual TextureID CreateTexture(const void* pixels, int width, int height, int channels) override;
+
+        virtual ProgramID CreateProgram() override;
+        virtual ShaderID CompileShader(const char* source, GLenum type) override;
+        virtual void AttachShader(ProgramID program, ShaderID shader) override;
+        virtual bool LinkProgram(ProgramID program) override;
+        virtual void ReflectUniforms(ProgramID program, HashMap<StringID, Uniform>& uniforms, int (&block_sizes)[(int)UniformBlock::Count]) override;
+
+        virtual void UploadUniforms(const void* data, int size) override;
+        virtual void BindUniforms(UniformBlock block, u32 offset, int size) override;
+
+        virtual void BindProgram(ProgramID program) override;
+        virtual void BindTexture(int unit, TextureID texture) override;
+        virtual void BindMesh(const MeshBuffers& mesh) override;
+        virtual void DrawIndexed(int index_count) override;
+        virtual void DrawLines(const void* vertices, int vertex_count, int vertex_size) override;
+
+    private:
+        GLuint mDynamicVBO{};
+        GLuint mDynamicVAO{};
+        int mDynamicVBOSize{};
+
+        GLuint mUniformBuffer{};
+        int mUniformBufferSize{};
+        int mUniformAlignment{256};
+    };
+
+    inline GLBackend gGLBackend;
+}
@@ -0,0 +1,461 @@
+#include <vge_gfx_backend_null.h>
+#include <vge_assert.h>
+#include <vge_log.h>
+
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <glm/glm.hpp>
+
+namespace local
+{
+    struct std140_type
+    {
+        std::string_view name;
+        GLenum type;
+        int size;
+        int alignment;
+    };
+
+    // The types a uniform block can hold in the GFXManager.
+    constexpr std140_type std140_types[] =
+    {
+        {"int",  GL_INT,        sizeof(GLint),     4},
+        {"float", GL_FLOAT,     sizeof(GLfloat),   4},
+        {"vec2", GL_FLOAT_VEC2, sizeof(glm::vec2), 8},
+        {"vec3", GL_FLOAT_VEC3, sizeof(glm::vec3), 16},
+        {"vec4", GL_FLOAT_VEC4, sizeof(glm::vec4), 16},
+        {"mat4", GL_FLOAT_MAT4, sizeof(glm::mat4), 16},
+    };
+
+    // Identifiers and numbers are one token, anything else is one character. Skips whitespace and comments.
+    std::string_view
+    next_token(const char*& it)
+    {
+        while (*it)
+        {
+            if (std::isspace((unsigned char)*it))
+            {
+                it++;
+            }
+            else if (it[0] == '/' && it[1] == '/')
+            {
+                while (*it && *it != '\n')
+                    it++;
+            }
+            else if (it[0] == '/' && it[1] == '*')
+            {
+                it += 2;
+                while (*it && !(it[0] == '*' && it[1] == '/'))
+                    it++;
+                if (*it)
+                    it += 2;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        const auto begin = it;
+        const auto is_word = [](char c) { return std::isalnum((unsigned char)c) || c == '_'; };
+        if (is_word(*it))
+        {
+            while (is_word(*it))
+                it++;
+        }
+        else if (*it)
+        {
+            it++;
+        }
+        return std::string_view(begin, it - begin);
+    }
+
+    // Lays out the members of the PerFrame and PerDraw blocks declared in the source, following the std140 rules.
+    void
+    reflect_std140(const char* source, VGE::HashMap<VGE::StringID, VGE::Uniform>& uniforms, int (&block_sizes)[(int)VGE::UniformBlock::Count])
+    {
+        constexpr std::string_view block_names[] = {"PerFrame", "PerDraw"};
+        static_assert(sizeof(block_names) / sizeof(block_names[0]) == (int)VGE::UniformBlock::Count, "Every uniform block needs a name");
+
+        auto it = source;
+        for (auto token = next_token(it); !token.empty(); token = next_token(it))
+        {
+            if (token != "uniform")
+                continue;
+
+            const auto block = std::find(block_names, block_names + (int)VGE::UniformBlock::Count, next_token(it)) - block_names;
+            if (block == (int)VGE::UniformBlock::Count || next_token(it) != "{")
+                continue; // Not one of our blocks, or not a block at all.
+
+            int offset = 0;
+            for (auto type_name = next_token(it); !type_name.empty() && type_name != "}"; type_name = next_token(it))
+            {
+                const auto name = next_token(it);
+                auto end = next_token(it);
+
+                const auto type = std::find_if(std::begin(std140_types), std::end(std140_types), [&](const std140_type& type) { return type.name == type_name; });
+                if (type == std::end(std140_types) || end != ";")
+                {
+                    VGE_WARN("Null backend can't lay out: %.*s %.*s, in block %.*s", (int)type_name.size(), type_name.data(),
+                             (int)name.size(), name.data(), (int)block_names[block].size(), block_names[block].data());
+                    while (!end.empty() && end != ";")
+                        end = next_token(it);
+                    continue;
+                }
+
+                offset = (offset + type->alignment - 1) & ~(type->alignment - 1);
+
+                VGE::Uniform uniform;
+                uniform.Block = (VGE::UniformBlock)block;
+                uniform.Size = (u16)type->size;
+                uniform.Type = type->type;
+                uniform.Offset = offset;
+                uniforms.Insert(VGE::StringID(name), uniform);
+
+                offset += type->size;
+            }
+
+            // Blocks are padded to the alignment of a vec4.
+            block_sizes[block] = std::max(block_sizes[block], (offset + 15) & ~15);
+        }
+    }
+}
+
+VGE::NullBackend::NullBackend(int uniform_alignment, Allocator& allocator)
+    : mObjects(allocator)
+    , mShaderSources(allocator)
+    , mCalls(allocator)
+    , mUniformAlignment(uniform_alignment)
+{
+    VGE_ASSERT(uniform_alignment > 0 && (uniform_alignment & (uniform_alignment - 1)) == 0, "Uniform buffer alignment: %d is not a power of two", uniform_alignment);
+}
+
+void
+VGE::NullBackend::RecordCalls(bool record)
+{
+    mRecordCalls = record;
+}
+
+const VGE::Array<VGE::NullBackend::Call>&
+VGE::NullBackend::Calls() const
+{
+    return mCalls;
+}
+
+const VGE::NullBackend::Stats&
+VGE::NullBackend::GetStats() const
+{
+    return mStats;
+}
+
+void
+VGE::NullBackend::ResetStats()
+{
+    mStats = {};
+    mCalls.Clear();
+}
+
+int
+VGE::NullBackend::ObjectCount() const
+{
+    return mObjects.Size();
+}
+
+const char*
+VGE::NullBackend::CallName(CallType type)
+{
+    switch (type)
+    {
+        case CallType::CreateMesh:      return "CreateMesh";
+        case CallType::DestroyMesh:     return "DestroyMesh";
+        case CallType::CreateTexture:   return "CreateTexture";
+        case CallType::CreateProgram:   return "CreateProgram";
+        case CallType::CompileShader:   return "CompileShader";
+        case CallType::AttachShader:    return "AttachShader";
+        case CallType::LinkProgram:     return "LinkProgram";
+        case CallType::ReflectUniforms: return "ReflectUniforms";
+        case CallType::UploadUniforms:  return "UploadUniforms";
+        case CallType::BindUniforms:    return "BindUniforms";
+        case CallType::BindProgram:     return "BindProgram";
+        case CallType::BindTexture:     return "BindTexture";
+        case CallType::BindMesh:        return "BindMesh";
+        case CallType::DrawIndexed:     return "DrawIndexed";
+        case CallType::DrawLines:       return "DrawLines";
+        default:                        return "Unknown";
+    }
+}
+
+const char*
+VGE::NullBackend::Name() const
+{
+    return "Null";
+}
+
+void
+VGE::NullBackend::Init(int immediate_size)
+{
+    mImmediateSize = immediate_size;
+}
+
+int
+VGE::NullBackend::UniformBufferAlignment() const
+{
+    return mUniformAlignment;
+}
+
+VGE::MeshBuffers
+VGE::NullBackend::CreateMesh(const MeshData& data)
+{
+    VGE_ASSERT(data.vertex_count >= 0 && data.triangle_count >= 0, "Mesh with %d vertices and %d indices", data.vertex_count, data.triangle_count);
+    VGE_ASSERT(data.triangle_count == 0 || data.triangles, "Mesh has %d indices, but no index data", data.triangle_count);
+    VGE_ASSERT(data.vertex_count == 0 || data.vertices, "Mesh has %d vertices, but no vertex data", data.vertex_count);
+
+    // Indices have to be in range, as the GPU would happily read outside of the buffers.
+    for (int i = 0; i < data.triangle_count; i++)
+        VGE_ASSERT((int)data.triangles[i] < data.vertex_count, "Index %u of mesh is out of range, it has %d vertices", data.triangles[i], data.vertex_count);
+
+    MeshBuffers mesh;
+    mesh.VAO = CreateObject(ObjectType::VertexArray);
+    mesh.EBO = CreateObject(ObjectType::Buffer);
+    mesh.VBO = CreateObject(ObjectType::Buffer);
+    mesh.uv0TBO = CreateObject(ObjectType::Buffer);
+    mesh.IndexCount = data.triangle_count;
+    GetObject(mesh.VAO, ObjectType::VertexArray).IndexCount = data.triangle_count;
+
+    const auto bytes = (i64)sizeof(GLuint) * data.triangle_count + ((i64)sizeof(glm::vec3) + (i64)sizeof(glm::vec2)) * data.vertex_count;
+    Upload(mStats.MeshBytes, bytes);
+    Record(CallType::CreateMesh, mesh.VAO, bytes);
+    return mesh;
+}
+
+void
+VGE::NullBackend::DestroyMesh(const MeshBuffers& mesh)
+{
+    Record(CallType::DestroyMesh, mesh.VAO, 0);
+
+    if ((u64)mesh.VAO == mVertexArray)
+        mVertexArray = 0;
+
+    DestroyObject(mesh.VAO, ObjectType::VertexArray);
+    DestroyObject(mesh.EBO, ObjectType::Buffer);
+    DestroyObject(mesh.VBO, ObjectType::Buffer);
+    DestroyObject(mesh.uv0TBO, ObjectType::Buffer);
+    DestroyObject(mesh.uv1TBO, ObjectType::Buffer);
+}
+
+VGE::TextureID
+VGE::NullBackend::CreateTexture(const void* pixels, int width, int height, int channels)
+{
+    VGE_ASSERT(pixels && width > 0 && height > 0, "Texture of %dx%d without pixels", width, height);
+    VGE_ASSERT(channels >= 1 && channels <= 4, "Texture with %d channels", channels);
+
+    const auto texture = CreateObject(ObjectType::Texture);
+
+    // Uploaded as RGB or RGBA, see the GLBackend. The mipmaps are generated on the GPU.
+    const auto bytes = (i64)width * height * ((channels < 4) ? 3 : 4);
+    Upload(mStats.TextureBytes, bytes);
+    Record(CallType::CreateTexture, texture, bytes);
+    return texture;
+}
+
+VGE::ProgramID
+VGE::NullBackend::CreateProgram()
+{
+    const auto program = CreateObject(ObjectType::Program);
+    Record(CallType::CreateProgram, program, 0);
+    return program;
+}
+
+VGE::ShaderID
+VGE::NullBackend::CompileShader(const char* source, GLenum type)
+{
+    VGE_ASSERT(source, "Compiling shader without source");
+    VGE_ASSERT(type == GL_VERTEX_SHADER || type == GL_FRAGMENT_SHADER || type == GL_GEOMETRY_SHADER || type == GL_COMPUTE_SHADER,
+               "Compiling shader of unknown type: %u", type);
+
+    const auto shader = CreateObject(ObjectType::Shader);
+    mShaderSources.Insert(shader, String(source));
+    Record(CallType::CompileShader, shader, type);
+    return shader;
+}
+
+void
+VGE::NullBackend::AttachShader(ProgramID program, ShaderID shader)
+{
+    GetObject(shader, ObjectType::Shader);
+
+    auto& object = GetObject(program, ObjectType::Program);
+    VGE_ASSERT(object.ShaderCount < MaxShadersPrProgram, "Program %u already has %d shaders attached", program, object.ShaderCount);
+    VGE_ASSERT(std::find(object.Shaders, object.Shaders + object.ShaderCount, shader) == object.Shaders + object.ShaderCount,
+               "Shader %u is already attached to program %u", shader, program);
+
+    object.Shaders[object.ShaderCount++] = shader;
+    Record(CallType::AttachShader, program, shader);
+}
+
+bool
+VGE::NullBackend::LinkProgram(ProgramID program)
+{
+    auto& object = GetObject(program, ObjectType::Program);
+    object.Linked = object.ShaderCount > 0;
+    if (!object.Linked)
+        VGE_WARN("Linking program %u without any shaders", program);
+
+    Record(CallType::LinkProgram, program, object.ShaderCount);
+    return object.Linked;
+}
+
+void
+VGE::NullBackend::ReflectUniforms(ProgramID program, HashMap<StringID, Uniform>& uniforms, int (&block_sizes)[(int)UniformBlock::Count])
+{
+    const auto& object = GetObject(program, ObjectType::Program);
+    VGE_ASSERT(object.Linked, "Reflecting the uniforms of program %u, which is not linked", program);
+
+    uniforms.Clear();
+    std::fill(std::begin(block_sizes), std::end(block_sizes), 0);
+
+    for (int i = 0; i < object.ShaderCount; i++)
+    {
+        const auto source = mShaderSources.Find(object.Shaders[i]);
+        VGE_ASSERT(source, "Shader %u of program %u has been destroyed", object.Shaders[i], program);
+        local::reflect_std140(source->CStr(), uniforms, block_sizes);
+    }
+
+    Record(CallType::ReflectUniforms, program, uniforms.Size());
+}
+
+void
+VGE::NullBackend::UploadUniforms(const void* data, int size)
+{
+    VGE_ASSERT(data && size > 0, "Uploading %d bytes of uniforms", size);
+    mUniformsSize = size;
+
+    // The old ranges refer to the orphaned buffer.
+    std::fill(std::begin(mUniformRanges), std::end(mUniformRanges), 0);
+
+    Upload(mStats.UniformBytes, size);
+    Record(CallType::UploadUniforms, 0, size);
+}
+
+void
+VGE::NullBackend::BindUniforms(UniformBlock block, u32 offset, int size)
+{
+    VGE_ASSERT(block < UniformBlock::Count, "Binding uniforms to unknown block %d", (int)block);
+    VGE_ASSERT((offset & (mUniformAlignment - 1)) == 0, "Uniform offset %u is not a multiple of the alignment %d", offset, mUniformAlignment);
+    VGE_ASSERT(size > 0 && (i64)offset + size <= mUniformsSize, "Binding uniforms [%u, %u), only %d bytes were uploaded", offset, offset + size, mUniformsSize);
+
+    Bind(mUniformRanges[(int)block], ((u64)size << 32) | offset);
+    Record(CallType::BindUniforms, offset, size);
+}
+
+void
+VGE::NullBackend::BindProgram(ProgramID program)
+{
+    VGE_ASSERT(!program || GetObject(program, ObjectType::Program).Linked, "Binding program %u, which is not linked", program);
+
+    Bind(mProgram, program);
+    Record(CallType::BindProgram, program, 0);
+}
+
+void
+VGE::NullBackend::BindTexture(int unit, TextureID texture)
+{
+    VGE_ASSERT(unit >= 0 && unit < MaxTextureUnits, "Binding to texture unit %d", unit);
+    if (texture)
+        GetObject(texture, ObjectType::Texture);
+
+    Bind(mTextures[unit], texture);
+    Record(CallType::BindTexture, texture, unit);
+}
+
+void
+VGE::NullBackend::BindMesh(const MeshBuffers& mesh)
+{
+    mIndexCount = (mesh.VAO) ? GetObject(mesh.VAO, ObjectType::VertexArray).IndexCount : 0;
+    Bind(mVertexArray, mesh.VAO);
+    Record(CallType::BindMesh, mesh.VAO, 0);
+}
+
+void
+VGE::NullBackend::DrawIndexed(int index_count)
+{
+    VGE_ASSERT(mProgram, "Drawing without a program bound");
+    VGE_ASSERT(mVertexArray, "Drawing without a mesh bound");
+    VGE_ASSERT(index_count >= 0 && index_count <= mIndexCount, "Drawing %d indices from a mesh with %d", index_count, mIndexCount);
+
+    mStats.Draws++;
+    mStats.Indices += index_count;
+    Record(CallType::DrawIndexed, (u32)mVertexArray, index_count);
+}
+
+void
+VGE::NullBackend::DrawLines(const void* vertices, int vertex_count, int vertex_size)
+{
+    const auto bytes = (i64)vertex_count * vertex_size;
+    VGE_ASSERT((vertex_count & 1) == 0, "Drawing lines from an odd number of vertices: %d", vertex_count);
+    VGE_ASSERT(vertices || vertex_count == 0, "Drawing %d line vertices without data", vertex_count);
+    VGE_ASSERT(bytes <= mImmediateSize, "Trying to draw %lld bytes of lines, the buffer only holds %d", (long long)bytes, mImmediateSize);
+
+    mStats.Draws++;
+    mStats.LineVertices += vertex_count;
+    Upload(mStats.ImmediateBytes, bytes);
+    Record(CallType::DrawLines, 0, vertex_count);
+}
+
+u32
+VGE::NullBackend::CreateObject(ObjectType type)
+{
+    const auto name = mNextName++;
+    mObjects.Insert(name, Object{type, 0, false, 0, {}});
+    return name;
+}
+
+VGE::NullBackend::Object&
+VGE::NullBackend::GetObject(u32 name, ObjectType type)
+{
+    auto object = mObjects.Find(name);
+    VGE_ASSERT(object, "Object %u does not exist, it was never created or has been destroyed", name);
+    VGE_ASSERT(object->Type == type, "Object %u is a %d, not a %d", name, (int)object->Type, (int)type);
+    return *object;
+}
+
+void
+VGE::NullBackend::DestroyObject(u32 name, ObjectType type)
+{
+    // Like glDelete*, deleting name 0 does nothing.
+    if (!name)
+        return;
+
+    GetObject(name, type);
+    mObjects.Remove(name);
+    mShaderSources.Remove(name);
+}
+
+void
+VGE::NullBackend::Record(CallType type, u32 object, i64 value)
+{
+    mStats.Calls[(int)type]++;
+    if (mRecordCalls)
+        mCalls.PushBack({type, object, value});
+}
+
+void
+VGE::NullBackend::Upload(i64& counter, i64 bytes)
+{
+    counter += bytes;
+    mStats.UploadedBytes += bytes;
+}
+
+void
+VGE::NullBackend::Bind(u64& bound, u64 object)
+{
+    if (bound == object)
+    {
+        mStats.RedundantBinds++;
+        return;
+    }
+
+    bound = object;
+    mStats.StateChanges++;
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <vge_gfx_backend.h>
+#include <vge_array.h>
+
+namespace VGE
+{
+    // A backend without a GPU, for running scenes headless in tests and benchmarks.
+    // Objects are only names in a table, so every call can be validated: using an object that was never created
+    // (or has been destroyed) asserts, as does drawing without a linked program and a mesh bound,
+    // or binding uniforms outside of what was uploaded.
+    // Counts every call, the bytes that would have been uploaded and the binds that changed state,
+    // and can record the calls themselves for tests that care about the order.
+    // The PerFrame and PerDraw blocks are laid out from the shader source with the std140 rules,
+    // so GetUniform and SetUniform behave as they do with OpenGL.
+    class NullBackend
+        : public GFXBackend
+    {
+    public:
+        enum class CallType : u8
+        {
+            CreateMesh,
+            DestroyMesh,
+            CreateTexture,
+            CreateProgram,
+            CompileShader,
+            AttachShader,
+            LinkProgram,
+            ReflectUniforms,
+            UploadUniforms,
+            BindUniforms,
+            BindProgram,
+            BindTexture,
+            BindMesh,
+            DrawIndexed,
+            DrawLines,
+            Count
+        };
+
+        struct Call
+        {
+            CallType Type;
+            u32 Object; // The object the call was about, 0 if none.
+            i64 Value; // Bytes uploaded, indices or vertices drawn, or the texture unit bound.
+        };
+
+        struct Stats
+        {
+            i64 Calls[(int)CallType::Count];
+            i64 UploadedBytes; // All of the below
+            i64 MeshBytes;
+            i64 TextureBytes;
+            i64 UniformBytes;
+            i64 ImmediateBytes;
+            i64 StateChanges; // Binds that changed what was bound
+            i64 RedundantBinds; // Binds of what was already bound
+            i64 Draws;
+            i64 Indices;
+            i64 LineVertices;
+        };
+
+        NullBackend(int uniform_alignment = 256, Allocator& allocator = *GetDefaultAllocator());
+
+        // Off by default, so benchmarks only pay for the counting.
+        void RecordCalls(bool record);
+        const Array<Call>& Calls() const;
+
+        const Stats& GetStats() const;
+
+        // Clears the stats and the recorded calls, the objects and bound state are kept.
+        void ResetStats();
+
+        // Objects created and not yet destroyed.
+        int ObjectCount() const;
+
+        static const char* CallName(CallType type);
+
+        virtual const char* Name() const override;
+        virtual void Init(int immediate_size) override;
+        virtual int UniformBufferAlignment() const override;
+
+        virtual MeshBuffers CreateMesh(const MeshData& data) override;
+        virtual void DestroyMesh(const MeshBuffers& mesh) override;
+
+        virtual TextureID CreateTexture(const void* pixels, int width, int height, int channels) override;
+
+        virtual ProgramID CreateProgram() override;
+        virtual ShaderID CompileShader(const char* source, GLenum type) override;
+        virtual void AttachShader(ProgramID program, ShaderID shader) override;
+        virtual bool LinkProgram(ProgramID program) override;
+        virtual void ReflectUniforms(ProgramID program, HashMap<StringID, Uniform>& uniforms, int (&block_sizes)[(int)UniformBlock::Count]) override;
+
+        virtual void UploadUniforms(const void* data, int size) override;
+        virtual void BindUniforms(UniformBlock block, u32 offset, int size) override;
+
+        virtual void BindProgram(ProgramID program) override;
+        virtual void BindTexture(int unit, TextureID texture) override;
+        virtual void BindMesh(const MeshBuffers& mesh) override;
+        virtual void DrawIndexed(int index_count) override;
+        virtual void DrawLines(const void* vertices, int vertex_count, int vertex_size) override;
+
+        static constexpr auto MaxTextureUnits = 16;
+        static constexpr auto MaxShadersPrProgram = 4;
+
+    private:
+        enum class ObjectType : u8
+        {
+            VertexArray,
+            Buffer,
+            Texture,
+            Program,
+            Shader,
+        };
+
+        struct Object
+        {
+            ObjectType Type;
+            int IndexCount; // Vertex arrays
+            bool Linked; // Programs
+            int ShaderCount;
+            u32 Shaders[MaxShadersPrProgram];
+        };
+
+        u32 CreateObject(ObjectType type);
+        Object& GetObject(u32 name, ObjectType type);
+        void DestroyObject(u32 name, ObjectType type);
+
+        void Record(CallType type, u32 object, i64 value);
+        void Upload(i64& counter, i64 bytes);
+        void Bind(u64& bound, u64 object);
+
+        HashMap<u32, Object> mObjects;
+        HashMap<u32, String> mShaderSources;
+        u32 mNextName{1};
+
+        Array<Call> mCalls;
+        bool mRecordCalls{};
+        Stats mStats{};
+
+        int mUniformAlignment;
+        int mImmediateSize{};
+        int mUniformsSize{}; // Bytes in the uniform buffer
+
+        // Bound state, 0 being nothing
+        u64 mProgram{};
+        u64 mVertexArray{};
+        int mIndexCount{}; // Of the bound vertex array
+        u64 mTextures[MaxTextureUnits]{};
+        u64 mUniformRanges[(int)UniformBlock::Count]{}; // Size in the high 32 bits, offset in the low
+    };
+}
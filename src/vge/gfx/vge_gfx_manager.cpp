@@ -7,24 +7,28 @@
 #include <sstream>
 #include <string>
 #include <vge_array.h>
+#include <vge_slot_map.h>
+#include <vge_hash_map.h>
 
 #include <glm/gtc/type_ptr.hpp>
 
 #include <imgui.h>
 #include <stb_image.h>
 
+namespace local
+{
+    // Resolves a typed handle in constant time, nullptr if the resource has been destroyed.
+    template<class T, class Tag>
+    T*
+    lookup(VGE::SlotMap<T>& table, VGE::ResourceHandle<Tag> handle)
+    {
+        return table[{handle.idx, handle.gen}];
+    }
+}
+
 /////////////////////////////////////////////////
 /// Mesh Related
 /////////////////////////////////////////////////
-struct mesh_gl_data
-{
-    GLuint VAO;
-    GLuint VBO;
-    GLuint EBO;
-    GLuint uv0TBO;
-    GLuint uv1TBO;
-};
-
 // TODO: Need a more efficient way to store this data, the meta data is only
 // needed for imgui, so no need to store it with the rest.
 // Similarly, only the VAO is needed when drawing, so shouldn't store that
@@ -33,77 +37,63 @@ struct mesh_info
 {
     VGE::MeshHandle handle;
     VGE::MeshData mesh_data;
-    mesh_gl_data gl_data;
+    VGE::MeshBuffers buffers;
 };
 
-static VGE::Array<mesh_info> g_mesh_table;
-static VGE::MeshHandle g_new_mesh_handle;
+static VGE::SlotMap<mesh_info> g_mesh_table;
 
 VGE::MeshHandle
 VGE::GFXManager::CreateMesh()
 {
-    auto NewPair = mesh_info();
-    NewPair.handle = g_new_mesh_handle++;
-    g_mesh_table.PushBack(NewPair);
-    return NewPair.handle;
+    const auto slot = g_mesh_table.Insert(mesh_info());
+    const auto handle = MeshHandle{slot.idx, slot.gen};
+    g_mesh_table[slot]->handle = handle;
+    return handle;
 }
 
 void
-VGE::GFXManager::SetMesh(MeshHandle handle,
-                         MeshData data)
+VGE::GFXManager::DestroyMesh(MeshHandle handle)
 {
-    auto itr = std::find_if(g_mesh_table.Begin(), g_mesh_table.End(),
-                            [=](const auto& item)
-                            { return item.handle == handle; });
-
-    if (itr == g_mesh_table.End())
+    auto mesh = local::lookup(g_mesh_table, handle);
+    if (!mesh)
     {
-        VGE_WARN("Handle %d not found", handle);
+        VGE_WARN("Handle %d (generation %d) not found", handle.idx, handle.gen);
         return;
     }
 
-    if (!itr->mesh_data.name.empty())
-    {
-        // Destroy OpenGL stuff
-    }
-
-    itr->mesh_data = data;
-    mesh_gl_data new_data;
-
-    glGenVertexArrays(1, &new_data.VAO);
-    glBindVertexArray(new_data.VAO); // Bind VAO to start "recording" binding calls
-
-    glGenBuffers(1, &new_data.EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, new_data.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * data.triangle_count, data.triangles, GL_STATIC_DRAW);
+    if (mesh->buffers.VAO)
+        mBackend->DestroyMesh(mesh->buffers);
 
-    glGenBuffers(1, &new_data.VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, new_data.VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * data.vertex_count, data.vertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    g_mesh_table.Remove({handle.idx, handle.gen});
+}
 
-    glGenBuffers(1, &new_data.uv0TBO);
-    glBindBuffer(GL_ARRAY_BUFFER, new_data.uv0TBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2) * data.vertex_count, data.uv0, GL_STATIC_DRAW);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
+void
+VGE::GFXManager::SetMesh(MeshHandle handle,
+                         MeshData data)
+{
+    auto itr = local::lookup(g_mesh_table, handle);
+    if (!itr)
+    {
+        VGE_WARN("Handle %d (generation %d) not found", handle.idx, handle.gen);
+        return;
+    }
 
-    glBindVertexArray(0); // Unbind VAO to avoid messing it up by binding other stuff.
+    if (itr->buffers.VAO)
+        mBackend->DestroyMesh(itr->buffers);
 
-    itr->gl_data = new_data;
+    itr->mesh_data = data;
+    itr->buffers = mBackend->CreateMesh(data);
 }
 
 // TODO: This should be assumed to be async.
 void
 VGE::GFXManager::DrawMesh(VGE::MeshHandle handle)
 {
-    auto itr = std::find_if(g_mesh_table.Begin(), g_mesh_table.End(),
-                            [=](const auto& item)
-                            { return item.handle == handle; });
+    auto itr = local::lookup(g_mesh_table, handle);
+    VGE_ASSERT(itr, "Drawing destroyed mesh, handle %d (generation %d)", handle.idx, handle.gen);
 
-    glBindVertexArray(itr->gl_data.VAO);
-    glDrawElements(GL_TRIANGLES, itr->mesh_data.triangle_count, GL_UNSIGNED_INT, 0);
+    mBackend->BindMesh(itr->buffers);
+    mBackend->DrawIndexed(itr->mesh_data.triangle_count);
 }
 
 ///////////////////////////////////////////////////////////
@@ -115,39 +105,30 @@ struct texture_info
     VGE::TextureID texture_id;
 
     // TODO: Move this extended information into different places to make better use of cache etc.
-    std::string filepath;
+    VGE::StringID filepath;
 
     int width;
     int height;
 };
 
-static VGE::TextureHandle g_new_texture_handle;
-static VGE::Array<texture_info> g_texture_table;
+static VGE::SlotMap<texture_info> g_texture_table;
 
 namespace local::texture
 {
     texture_info*
     get_texture(VGE::TextureHandle handle)
     {
-        auto itr = std::find_if(g_texture_table.Begin(),
-                                g_texture_table.End(),
-                                [=](const auto& item)
-                                { return item.handle == handle; });
-
-        return (itr != g_texture_table.End())
-                   ? &(*itr)
-                   : nullptr;
+        return local::lookup(g_texture_table, handle);
     }
 }
 
 VGE::TextureHandle
 VGE::GFXManager::CreateTexture()
 {
-    g_texture_table.PushBack({});
-    auto& texture = g_texture_table.Back();
-    //auto& texture = g_texture_table.emplace_back();
-    texture.handle = g_new_texture_handle++;
-    return texture.handle;
+    const auto slot = g_texture_table.Insert({});
+    const auto handle = TextureHandle{slot.idx, slot.gen};
+    g_texture_table[slot]->handle = handle;
+    return handle;
 }
 
 void
@@ -155,6 +136,7 @@ VGE::GFXManager::LoadTexture(VGE::TextureHandle handle,
                                const char* filepath)
 {
     auto texture = local::texture::get_texture(handle);
+    VGE_ASSERT(texture, "Did not find texture with handle: %d (generation %d)", handle.idx, handle.gen);
 
     int width;
     int height;
@@ -165,22 +147,11 @@ VGE::GFXManager::LoadTexture(VGE::TextureHandle handle,
     if (!data)
         VGE_ERROR("Could not load image: %s, %s", filepath, stbi_failure_reason());
 
-    texture->filepath = filepath;
+    texture->filepath = VGE::StringID(filepath);
     texture->width = width;
     texture->height = height;
 
-    glGenTextures(1, &texture->texture_id);
-    glBindTexture(GL_TEXTURE_2D, texture->texture_id);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    const auto fmt = (channels < 4) ? GL_RGB : GL_RGBA;
-
-    glTexImage2D(GL_TEXTURE_2D, 0, fmt, width, height, 0, fmt, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    texture->texture_id = mBackend->CreateTexture(data, width, height, channels);
 
     stbi_image_free(data);
 }
@@ -188,7 +159,9 @@ VGE::GFXManager::LoadTexture(VGE::TextureHandle handle,
 VGE::TextureID
 VGE::GFXManager::GetTextureID(VGE::TextureHandle handle)
 {
-    return local::texture::get_texture(handle)->texture_id;
+    auto texture = local::texture::get_texture(handle);
+    VGE_ASSERT(texture, "Did not find texture with handle: %d (generation %d)", handle.idx, handle.gen);
+    return texture->texture_id;
 }
 
 ///////////////////////////////////////////////////////////
@@ -198,6 +171,10 @@ struct program
 {
     VGE::ShaderHandle handle;
     VGE::ProgramID program_id;
+
+    // Filled in when linking, from uniform name to where it lives in the uniform blocks.
+    VGE::HashMap<VGE::StringID, VGE::Uniform> uniforms;
+    int block_sizes[(int)VGE::UniformBlock::Count]{};
 };
 
 struct shader_source
@@ -205,14 +182,14 @@ struct shader_source
     GLuint shader_id;
 
     GLenum type;
-    char file[128];
+    VGE::String file;
     char source[1024 * 16];
 };
 
-static VGE::Array<program> g_program_table;
-static VGE::ShaderHandle g_new_program_handle;
+static VGE::SlotMap<program> g_program_table;
 
 static VGE::Array<shader_source> g_shader_source_table;
+static VGE::HashMap<GLuint, int> g_shader_source_lookup; // From shader id to index in g_shader_source_table
 
 namespace local::shader
 {
@@ -249,45 +226,18 @@ namespace local::shader
         std::fclose(file);
     }
 
-    GLuint
-    compile_shader(const char* src, GLenum type)
-    {
-        auto shader = glCreateShader(type);
-        glShaderSource(shader, 1, &src, NULL);
-        glCompileShader(shader);
-
-        int success;
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-        if (!success)
-        {
-            GLchar info_log[512];
-            glGetShaderInfoLog(shader, 512, NULL, info_log);
-            VGE_WARN("%s", info_log);
-        }
-        return shader;
-    }
-
     program*
     get_shader(VGE::ShaderHandle handle)
     {
-        auto itr = std::find_if(g_program_table.Begin(), g_program_table.End(),
-                                [=](const auto& item)
-                                { return item.handle == handle; });
-
-        return (itr != g_program_table.End())
-                    ? &(*itr)
-                    : nullptr;
+        return local::lookup(g_program_table, handle);
     }
 
     shader_source*
     get_shader_source(GLuint shader_id)
     {
-        auto itr = std::find_if(g_shader_source_table.Begin(), g_shader_source_table.End(),
-                                [=](const auto& item)
-                                { return item.shader_id == shader_id; });
-
-        return (itr != g_shader_source_table.End())
-                    ? &(*itr)
+        const auto idx = g_shader_source_lookup.Find(shader_id);
+        return (idx)
+                    ? &g_shader_source_table[*idx]
                     : nullptr;
     }
 } // namespace local::shader
@@ -296,11 +246,12 @@ VGE::ShaderHandle
 VGE::GFXManager::CreateShader()
 {
     auto new_data = program();
-    new_data.handle = g_new_program_handle++;
-    new_data.program_id = glCreateProgram();
-    g_program_table.PushBack(new_data);
+    new_data.program_id = mBackend->CreateProgram();
+    const auto slot = g_program_table.Insert(std::move(new_data));
+    const auto handle = ShaderHandle{slot.idx, slot.gen};
+    g_program_table[slot]->handle = handle;
 
-    return new_data.handle;
+    return handle;
 }
 
 void
@@ -312,60 +263,151 @@ VGE::GFXManager::AttachShader(VGE::ShaderHandle handle,
 
     shader_source tmp;
     tmp.type = type;
-    std::strcpy(tmp.file, filepath);
+    tmp.file = filepath;
     local::shader::load_source(filepath, tmp.source, sizeof(tmp.source));
-    tmp.shader_id = local::shader::compile_shader(tmp.source, type);
+    tmp.shader_id = mBackend->CompileShader(tmp.source, type);
+    g_shader_source_lookup.Insert(tmp.shader_id, g_shader_source_table.Size());
     g_shader_source_table.PushBack(tmp);
 
     auto program = local::shader::get_shader(handle);
-    VGE_ASSERT(program, "Did not find program with handle: %d", handle);
+    VGE_ASSERT(program, "Did not find program with handle: %d (generation %d)", handle.idx, handle.gen);
 
-    glAttachShader(program->program_id, tmp.shader_id);
+    mBackend->AttachShader(program->program_id, tmp.shader_id);
 }
 
 void
 VGE::GFXManager::CompileAndLinkShader(ShaderHandle handle)
 {
     auto program = local::shader::get_shader(handle);
-    VGE_ASSERT(program, "Did not find program with handle: %d", handle);
-    glLinkProgram(program->program_id);
+    VGE_ASSERT(program, "Did not find program with handle: %d (generation %d)", handle.idx, handle.gen);
+    if (!mBackend->LinkProgram(program->program_id))
+        return;
 
-    int success;
-    glGetProgramiv(program->program_id, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        GLchar info_log[512];
-        glGetProgramInfoLog(program->program_id, 512, nullptr, info_log);
-        VGE_WARN("%s", info_log);
-    }
+    mBackend->ReflectUniforms(program->program_id, program->uniforms, program->block_sizes);
+    mFrameUniformsSize = std::max(mFrameUniformsSize, program->block_sizes[(int)UniformBlock::Frame]);
 }
 
 VGE::ProgramID
 VGE::GFXManager::GetShaderID(VGE::ShaderHandle handle)
 {
     auto program = local::shader::get_shader(handle);
-    VGE_ASSERT(program, "Did not find program with handle: %d", handle);
+    VGE_ASSERT(program, "Did not find program with handle: %d (generation %d)", handle.idx, handle.gen);
     return program->program_id;
 }
 
+///////////////////////////////////////////////////////////
+/// Uniform Related
+///////////////////////////////////////////////////////////
+VGE::Uniform
+VGE::GFXManager::GetUniform(ShaderHandle handle, const char* name)
+{
+    auto program = local::shader::get_shader(handle);
+    VGE_ASSERT(program, "Did not find program with handle: %d (generation %d)", handle.idx, handle.gen);
+
+    if (auto uniform = program->uniforms.Find(StringID(name)))
+        return *uniform;
+
+    VGE_WARN("Uniform %s is not in a uniform block of shader %d (generation %d)", name, handle.idx, handle.gen);
+    return {};
+}
+
+u32
+VGE::GFXManager::AllocateDrawUniforms(ShaderHandle handle)
+{
+    auto program = local::shader::get_shader(handle);
+    VGE_ASSERT(program, "Did not find program with handle: %d (generation %d)", handle.idx, handle.gen);
+
+    const auto size = program->block_sizes[(int)UniformBlock::Draw];
+    return (size > 0) ? mCommandBuffers.ThisThread().AllocateUniforms(size) : NoUniforms;
+}
+
+u32
+VGE::GFXManager::FrameUniforms()
+{
+    // Lives in the buffer of the main thread, which is merged first, so the offset stays the same after merging.
+    VGE_ASSERT(Thread::ThisThread::ID() == 0, "The PerFrame uniforms can only be set from the main thread, not thread %d", Thread::ThisThread::ID());
+    if (mFrameUniforms == NoUniforms && mFrameUniformsSize > 0)
+        mFrameUniforms = mCommandBuffers.Buffer(0).AllocateUniforms(mFrameUniformsSize);
+
+    return mFrameUniforms;
+}
+
+void
+VGE::GFXManager::SetUniform(u32 block, const Uniform& uniform, int value)
+{
+    WriteUniform(block, uniform, GL_INT, &value, sizeof(value));
+}
+
+void
+VGE::GFXManager::SetUniform(u32 block, const Uniform& uniform, float value)
+{
+    WriteUniform(block, uniform, GL_FLOAT, &value, sizeof(value));
+}
+
+void
+VGE::GFXManager::SetUniform(u32 block, const Uniform& uniform, const glm::vec2& value)
+{
+    WriteUniform(block, uniform, GL_FLOAT_VEC2, &value, sizeof(value));
+}
+
+void
+VGE::GFXManager::SetUniform(u32 block, const Uniform& uniform, const glm::vec3& value)
+{
+    WriteUniform(block, uniform, GL_FLOAT_VEC3, &value, sizeof(value));
+}
+
+void
+VGE::GFXManager::SetUniform(u32 block, const Uniform& uniform, const glm::vec4& value)
+{
+    WriteUniform(block, uniform, GL_FLOAT_VEC4, &value, sizeof(value));
+}
+
+void
+VGE::GFXManager::SetUniform(u32 block, const Uniform& uniform, const glm::mat4& value)
+{
+    WriteUniform(block, uniform, GL_FLOAT_MAT4, &value, sizeof(value));
+}
+
+void
+VGE::GFXManager::WriteUniform(u32 block, const Uniform& uniform, GLenum type, const void* data, int size)
+{
+    VGE_ASSERT(!uniform.Valid() || uniform.Type == type, "Writing a %s to a uniform of type %s", GFX::GLEnumToString(type), GFX::GLEnumToString(uniform.Type));
+    mCommandBuffers.ThisThread().WriteUniform(block, uniform, data, size);
+}
+
+// One upload for all the uniforms of the frame.
+void
+VGE::GFXManager::UploadUniforms(const StaticFrame& frame)
+{
+    const auto& uniforms = frame.Uniforms;
+    if (uniforms.Size() == 0)
+        return;
+
+    mBackend->UploadUniforms(uniforms.Data(), uniforms.Size());
+
+    if (frame.FrameUniforms != NoUniforms)
+        mBackend->BindUniforms(UniformBlock::Frame, frame.FrameUniforms, mFrameUniformsSize);
+}
+
 ///////////////////////////////////////////////////////////
 /// New and Dynamic Drawing
 ///////////////////////////////////////////////////////////
 void
-VGE::GFXManager::Init()
+VGE::GFXManager::Init(GFXBackend& backend)
 {
-    glGenVertexArrays(1, &mDynamicVAO);
-    glBindVertexArray(mDynamicVAO);
+    mBackend = &backend;
+    mBackend->Init(DynamicVBOSize);
 
-    glCreateBuffers(1, &mDynamicVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, mDynamicVBO);
-    glBufferData(GL_ARRAY_BUFFER, DynamicVBOSize, nullptr, GL_STREAM_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)0);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
+    const auto alignment = mBackend->UniformBufferAlignment();
+    for (auto& frame : mStaticFrames)
+        frame.Uniforms.SetAlignment(alignment);
+    mCommandBuffers.SetAlignment(alignment);
+}
 
-    glBindVertexArray(0);
+void
+VGE::GFXManager::Shutdown()
+{
+    mBackend = nullptr;
 }
 
 void
@@ -383,12 +425,7 @@ VGE::GFXManager::DrawLine(glm::vec3 begin, glm::vec3 end, Color color)
 void
 VGE::GFXManager::RenderImmediate()
 {
-    auto buffer = glMapNamedBuffer(mDynamicVBO, GL_WRITE_ONLY);
-    std::memcpy(buffer, mDynamicVertices, mDynamicVerticesCount * sizeof(Vertex));
-    glUnmapNamedBuffer(mDynamicVBO);
-    glBindVertexArray(mDynamicVAO);
-    glDrawArrays(GL_LINES, 0, mDynamicVerticesCount);
-    glBindVertexArray(0);
+    mBackend->DrawLines(mDynamicVertices, mDynamicVerticesCount, sizeof(Vertex));
 
     mDynamicVerticesCount = 0;
 }
@@ -396,14 +433,89 @@ VGE::GFXManager::RenderImmediate()
 void
 VGE::GFXManager::SubmitStaticDrawCommand(const StaticDrawCommand& command)
 {
-    VGE_ASSERT(mStaticCommandsCount < (int)MaxStaticDrawCommands, "Trying to add to many static draw commands");
-    //mStaticCommands[mStaticCommandsCount++] = command;
+    mCommandBuffers.ThisThread().Submit(command);
+}
+
+namespace local
+{
+    void
+    bind_texture(VGE::GFXBackend& backend, int unit, VGE::TextureHandle handle)
+    {
+        if (handle.idx < 0)
+        {
+            backend.BindTexture(unit, 0);
+            return;
+        }
+
+        auto texture = local::texture::get_texture(handle);
+        VGE_ASSERT(texture, "Drawing with destroyed texture, handle %d (generation %d)", handle.idx, handle.gen);
+        backend.BindTexture(unit, texture->texture_id);
+    }
 }
 
 void
-VGE::GFXManager::RenderStatic()
+VGE::GFXManager::SubmitStatic(int slot)
 {
+    VGE_ASSERT(slot >= 0 && slot < RenderThread::FrameCount, "No static frame slot %d", slot);
+    VGE_ASSERT(Thread::ThisThread::ID() == 0, "Static frames can only be submitted from the main thread, not thread %d", Thread::ThisThread::ID());
 
+    auto& frame = mStaticFrames[slot];
+    VGE_ASSERT(frame.Queue.Size() == 0 && frame.Uniforms.Size() == 0, "Static frame slot %d has not been rendered yet", slot);
+
+    // The PerFrame block lives in the buffer of the main thread, which is merged first, so its offset stays the same.
+    mCommandBuffers.Merge(frame.Queue, frame.Uniforms);
+    frame.FrameUniforms = mFrameUniforms;
+    mFrameUniforms = NoUniforms;
+}
+
+void
+VGE::GFXManager::RenderStatic(int slot)
+{
+    VGE_ASSERT(slot >= 0 && slot < RenderThread::FrameCount, "No static frame slot %d", slot);
+
+    auto& frame = mStaticFrames[slot];
+    auto& queue = frame.Queue;
+    queue.Sort();
+    UploadUniforms(frame);
+
+    const program* shader = nullptr;
+    const mesh_info* mesh = nullptr;
+    for (int i = 0; i < queue.Size(); i++)
+    {
+        const auto& command = queue.Command(i);
+        const auto changes = queue.Changes(i);
+
+        if (changes & RenderQueue::ChangeShader)
+        {
+            shader = local::shader::get_shader(command.Shader);
+            VGE_ASSERT(shader, "Drawing with destroyed shader, handle %d (generation %d)", command.Shader.idx, command.Shader.gen);
+            mBackend->BindProgram(shader->program_id);
+        }
+
+        if (changes & RenderQueue::ChangeTextures)
+        {
+            local::bind_texture(*mBackend, 0, command.UV0);
+            local::bind_texture(*mBackend, 1, command.UV1);
+        }
+
+        if (changes & RenderQueue::ChangeMesh)
+        {
+            mesh = local::lookup(g_mesh_table, command.Mesh);
+            VGE_ASSERT(mesh, "Drawing destroyed mesh, handle %d (generation %d)", command.Mesh.idx, command.Mesh.gen);
+            mBackend->BindMesh(mesh->buffers);
+        }
+
+        if (command.Uniforms != NoUniforms)
+            mBackend->BindUniforms(UniformBlock::Draw, command.Uniforms, shader->block_sizes[(int)UniformBlock::Draw]);
+
+        mBackend->DrawIndexed(mesh->mesh_data.triangle_count);
+    }
+
+    mBackend->BindMesh({});
+    queue.Clear();
+    frame.Uniforms.Reset();
+    frame.FrameUniforms = NoUniforms;
+    mLastRenderedSlot = slot;
 }
 
 ///////////////////////////////////////////////////////////
@@ -529,22 +641,22 @@ VGE::GFXManager::DrawDebug()
             for (int i = 0; i < g_mesh_table.Size(); i++)
             {
                 const auto& mesh = g_mesh_table[i];
-                char buffer[32];
-                std::sprintf(buffer, "Handle: %d", mesh.handle);
+                char buffer[48];
+                std::sprintf(buffer, "Handle: %d (generation %d)", mesh.handle.idx, mesh.handle.gen);
                 ImGui::PushID(buffer);
                 if (ImGui::CollapsingHeader(buffer))
                 {
-                    ImGui::Text("name: %s", mesh.mesh_data.name.c_str());
+                    ImGui::Text("name: %s", mesh.mesh_data.name.CStr());
                     ImGui::Text("vertex_count: %d", mesh.mesh_data.vertex_count);
                     ImGui::Text("triangle_count: %d", mesh.mesh_data.triangle_count);
 
                     if (ImGui::TreeNode("GLData"))
                     {
-                        ImGui::Text("VAO: %u", mesh.gl_data.VAO);
-                        ImGui::Text("VBO: %u", mesh.gl_data.VBO);
-                        ImGui::Text("EBO: %u", mesh.gl_data.EBO);
-                        ImGui::Text("uv0TBO: %u", mesh.gl_data.uv0TBO);
-                        ImGui::Text("uv0TB1: %u", mesh.gl_data.uv1TBO);
+                        ImGui::Text("VAO: %u", mesh.buffers.VAO);
+                        ImGui::Text("VBO: %u", mesh.buffers.VBO);
+                        ImGui::Text("EBO: %u", mesh.buffers.EBO);
+                        ImGui::Text("uv0TBO: %u", mesh.buffers.uv0TBO);
+                        ImGui::Text("uv0TB1: %u", mesh.buffers.uv1TBO);
 
                         ImGui::TreePop();
                     }
@@ -610,8 +722,8 @@ VGE::GFXManager::DrawDebug()
             for (int i = 0; i < g_program_table.Size(); i++)
             {
                 const auto& program = g_program_table[i];
-                char buffer[32];
-                std::sprintf(buffer, "Handle: %d", program.handle);
+                char buffer[48];
+                std::sprintf(buffer, "Handle: %d (generation %d)", program.handle.idx, program.handle.gen);
                 if (ImGui::CollapsingHeader(buffer))
                 {
                     ImGui::Indent();
@@ -634,6 +746,15 @@ VGE::GFXManager::DrawDebug()
                             glGetActiveUniform(program.program_id, j, max_name_length, nullptr, &ignored, &type, name);
 
                             const auto location = glGetUniformLocation(program.program_id, name);
+                            if (location < 0)
+                            {
+                                // Lives in a uniform block, and is rewritten every frame anyway.
+                                ImGui::Indent();
+                                ImGui::Text("%s %s (uniform block)", GFX::GLEnumToString(type), name);
+                                ImGui::Unindent();
+                                continue;
+                            }
+
                             ImGui::Indent();
                             ImGui::PushID(j);
                             ImGui::PushItemWidth(-1.0f);
@@ -721,11 +842,11 @@ VGE::GFXManager::DrawDebug()
             {
                 const auto& texture = g_texture_table[i];
                 char buffer[128];
-                std::sprintf(buffer, "Handle: %d", texture.handle);
+                std::sprintf(buffer, "Handle: %d (generation %d)", texture.handle.idx, texture.handle.gen);
                 if (ImGui::CollapsingHeader(buffer))
                 {
                     std::sprintf(buffer, "Texture id: %u, width: %d, height: %d, filepath: %s",
-                                 texture.texture_id, texture.width, texture.height, texture.filepath.c_str());
+                                 texture.texture_id, texture.width, texture.height, texture.filepath.CStr());
 
                     if (ImGui::TreeNode(buffer))
                     {
@@ -738,6 +859,16 @@ VGE::GFXManager::DrawDebug()
             ImGui::EndTabItem();
         }
 
+        if (ImGui::BeginTabItem("Render Queue"))
+        {
+            const auto& stats = mStaticFrames[mLastRenderedSlot].Queue.GetStats();
+            ImGui::Text("Draws: %d", stats.Draws);
+            ImGui::Text("Shader binds: %d (avoided %d)", stats.ShaderBinds, stats.AvoidedShaderBinds);
+            ImGui::Text("Texture binds: %d (avoided %d)", stats.TextureBinds, stats.AvoidedTextureBinds);
+            ImGui::Text("Mesh binds: %d (avoided %d)", stats.MeshBinds, stats.AvoidedMeshBinds);
+            ImGui::EndTabItem();
+        }
+
         if (ImGui::BeginTabItem("Settings"))
         {
             static bool mode = false;
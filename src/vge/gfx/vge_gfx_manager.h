@@ -5,7 +5,13 @@
 #include <glm/glm.hpp>
 #include <vge_color.h>
 #include <vge_draw_cmd.h>
+#include <vge_command_buffer.h>
+#include <vge_render_queue.h>
+#include <vge_render_thread.h>
+#include <vge_uniform_arena.h>
 #include <vge_gfx_types.h>
+#include <vge_gfx_backend.h>
+#include <vge_gfx_backend_gl.h>
 
 namespace VGE
 {
@@ -13,7 +19,11 @@ namespace VGE
     // I do actually hold some data. And might want to expose that for testing purposes.
     struct GFXManager
     {
-        void Init();
+        // Everything goes through the backend from here on, pass a NullBackend to run without a GPU.
+        void Init(GFXBackend& backend = gGLBackend);
+
+        // Lets go of the backend, nothing may be drawn or created until the next Init.
+        void Shutdown();
 
         // Mesh Related
         MeshHandle CreateMesh();
@@ -35,15 +45,33 @@ namespace VGE
         void CompileAndLinkShader(ShaderHandle handle);
         ProgramID GetShaderID(ShaderHandle handle);
 
+        // Uniform related
+        // Uniforms live in the PerFrame and PerDraw blocks of the shaders, and are written to a uniform arena that is
+        // uploaded to a uniform buffer once pr frame. Where each uniform lives is resolved when the shader is linked.
+        // Blocks are allocated from the command buffer of the calling thread, and have to be written by that same thread.
+        // Looks up where a uniform lives in the shader, do this once rather than pr draw.
+        Uniform GetUniform(ShaderHandle handle, const char* name);
+
+        // Reserves the PerDraw block of the shader for this frame, the offset goes in StaticDrawCommand::Uniforms.
+        u32 AllocateDrawUniforms(ShaderHandle handle);
+
+        // The PerFrame block of this frame, shared by all draws. Main thread only.
+        u32 FrameUniforms();
+
+        void SetUniform(u32 block, const Uniform& uniform, int value);
+        void SetUniform(u32 block, const Uniform& uniform, float value);
+        void SetUniform(u32 block, const Uniform& uniform, const glm::vec2& value);
+        void SetUniform(u32 block, const Uniform& uniform, const glm::vec3& value);
+        void SetUniform(u32 block, const Uniform& uniform, const glm::vec4& value);
+        void SetUniform(u32 block, const Uniform& uniform, const glm::mat4& value);
+
         // Debugging
+        // Inspects the OpenGL objects directly, so only works with the GLBackend.
         void DrawDebug();
 
-        // Should have some sort of shutdown function?
+        GFXBackend* mBackend{};
 
         // TOOD: Need to create some sort of "immediate mode" layer. For directly drawing vertices.
-        GLuint mDynamicVBO;
-        GLuint mDynamicVAO;
-
         struct Vertex
         {
             glm::vec3 position;
@@ -60,18 +88,39 @@ namespace VGE
         // TODO: Move to a commit based system.
         // You can commit mesh drawings, or dynamic vertices.
         // You also commit the shaders and settings you want to use.
+        // Not double buffered, so with a render thread both have to be called from the render thread.
         void DrawLine(glm::vec3 begin, glm::vec3 end, Color color);
         void RenderImmediate();
 
+        // Records into the command buffer of the calling thread, so draws can be generated from any number of jobs at once.
+        // Needs no GL context, only RenderStatic does.
         void SubmitStaticDrawCommand(const StaticDrawCommand& command);
 
-        // Will start thread in future. After this point, don't submit more static draw commands!
-        void RenderStatic();
+        // Main thread only, no GL involved. Merges the command buffers of all threads into a frame slot (see VGE::RenderThread),
+        // which can then be drawn by the render thread while the next frame is recorded into the other slot.
+        void SubmitStatic(int slot);
+
+        // On the thread owning the GL context. Sorts the commands of a submitted frame slot and draws them,
+        // skipping the program, VAO and texture binds that would not change anything. The slot is empty afterwards.
+        void RenderStatic(int slot);
+
+        // Everything recorded for one frame, double buffered so recording and rendering can overlap.
+        struct StaticFrame
+        {
+            RenderQueue Queue;
+            UniformArena Uniforms;
+            u32 FrameUniforms{NoUniforms};
+        };
+
+        ThreadCommandBuffers mCommandBuffers;
+        StaticFrame mStaticFrames[RenderThread::FrameCount];
+        int mLastRenderedSlot{};
+
+        void WriteUniform(u32 block, const Uniform& uniform, GLenum type, const void* data, int size);
+        void UploadUniforms(const StaticFrame& frame);
 
-        // Temporary solution
-        static constexpr auto MaxStaticDrawCommands = 2048;
-        StaticDrawCommand mStaticCommands[MaxStaticDrawCommands];
-        int mStaticCommandsCount = 0;
+        u32 mFrameUniforms{NoUniforms}; // Of the frame being recorded
+        int mFrameUniformsSize{}; // The largest PerFrame block of all shaders
 
     };
 
@@ -1,5 +1,5 @@
 #pragma once
-#include <string>
+#include <vge_string.h>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
@@ -9,7 +9,7 @@ namespace VGE
     // TODO: Rename to StaticMeshData
     struct MeshData
     {
-        std::string name;
+        StringID name;
         int vertex_count;
         int triangle_count;
         glm::vec3* vertices{};
@@ -17,11 +17,23 @@ namespace VGE
         glm::vec2* uv0{};
         glm::vec2* uv1{};
     };
-    // TODO: Create generational handle to be used here.
-    // Will both help detecting "invalid references", and can also help making the system more typesafe.
-    using MeshHandle = int;
-    using ShaderHandle = int;
-    using TextureHandle = int;
+
+    // Generational handle into one of the resource tables of the GFXManager.
+    // The index is the slot in the table, the generation is bumped every time the slot is freed,
+    // so a handle to a destroyed resource no longer resolves. The tag keeps the handle types apart.
+    template<class Tag>
+    struct ResourceHandle
+    {
+        int idx{-1};
+        int gen{};
+
+        bool operator==(const ResourceHandle& other) const { return idx == other.idx && gen == other.gen; }
+        bool operator!=(const ResourceHandle& other) const { return !(*this == other); }
+    };
+
+    using MeshHandle = ResourceHandle<struct MeshTag>;
+    using ShaderHandle = ResourceHandle<struct ShaderTag>;
+    using TextureHandle = ResourceHandle<struct TextureTag>;
     using ProgramID = GLuint;
     using ShaderID = GLuint;
     using TextureID = GLuint;
@@ -19,22 +19,27 @@ VGE::LoadOBJ(const char* filepath)
     if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath))
         VGE_ERROR("Could not load obj, err: %s, warn: %s", err.c_str(), warn.c_str());
 
+    int index_count = 0;
+    for (const auto& shape : shapes)
+        index_count += (int)shape.mesh.indices.size();
+
+    asset.vertices.Reserve(index_count);
+    asset.indices.Reserve(index_count);
+
     for (const auto& shape : shapes)
     {
         for (const auto& index : shape.mesh.indices)
         {
-            asset.positions.PushBack({
+            asset.vertices.PushBack({
                 attrib.vertices[3 * index.vertex_index + 0],
                 attrib.vertices[3 * index.vertex_index + 1],
                 attrib.vertices[3 * index.vertex_index + 2]
-            });
-
-            asset.uv_coords.PushBack({
+            },
+            {
                 attrib.texcoords[2 * index.texcoord_index + 0],
                 attrib.texcoords[2 * index.texcoord_index + 1]
-            });
-
-            asset.normals.PushBack({
+            },
+            {
                 attrib.normals[3 * index.normal_index + 0],
                 attrib.normals[3 * index.normal_index + 1],
                 attrib.normals[3 * index.normal_index + 2]
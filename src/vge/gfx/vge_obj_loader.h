@@ -3,14 +3,21 @@
 #include <glm/glm.hpp>
 #include <vge_gfx_gl.h>
 #include <vge_array.h>
+#include <vge_soa_array.h>
 
 namespace VGE
 {
     struct OBJAsset
     {
-        VGE::Array<glm::vec3> positions;
-        VGE::Array<glm::vec2> uv_coords;
-        VGE::Array<glm::vec3> normals;
+        // Columns of the vertices.
+        enum Attribute
+        {
+            Position,
+            UV,
+            Normal,
+        };
+
+        VGE::SoAArray<glm::vec3, glm::vec2, glm::vec3> vertices;
         VGE::Array<int> indices;
     };
 
@@ -0,0 +1,139 @@
+#include <vge_render_queue.h>
+#include <vge_algorithm.h>
+#include <vge_assert.h>
+#include <cstring>
+
+namespace
+{
+    // Handles start at -1 for "none", which gets field 0.
+    template<class Tag>
+    u64
+    key_field(VGE::ResourceHandle<Tag> handle, int bits = 16)
+    {
+        const auto field = (u64)(handle.idx + 1);
+        VGE_ASSERT(field < (1ull << bits), "Handle %d does not fit in %d bits of the sort key", handle.idx, bits);
+        return field;
+    }
+
+    // The bits of a non negative float sort the same way as the float, the top 16 are enough to order by depth.
+    u64
+    depth_field(float depth)
+    {
+        if (!(depth > 0.0f))
+            return 0;
+
+        u32 bits;
+        std::memcpy(&bits, &depth, sizeof(bits));
+        return bits >> 16;
+    }
+}
+
+VGE::RenderQueue::RenderQueue(Allocator& allocator)
+    : mAllocator(&allocator)
+    , mCommands(allocator)
+    , mKeys(allocator)
+    , mOrder(allocator)
+    , mChanges(allocator)
+{
+}
+
+void
+VGE::RenderQueue::Submit(const StaticDrawCommand& command)
+{
+    mCommands.PushBack(command);
+}
+
+void
+VGE::RenderQueue::Sort()
+{
+    const auto count = mCommands.Size();
+    mKeys.Resize(count);
+    mOrder.Resize(count);
+    mChanges.Resize(count);
+
+    // Sequence first, so the stable sort on the keys leaves equal keys in sequence order.
+    // Passes where all sequences share a digit are skipped, so this is close to free when they're not used.
+    for (int i = 0; i < count; i++)
+    {
+        mKeys[i] = mCommands[i].Sequence;
+        mOrder[i] = (u32)i;
+    }
+
+    RadixSort(mKeys, mOrder, *mAllocator);
+
+    for (int i = 0; i < count; i++)
+        mKeys[i] = MakeSortKey(mCommands[mOrder[i]]);
+
+    RadixSort(mKeys, mOrder, *mAllocator);
+
+    mStats = {};
+    mStats.Draws = count;
+
+    const StaticDrawCommand* previous = nullptr;
+    for (int i = 0; i < count; i++)
+    {
+        const auto& command = mCommands[mOrder[i]];
+
+        u8 changes = 0;
+        if (!previous || previous->Shader != command.Shader)
+            changes |= ChangeShader;
+        if (!previous || previous->UV0 != command.UV0 || previous->UV1 != command.UV1)
+            changes |= ChangeTextures;
+        if (!previous || previous->Mesh != command.Mesh)
+            changes |= ChangeMesh;
+
+        mChanges[i] = changes;
+        mStats.ShaderBinds += (changes & ChangeShader) != 0;
+        mStats.TextureBinds += (changes & ChangeTextures) != 0;
+        mStats.MeshBinds += (changes & ChangeMesh) != 0;
+        previous = &command;
+    }
+
+    mStats.AvoidedShaderBinds = count - mStats.ShaderBinds;
+    mStats.AvoidedTextureBinds = count - mStats.TextureBinds;
+    mStats.AvoidedMeshBinds = count - mStats.MeshBinds;
+}
+
+void
+VGE::RenderQueue::Clear()
+{
+    mCommands.Clear();
+    mKeys.Clear();
+    mOrder.Clear();
+    mChanges.Clear();
+}
+
+int
+VGE::RenderQueue::Size() const
+{
+    return mCommands.Size();
+}
+
+const VGE::StaticDrawCommand&
+VGE::RenderQueue::Command(int idx) const
+{
+    VGE_ASSERT(mOrder.Size() == mCommands.Size(), "Render queue has not been sorted since the last submit");
+    return mCommands[mOrder[idx]];
+}
+
+u8
+VGE::RenderQueue::Changes(int idx) const
+{
+    return mChanges[idx];
+}
+
+const VGE::RenderQueue::Stats&
+VGE::RenderQueue::GetStats() const
+{
+    return mStats;
+}
+
+u64
+VGE::RenderQueue::MakeSortKey(const StaticDrawCommand& command)
+{
+    return key_field(command.Shader) << 48
+         | key_field(command.UV0, 8) << 40
+         | key_field(command.UV1, 8) << 32
+         | key_field(command.Mesh) << 16
+         | depth_field(command.Depth);
+}
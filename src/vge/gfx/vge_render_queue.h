@@ -0,0 +1,66 @@
+#pragma once
+#include <vge_core.h>
+#include <vge_array.h>
+#include <vge_draw_cmd.h>
+
+namespace VGE
+{
+    // Collects the static draw commands of a frame, and orders them so that draws sharing state end up next to each other.
+    // Every command is packed into a 64 bit sort key, from the most to the least significant bits:
+    //      [ shader: 16 | uv0: 8 | uv1: 8 | mesh: 16 | depth: 16 ]
+    // so the draws are grouped by shader, then by both textures, then by mesh, and front to back within a group.
+    // Both textures have to be in the key, as a change of either one rebinds the textures. Which limits them to 255 handles.
+    // Commands with equal keys are drawn in order of their Sequence, and in submission order after that.
+    // The keys are radix sorted along with the command indices, the commands themselves never move.
+    // Knows nothing about OpenGL, the GFXManager replays the sorted commands and only binds what changed.
+    class RenderQueue
+    {
+    public:
+        enum StateChange : u8
+        {
+            ChangeShader = 1 << 0,
+            ChangeTextures = 1 << 1,
+            ChangeMesh = 1 << 2,
+        };
+
+        // Binds are counted against binding everything for every draw.
+        struct Stats
+        {
+            int Draws;
+            int ShaderBinds;
+            int TextureBinds;
+            int MeshBinds;
+            int AvoidedShaderBinds;
+            int AvoidedTextureBinds;
+            int AvoidedMeshBinds;
+        };
+
+        RenderQueue(Allocator& allocator = *GetDefaultAllocator());
+
+        void Submit(const StaticDrawCommand& command);
+
+        // Sorts the submitted commands, and works out which state has to change before each draw.
+        void Sort();
+
+        // Clears the commands, the stats of the last sort are kept.
+        void Clear();
+
+        int Size() const;
+
+        // In sorted order, only valid after Sort.
+        const StaticDrawCommand& Command(int idx) const;
+        u8 Changes(int idx) const;
+
+        const Stats& GetStats() const;
+
+        static u64 MakeSortKey(const StaticDrawCommand& command);
+
+    private:
+        Allocator* mAllocator;
+        Array<StaticDrawCommand> mCommands; // In submission order
+        Array<u64> mKeys;
+        Array<u32> mOrder; // Index into mCommands, pr sorted position
+        Array<u8> mChanges; // StateChange flags, pr sorted position
+        Stats mStats{};
+    };
+}
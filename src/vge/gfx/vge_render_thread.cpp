@@ -0,0 +1,142 @@
+#include <vge_render_thread.h>
+#include <vge_assert.h>
+#include <vge_profiler.h>
+
+VGE::RenderThread::RenderThread(Thread::ThreadID id)
+    : mThread(id)
+{
+}
+
+VGE::RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+void
+VGE::RenderThread::Start(StartFunction on_start, RenderFunction render, StartFunction on_stop)
+{
+    VGE_ASSERT(render, "Render thread needs a render function");
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        VGE_ASSERT(!mRunning, "Render thread is already running");
+        mRunning = true;
+    }
+
+    mThread.Start([this, on_start = std::move(on_start), render = std::move(render), on_stop = std::move(on_stop)]()
+    {
+        Run(on_start, render, on_stop);
+    });
+}
+
+void
+VGE::RenderThread::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (!mRunning)
+            return;
+
+        VGE_ASSERT(!mRecording, "Stopping the render thread in the middle of a frame");
+        mRunning = false;
+    }
+    mFrameSubmitted.notify_one();
+    mThread.Join();
+}
+
+int
+VGE::RenderThread::BeginFrame()
+{
+    VGE_PROFILE_LABEL("Wait for render thread");
+
+    std::unique_lock<std::mutex> lock(mLock);
+    VGE_ASSERT(mRunning, "Render thread is not running");
+    VGE_ASSERT(!mRecording, "BeginFrame called twice without EndFrame");
+
+    // The slot was last used FrameCount frames ago.
+    mFrameRendered.wait(lock, [this]() { return mSubmitted - mRendered < (u64)FrameCount; });
+    mRecording = true;
+    return (int)(mSubmitted % FrameCount);
+}
+
+void
+VGE::RenderThread::EndFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        VGE_ASSERT(mRecording, "EndFrame called without BeginFrame");
+        mRecording = false;
+        mSubmitted++;
+    }
+    mFrameSubmitted.notify_one();
+}
+
+void
+VGE::RenderThread::Flush()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    mFrameRendered.wait(lock, [this]() { return mRendered == mSubmitted; });
+}
+
+VGE::Thread::ThreadID
+VGE::RenderThread::ID() const
+{
+    return mThread.ID();
+}
+
+bool
+VGE::RenderThread::IsRunning() const
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mRunning;
+}
+
+u64
+VGE::RenderThread::SubmittedFrames() const
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mSubmitted;
+}
+
+u64
+VGE::RenderThread::RenderedFrames() const
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mRendered;
+}
+
+void
+VGE::RenderThread::Run(StartFunction on_start, RenderFunction render, StartFunction on_stop)
+{
+    if (on_start)
+        on_start();
+
+    while (true)
+    {
+        u64 frame;
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            mFrameSubmitted.wait(lock, [this]() { return mRendered < mSubmitted || !mRunning; });
+
+            // Frames handed over before stopping are still rendered.
+            if (mRendered == mSubmitted)
+                break;
+
+            frame = mRendered;
+        }
+
+        {
+            VGE_PROFILE_LABEL("Render frame");
+            render((int)(frame % FrameCount));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mRendered++;
+        }
+        mFrameRendered.notify_all();
+    }
+
+    if (on_stop)
+        on_stop();
+}
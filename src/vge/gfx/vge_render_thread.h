@@ -0,0 +1,57 @@
+#pragma once
+#include <vge_core.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+namespace VGE
+{
+    // Renders frame N on its own VGE::Thread, while the main thread records frame N+1.
+    // Frames are handed over through FrameCount slots: the main thread records into one slot while the render thread draws another.
+    // The fence is the number of frames rendered so far, so the main thread only waits on it once it gets FrameCount - 1 frames ahead.
+    // Knows nothing about OpenGL, the functions given to Start are expected to make the context current and draw the slot.
+    class RenderThread
+    {
+    public:
+        static constexpr auto FrameCount = 2;
+
+        using StartFunction = std::function<void()>;
+        using RenderFunction = std::function<void(int slot)>;
+
+        // Takes a ThreadID of its own, so it gets its own profiler lane and thread caches, keep it clear of the job system workers.
+        RenderThread(Thread::ThreadID id);
+        ~RenderThread();
+
+        // on_start and on_stop run on the render thread, before the first and after the last frame.
+        void Start(StartFunction on_start, RenderFunction render, StartFunction on_stop = nullptr);
+
+        // Renders the frames that have been handed over, then joins.
+        void Stop();
+
+        // Main thread only. Returns the slot to record the next frame into, waiting until the render thread is done with it.
+        int BeginFrame();
+
+        // Main thread only. Hands the slot from BeginFrame over to the render thread.
+        void EndFrame();
+
+        // Waits until every frame handed over has been rendered.
+        void Flush();
+
+        Thread::ThreadID ID() const;
+        bool IsRunning() const;
+        u64 SubmittedFrames() const;
+        u64 RenderedFrames() const;
+
+    private:
+        void Run(StartFunction on_start, RenderFunction render, StartFunction on_stop);
+
+        Thread mThread;
+        mutable std::mutex mLock;
+        std::condition_variable mFrameSubmitted;
+        std::condition_variable mFrameRendered;
+        u64 mSubmitted{};
+        u64 mRendered{}; // The fence
+        bool mRecording{};
+        bool mRunning{};
+    };
+}
@@ -0,0 +1,82 @@
+#include <vge_uniform_arena.h>
+#include <vge_assert.h>
+#include <algorithm>
+#include <cstring>
+
+VGE::UniformArena::UniformArena(Allocator& allocator)
+    : mData(allocator)
+{
+}
+
+void
+VGE::UniformArena::SetAlignment(int alignment)
+{
+    VGE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Uniform block alignment: %d is not a power of two", alignment);
+    mAlignment = alignment;
+}
+
+int
+VGE::UniformArena::Alignment() const
+{
+    return mAlignment;
+}
+
+u32
+VGE::UniformArena::Allocate(int size)
+{
+    VGE_ASSERT(size > 0, "Trying to allocate a uniform block of %d bytes", size);
+
+    const auto begin = mData.Size();
+    const auto offset = (begin + mAlignment - 1) & ~(mAlignment - 1);
+    const auto end = offset + size;
+
+    // Resize does not grow geometrically by itself.
+    if (end > mData.Capacity())
+        mData.Reserve(std::max(end, mData.Capacity() * 2));
+
+    // Zeroes the padding as well, so no garbage is uploaded.
+    mData.Resize(end);
+    std::memset(mData.Data() + begin, 0, end - begin);
+    return (u32)offset;
+}
+
+void
+VGE::UniformArena::Write(u32 block, const Uniform& uniform, const void* data, int size)
+{
+    if (!uniform.Valid())
+        return;
+
+    VGE_ASSERT(size == uniform.Size, "Writing %d bytes to a uniform of %d bytes", size, (int)uniform.Size);
+    VGE_ASSERT(block != NoUniforms && block + uniform.Offset + size <= (u32)mData.Size(), "Uniform at offset %d is outside the arena", (int)(block + uniform.Offset));
+    std::memcpy(mData.Data() + block + uniform.Offset, data, size);
+}
+
+u32
+VGE::UniformArena::Append(const UniformArena& other)
+{
+    VGE_ASSERT(other.mAlignment == mAlignment, "Appending uniforms aligned to %d to an arena aligned to %d", other.mAlignment, mAlignment);
+    if (other.Size() == 0)
+        return 0;
+
+    const auto base = Allocate(other.Size());
+    std::memcpy(mData.Data() + base, other.Data(), other.Size());
+    return base;
+}
+
+void
+VGE::UniformArena::Reset()
+{
+    mData.Clear();
+}
+
+const u8*
+VGE::UniformArena::Data() const
+{
+    return mData.Data();
+}
+
+int
+VGE::UniformArena::Size() const
+{
+    return mData.Size();
+}
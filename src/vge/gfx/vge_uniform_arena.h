@@ -0,0 +1,41 @@
+#pragma once
+#include <vge_core.h>
+#include <vge_array.h>
+#include <vge_draw_cmd.h>
+
+namespace VGE
+{
+    // The uniform data of one frame, tightly packed so it can be uploaded to a uniform buffer in one go.
+    // Every block starts at a multiple of the alignment (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT),
+    // so the range of a block can be bound directly when drawing.
+    // Draw commands only hold the offset of their block, instead of the uniform values themselves.
+    class UniformArena
+    {
+    public:
+        UniformArena(Allocator& allocator = *GetDefaultAllocator());
+
+        // Has to be a power of two.
+        void SetAlignment(int alignment);
+        int Alignment() const;
+
+        // Returns the offset of a zeroed block of size bytes.
+        u32 Allocate(int size);
+
+        // Writes the value of a uniform into the block at the given offset, uniforms that were not found are ignored.
+        void Write(u32 block, const Uniform& uniform, const void* data, int size);
+
+        // Copies all the blocks of another arena with the same alignment to the end of this one.
+        // Returns the offset to add to the blocks of the other arena, 0 if it was empty.
+        u32 Append(const UniformArena& other);
+
+        // Starts a new frame, all previous blocks are invalidated.
+        void Reset();
+
+        const u8* Data() const;
+        int Size() const;
+
+    private:
+        Array<u8> mData;
+        int mAlignment{256};
+    };
+}
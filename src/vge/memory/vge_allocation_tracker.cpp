@@ -0,0 +1,310 @@
+#include <vge_allocation_tracker.h>
+#include <vge_allocator.h>
+#include <vge_assert.h>
+#include <imgui.h>
+#include <algorithm>
+#include <cfloat>
+
+#ifndef WIN32
+#include <cxxabi.h>
+#include <dlfcn.h>
+#endif
+
+void
+VGE::AllocationTracker::Record(AllocationKind kind, const Allocator* owner, const void* ptr, i64 size, const void* call_site) VGE_NOEXCEPT
+{
+    auto& events = mThreadEvents[VGE::Thread::ThisThread::ID()];
+
+    // Claim a slot, more than one thread can be writing to ring 0. The main thread catches up in Update.
+    const auto idx = events.Head.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = events.Slots[idx & (MaxEvents - 1)];
+    slot.Sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& event = slot.Event;
+    event.Ptr = ptr;
+    event.CallSite = call_site;
+    event.Owner = owner;
+    event.Size = size;
+    event.Ticks = VGE::Clock::Ticks();
+    event.Frame = mFrame.load(std::memory_order_relaxed);
+    event.Kind = kind;
+    event.Retried = false;
+    slot.Sequence.store(idx + 1, std::memory_order_release);
+}
+
+void
+VGE::AllocationTracker::Update()
+{
+    static thread_local std::vector<AllocationEvent> events;
+    events.clear();
+
+    // Frees that didn't match anything last time go through again, sorted in with the new events.
+    events.swap(mPendingFrees);
+
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+    {
+        auto& thread_events = mThreadEvents[t];
+        const auto head = thread_events.Head.load(std::memory_order_acquire);
+        const auto oldest = (head > (u64)MaxEvents) ? head - MaxEvents : 0;
+        auto idx = std::max(mCursors[t], oldest);
+        mDroppedEvents += idx - mCursors[t];
+
+        for (; idx < head; idx++)
+        {
+            const auto& slot = thread_events.Slots[idx & (MaxEvents - 1)];
+            const auto sequence = slot.Sequence.load(std::memory_order_acquire);
+            if (sequence == 0 || sequence < idx + 1)
+                break; // Still being written, picked up by the next Update.
+
+            if (sequence == idx + 1)
+            {
+                const auto event = slot.Event;
+
+                // Only keep the copy if the slot wasn't reused by a writer that wrapped around while it was copied.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.Sequence.load(std::memory_order_relaxed) == sequence)
+                {
+                    events.push_back(event);
+                    continue;
+                }
+            }
+
+            mDroppedEvents++;
+        }
+
+        mCursors[t] = idx;
+    }
+
+    // Memory freed on another thread than it was allocated on, has to be processed after the allocation.
+    std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b) { return a.Ticks < b.Ticks; });
+    for (auto& event : events)
+    {
+        // Memory allocated before tracking started is never going to match, so frees are only retried once.
+        if (!Process(event) && !event.Retried)
+        {
+            event.Retried = true;
+            mPendingFrees.push_back(event);
+        }
+    }
+}
+
+bool
+VGE::AllocationTracker::Process(const AllocationEvent& event)
+{
+    auto& frame = StatsForFrame(event.Frame);
+
+    if (event.Kind == AllocationKind::Deallocate)
+    {
+        const auto it = mLiveAllocations.find(event.Ptr);
+        if (it == mLiveAllocations.end())
+            return false;
+
+        auto& site = mCallSites[it->second.CallSite];
+        site.LiveCount--;
+        site.LiveBytes -= it->second.Size;
+        mLiveAllocations.erase(it);
+        frame.Deallocations++;
+        return true;
+    }
+
+    auto& site = mCallSites[event.CallSite];
+    site.CallSite = event.CallSite;
+    site.Count++;
+    site.Bytes += event.Size;
+    frame.Allocations++;
+    frame.Bytes += event.Size;
+
+    if (event.Kind == AllocationKind::Allocate)
+    {
+        site.LiveCount++;
+        site.LiveBytes += event.Size;
+        mLiveAllocations[event.Ptr] = {event.Owner, event.CallSite, event.Size, event.Frame};
+    }
+
+    return true;
+}
+
+VGE::AllocationTracker::FrameStats&
+VGE::AllocationTracker::StatsForFrame(u64 frame)
+{
+    auto& stats = mFrameStats[frame % MaxFrames];
+    if (stats.Frame != frame)
+        stats = {frame};
+
+    return stats;
+}
+
+void
+VGE::AllocationTracker::BeginFrame()
+{
+    Update();
+    mFrame.fetch_add(1, std::memory_order_relaxed);
+}
+
+const VGE::AllocationTracker::FrameStats*
+VGE::AllocationTracker::GetFrameStats(int frames_back)
+{
+    const auto current = mFrame.load(std::memory_order_relaxed);
+    if (frames_back < 0 || frames_back >= MaxFrames - 1 || (u64)frames_back >= current)
+        return nullptr;
+
+    // Frames without any allocations never had their slot claimed.
+    return &StatsForFrame(current - 1 - frames_back);
+}
+
+std::vector<VGE::AllocationTracker::CallSiteStats>
+VGE::AllocationTracker::TopCallSites(int count)
+{
+    std::vector<CallSiteStats> sites;
+    sites.reserve(mCallSites.size());
+    for (const auto& [call_site, stats] : mCallSites)
+        sites.push_back(stats);
+
+    count = std::min(count, (int)sites.size());
+    std::partial_sort(sites.begin(), sites.begin() + count, sites.end(), [](const auto& a, const auto& b)
+    {
+        return a.Count > b.Count || (a.Count == b.Count && a.Bytes > b.Bytes);
+    });
+    sites.resize(count);
+
+    return sites;
+}
+
+const std::unordered_map<const void*, VGE::AllocationTracker::LiveAllocation>&
+VGE::AllocationTracker::LiveAllocations()
+{
+    return mLiveAllocations;
+}
+
+u64
+VGE::AllocationTracker::DroppedEvents() const
+{
+    return mDroppedEvents;
+}
+
+std::string
+VGE::AllocationTracker::CallSiteName(const void* call_site)
+{
+    char buffer[512];
+    std::snprintf(buffer, sizeof(buffer), "%p", call_site);
+
+    #ifndef WIN32
+    Dl_info info;
+    if (call_site && dladdr(call_site, &info))
+    {
+        if (info.dli_sname)
+        {
+            int status = 0;
+            auto demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::snprintf(buffer, sizeof(buffer), "%s+0x%tx", (status == 0) ? demangled : info.dli_sname, (const char*)call_site - (const char*)info.dli_saddr);
+            std::free(demangled);
+        }
+        else if (info.dli_fname)
+        {
+            std::snprintf(buffer, sizeof(buffer), "%s+0x%tx", info.dli_fname, (const char*)call_site - (const char*)info.dli_fbase);
+        }
+    }
+    #endif
+
+    return buffer;
+}
+
+int
+VGE::AllocationTracker::DumpLeaks(std::FILE* file)
+{
+    Update();
+
+    std::vector<std::pair<const void*, LiveAllocation>> leaks(mLiveAllocations.begin(), mLiveAllocations.end());
+    std::sort(leaks.begin(), leaks.end(), [](const auto& a, const auto& b) { return a.second.Frame < b.second.Frame; });
+
+    std::fprintf(file, "# Live allocations: %d\n", (int)leaks.size());
+    std::fprintf(file, "%-18s %12s %8s %-18s %s\n", "address", "bytes", "frame", "allocator", "call site");
+    for (const auto& [ptr, allocation] : leaks)
+    {
+        std::fprintf(file, "%-18p %12lld %8llu %-18p %s\n", ptr, (long long)allocation.Size, (unsigned long long)allocation.Frame,
+                     (const void*)allocation.Owner, CallSiteName(allocation.CallSite).c_str());
+    }
+
+    return (int)leaks.size();
+}
+
+bool
+VGE::AllocationTracker::ExportReport(const char* filepath)
+{
+    auto file = std::fopen(filepath, "w");
+    if (!file)
+    {
+        VGE_WARN("Could not open allocation report: %s", filepath);
+        return false;
+    }
+
+    Update();
+
+    std::fprintf(file, "# Allocations pr frame\n");
+    std::fprintf(file, "%8s %12s %14s %12s\n", "frame", "allocations", "deallocations", "bytes");
+    for (int frames_back = MaxFrames - 2; frames_back >= 0; frames_back--)
+    {
+        if (const auto stats = GetFrameStats(frames_back))
+            std::fprintf(file, "%8llu %12d %14d %12lld\n", (unsigned long long)stats->Frame, stats->Allocations, stats->Deallocations, (long long)stats->Bytes);
+    }
+
+    std::fprintf(file, "\n# Call sites by allocation count\n");
+    std::fprintf(file, "%10s %14s %10s %14s %s\n", "count", "bytes", "live", "live bytes", "call site");
+    for (const auto& site : TopCallSites((int)mCallSites.size()))
+    {
+        std::fprintf(file, "%10llu %14lld %10llu %14lld %s\n", (unsigned long long)site.Count, (long long)site.Bytes,
+                     (unsigned long long)site.LiveCount, (long long)site.LiveBytes, CallSiteName(site.CallSite).c_str());
+    }
+
+    std::fprintf(file, "\n");
+    DumpLeaks(file);
+
+    if (mDroppedEvents)
+        std::fprintf(file, "\n# Dropped events: %llu\n", (unsigned long long)mDroppedEvents);
+
+    std::fclose(file);
+    return true;
+}
+
+void
+VGE::AllocationTracker::DrawDebug()
+{
+    Update();
+
+    // Oldest frame to the left.
+    float allocations[MaxFrames]{};
+    int count = 0;
+    for (int frames_back = MaxFrames - 2; frames_back >= 0; frames_back--)
+    {
+        if (const auto stats = GetFrameStats(frames_back))
+            allocations[count++] = (float)stats->Allocations;
+    }
+
+    const auto last = GetFrameStats(0);
+    char overlay[64];
+    std::snprintf(overlay, sizeof(overlay), "%d allocations last frame", last ? last->Allocations : 0);
+    ImGui::PlotHistogram("##allocations_pr_frame", allocations, count, 0, overlay, 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
+    ImGui::Text("Live allocations: %d, dropped events: %llu", (int)mLiveAllocations.size(), (unsigned long long)mDroppedEvents);
+
+    static char filepath[256] = "allocation_report.txt";
+    ImGui::InputText("##report_path", filepath, sizeof(filepath));
+    ImGui::SameLine();
+    if (ImGui::Button("Export"))
+        ExportReport(filepath);
+
+    ImGui::Columns(4, "CallSites");
+    ImGui::Text("Count"); ImGui::NextColumn();
+    ImGui::Text("Bytes"); ImGui::NextColumn();
+    ImGui::Text("Live"); ImGui::NextColumn();
+    ImGui::Text("Call site"); ImGui::NextColumn();
+    ImGui::Separator();
+    for (const auto& site : TopCallSites(20))
+    {
+        ImGui::Text("%llu", (unsigned long long)site.Count); ImGui::NextColumn();
+        ImGui::Text("%lld", (long long)site.Bytes); ImGui::NextColumn();
+        ImGui::Text("%llu", (unsigned long long)site.LiveCount); ImGui::NextColumn();
+        ImGui::Text("%s", CallSiteName(site.CallSite).c_str()); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
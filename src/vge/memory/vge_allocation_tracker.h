@@ -0,0 +1,119 @@
+#pragma once
+#include <vge_core.h>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace VGE
+{
+    class Allocator;
+
+    enum class AllocationKind : u8
+    {
+        Allocate,
+        Deallocate,
+        Transient, // Released in bulk (linear, stack and frame allocators), never shows up as a leak.
+    };
+
+    struct AllocationEvent
+    {
+        const void* Ptr{};
+        const void* CallSite{};
+        const Allocator* Owner{};
+        i64 Size{};
+        i64 Ticks{}; // To merge the events of all threads in order.
+        u64 Frame{};
+        AllocationKind Kind{};
+        bool Retried{}; // Set on deallocations that didn't match a live allocation the first time.
+    };
+
+    // Records every allocation of the tracked allocators into lock free pr thread rings,
+    // which are drained by the main thread to build per frame counts, call site statistics and a list of live allocations.
+    // The main thread shares ring 0 with threads not started through VGE::Thread, so slots are claimed with a fetch_add
+    // and every slot is published with its own sequence number.
+    // Created by the MemoryManager when tracking is enabled. Its own bookkeeping uses the standard containers,
+    // so it never allocates through, and never tracks itself.
+    class AllocationTracker
+    {
+    public:
+        static constexpr auto MaxEvents = 1 << 14; // Per thread, must be a power of two.
+        static constexpr auto MaxFrames = 90;
+
+        struct FrameStats
+        {
+            u64 Frame{};
+            int Allocations{};
+            int Deallocations{};
+            i64 Bytes{};
+        };
+
+        struct CallSiteStats
+        {
+            const void* CallSite{};
+            u64 Count{};
+            i64 Bytes{};
+            u64 LiveCount{};
+            i64 LiveBytes{};
+        };
+
+        struct LiveAllocation
+        {
+            const Allocator* Owner{};
+            const void* CallSite{};
+            i64 Size{};
+            u64 Frame{};
+        };
+
+        // Can be called from any thread.
+        void Record(AllocationKind kind, const Allocator* owner, const void* ptr, i64 size, const void* call_site) VGE_NOEXCEPT;
+
+        // Only to be called from the main thread.
+        void Update(); // Drains the pr thread rings.
+        void BeginFrame();
+
+        const FrameStats* GetFrameStats(int frames_back); // 0 is the last completed frame.
+        std::vector<CallSiteStats> TopCallSites(int count);
+        const std::unordered_map<const void*, LiveAllocation>& LiveAllocations();
+        u64 DroppedEvents() const;
+
+        int DumpLeaks(std::FILE* file); // Returns the number of live allocations.
+        bool ExportReport(const char* filepath);
+        void DrawDebug();
+
+        // Function name and offset when the symbol is known, otherwise module and offset for addr2line.
+        static std::string CallSiteName(const void* call_site);
+
+        // Members
+        struct EventSlot
+        {
+            AllocationEvent Event;
+            std::atomic<u64> Sequence{}; // Index of the event + 1 once it's written, 0 while it's being written.
+        };
+
+        struct alignas(64) ThreadEvents
+        {
+            EventSlot Slots[MaxEvents];
+            std::atomic<u64> Head{};
+        };
+
+    private:
+        // Returns false if a deallocation did not match a live allocation.
+        bool Process(const AllocationEvent& event);
+        FrameStats& StatsForFrame(u64 frame);
+
+        ThreadEvents mThreadEvents[VGE::Thread::MaxThreads];
+        u64 mCursors[VGE::Thread::MaxThreads]{};
+        u64 mDroppedEvents{};
+
+        // Deallocations without a matching allocation, retried once in the next Update.
+        // The allocation might have been published by its thread just after that thread's ring was drained.
+        std::vector<AllocationEvent> mPendingFrees;
+        std::atomic<u64> mFrame{};
+
+        FrameStats mFrameStats[MaxFrames];
+        std::unordered_map<const void*, CallSiteStats> mCallSites;
+        std::unordered_map<const void*, LiveAllocation> mLiveAllocations;
+    };
+}
@@ -1,5 +1,6 @@
 #include <vge_allocator.h>
 #include <vge_malloc_allocator.h>
+#include <vge_thread_caching_allocator.h>
 #include <vge_debug.h>
 #include <vge_global_allocator.h>
 #include <cstring>
@@ -19,7 +20,9 @@
 VGE::Allocator*
 VGE::GetDefaultAllocator()
 {
-    static MallocAllocator a("default_allocator");
+    // The region is only reserved, the allocator commits each span as it is carved out.
+    constexpr auto size = 256 * 1024 * 1024;
+    static ThreadCachingAllocator a(gGlobalAllocator.AllocateRegion(size), size, "default_allocator");
     return &a;
 }
 
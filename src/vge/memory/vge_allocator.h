@@ -1,5 +1,6 @@
 #pragma once
 #include <vge_core.h>
+#include <cstddef>
 
 // TODO: Should have an own Resource/Static Allocator, for stuff that is static.
 // TODO: Move this to be purely an interface, no need to store name in here!
@@ -8,19 +9,31 @@ namespace VGE
     class Allocator
     {
     public:
+        static constexpr i64 DefaultAlignment = alignof(std::max_align_t);
+
         virtual ~Allocator() VGE_NOEXCEPT {};
 
-        virtual void* Allocate(int size) VGE_NOEXCEPT = 0;
+        // Alignment must be a power of two. Derived classes need a "using VGE::Allocator::Allocate;"
+        // to not hide the overload without alignment.
+        virtual void* Allocate(i64 size, i64 alignment) VGE_NOEXCEPT = 0;
+        // Always inlined, so allocation tracking sees the real call site.
+        VGE_INLINE void* Allocate(i64 size) VGE_NOEXCEPT {return Allocate(size, DefaultAlignment);}
         virtual void Deallocate(void* ptr) VGE_NOEXCEPT = 0;
-        virtual int AllocatedSize() const VGE_NOEXCEPT = 0;
+        virtual i64 AllocatedSize() const VGE_NOEXCEPT = 0;
         virtual void Clear() VGE_NOEXCEPT = 0; // Deallocate all memory
 
         // Metadata for visualization - Only implemented to avoid compiler errors with malloc allocator
-        virtual int Capacity() const VGE_NOEXCEPT {return 0;}
+        virtual i64 Capacity() const VGE_NOEXCEPT {return 0;}
         virtual const void* MemoryBegin() const VGE_NOEXCEPT {return nullptr;}
         virtual const char* Name() const VGE_NOEXCEPT {return "unnamed";}
     };
 
     Allocator*
     GetDefaultAllocator();
+
+    inline bool
+    IsAligned(const void* ptr, i64 alignment)
+    {
+        return ((uintptr_t)ptr & (alignment - 1)) == 0;
+    }
 }
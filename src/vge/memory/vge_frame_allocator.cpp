@@ -0,0 +1,225 @@
+#include <vge_frame_allocator.h>
+#include <vge_assert.h>
+#include <imgui.h>
+#include <algorithm>
+#include <cstring>
+
+VGE::FrameAllocator::FrameAllocator(i64 arena_size, const char* name, MemoryManager* manager, GlobalAllocator* backing)
+    : mArenaSize(arena_size)
+    , mMemoryManager(manager)
+{
+    VGE_ASSERT(arena_size > 0, "Frame allocator needs a positive arena size, got: %lld", (long long)arena_size);
+
+    auto tmp = (!name) ? "unnamed" : name;
+    std::strcpy(mName, tmp);
+
+    mData = (char*)backing->AllocateRegion(Capacity());
+
+    mMemoryManager->RegisterAllocator(this);
+    mMemoryManager->RegisterFrameAllocator(this);
+}
+
+VGE::FrameAllocator::~FrameAllocator()
+{
+    mMemoryManager->DeregisterFrameAllocator(this);
+    mMemoryManager->DeregisterAllocator(this);
+}
+
+char*
+VGE::FrameAllocator::ArenaBegin(int thread_id, int buffer) const VGE_NOEXCEPT
+{
+    return mData + (thread_id * FramesInFlight + buffer) * mArenaSize;
+}
+
+void*
+VGE::FrameAllocator::Allocate(i64 size, i64 alignment) VGE_NOEXCEPT
+{
+    VGE_ASSERT(size >= 0, "Trying to allocate negative size: %lld from %s", (long long)size, mName);
+    VGE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two, got: %lld", (long long)alignment);
+
+    const auto thread_id = VGE::Thread::ThisThread::ID();
+    auto& arena = mArenas[thread_id][mBuffer];
+    const auto data = ArenaBegin(thread_id, mBuffer);
+
+    // Only the owning thread bumps its arena, the atomic is there for the reporting.
+    const auto current = (uintptr_t)(data + arena.Size.load(std::memory_order_relaxed));
+    const auto begin = (i64)(((current + alignment - 1) & ~(uintptr_t)(alignment - 1)) - (uintptr_t)data);
+
+    VGE_ASSERT(begin + size <= mArenaSize, "Overrunning frame allocator: %s, %lld of %lld bytes used on thread %d",
+               mName, (long long)begin, (long long)mArenaSize, thread_id);
+    if (begin + size > mArenaSize)
+        return nullptr;
+
+    // The region is committed lazily, in steps of GlobalAllocator::CommitSize.
+    if (begin + size > arena.Committed)
+    {
+        const auto committed = std::min((begin + size + GlobalAllocator::CommitSize - 1) & ~(i64)(GlobalAllocator::CommitSize - 1), mArenaSize);
+        GlobalAllocator::CommitPages(data + arena.Committed, committed - arena.Committed);
+        arena.Committed = committed;
+    }
+
+    arena.Size.store(begin + size, std::memory_order_relaxed);
+    mMemoryManager->TrackAllocate(this, data + begin, size, VGE_RETURN_ADDRESS(), AllocationKind::Transient);
+    return data + begin;
+}
+
+void
+VGE::FrameAllocator::Deallocate(VGE_UNUSED void* ptr) VGE_NOEXCEPT
+{
+    VGE_ASSERT(!ptr || (ptr >= mData && ptr < mData + Capacity()), "Trying to deallocate memory not owned by frame allocator: %s", mName);
+}
+
+void
+VGE::FrameAllocator::BeginFrame() VGE_NOEXCEPT
+{
+    auto& report = mReports[mFrame % MaxReports];
+    report.Frame = mFrame;
+    report.Total = 0;
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+    {
+        report.Used[t] = mArenas[t][mBuffer].Size.load(std::memory_order_relaxed);
+        report.Total += report.Used[t];
+        mHighWaterMark = std::max(mHighWaterMark, report.Used[t]);
+    }
+    mFrameHighWaterMark = std::max(mFrameHighWaterMark, report.Total);
+
+    // The arenas of the frame before the one that just ended are free to use again.
+    mFrame++;
+    mBuffer = (int)(mFrame % FramesInFlight);
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+        mArenas[t][mBuffer].Size.store(0, std::memory_order_relaxed);
+}
+
+void
+VGE::FrameAllocator::Clear() VGE_NOEXCEPT
+{
+    for (auto& thread_arenas : mArenas)
+    {
+        for (auto& arena : thread_arenas)
+            arena.Size.store(0, std::memory_order_relaxed);
+    }
+}
+
+i64
+VGE::FrameAllocator::AllocatedSize() const VGE_NOEXCEPT
+{
+    // Both frames in flight are in use.
+    i64 total = 0;
+    for (const auto& thread_arenas : mArenas)
+    {
+        for (const auto& arena : thread_arenas)
+            total += arena.Size.load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+i64
+VGE::FrameAllocator::ThreadAllocatedSize() const VGE_NOEXCEPT
+{
+    return mArenas[VGE::Thread::ThisThread::ID()][mBuffer].Size.load(std::memory_order_relaxed);
+}
+
+i64
+VGE::FrameAllocator::HighWaterMark() const VGE_NOEXCEPT
+{
+    auto high_water_mark = mHighWaterMark;
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+        high_water_mark = std::max(high_water_mark, mArenas[t][mBuffer].Size.load(std::memory_order_relaxed));
+
+    return high_water_mark;
+}
+
+i64
+VGE::FrameAllocator::FrameHighWaterMark() const VGE_NOEXCEPT
+{
+    i64 total = 0;
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+        total += mArenas[t][mBuffer].Size.load(std::memory_order_relaxed);
+
+    return std::max(mFrameHighWaterMark, total);
+}
+
+const VGE::FrameAllocator::FrameReport*
+VGE::FrameAllocator::GetReport(int frames_back) const VGE_NOEXCEPT
+{
+    if (frames_back < 0 || frames_back >= MaxReports || (u64)frames_back >= mFrame)
+        return nullptr;
+
+    return &mReports[(mFrame - 1 - frames_back) % MaxReports];
+}
+
+u64
+VGE::FrameAllocator::FrameNumber() const VGE_NOEXCEPT
+{
+    return mFrame;
+}
+
+i64
+VGE::FrameAllocator::ArenaSize() const VGE_NOEXCEPT
+{
+    return mArenaSize;
+}
+
+i64
+VGE::FrameAllocator::Capacity() const VGE_NOEXCEPT
+{
+    return VGE::Thread::MaxThreads * FramesInFlight * mArenaSize;
+}
+
+const void*
+VGE::FrameAllocator::MemoryBegin() const VGE_NOEXCEPT
+{
+    return mData;
+}
+
+const char*
+VGE::FrameAllocator::Name() const VGE_NOEXCEPT
+{
+    return mName;
+}
+
+void
+VGE::FrameAllocator::DrawDebug()
+{
+    const auto to_kb = [](i64 bytes) { return (float)bytes / 1024.0f; };
+
+    ImGui::Text("Arena: %.1f KB pr thread pr frame, %d frames in flight", to_kb(mArenaSize), FramesInFlight);
+    ImGui::Text("High water mark: %.1f KB pr arena, %.1f KB pr frame", to_kb(HighWaterMark()), to_kb(FrameHighWaterMark()));
+
+    // Oldest frame to the left.
+    float totals[MaxReports]{};
+    int count = 0;
+    for (int frames_back = MaxReports - 1; frames_back >= 0; frames_back--)
+    {
+        if (const auto report = GetReport(frames_back))
+            totals[count++] = to_kb(report->Total);
+    }
+
+    ImGui::PlotHistogram("##frame_usage", totals, count, 0, "KB pr frame", 0.0f, to_kb(std::max(FrameHighWaterMark(), i64(1))), ImVec2(0.0f, 60.0f));
+
+    const auto last = GetReport(0);
+    if (!last)
+        return;
+
+    ImGui::Columns(2, "FrameAllocatorThreads");
+    ImGui::Text("Thread"); ImGui::NextColumn();
+    ImGui::Text("Used in frame %llu", (unsigned long long)last->Frame); ImGui::NextColumn();
+    ImGui::Separator();
+    for (int t = 0; t < VGE::Thread::MaxThreads; t++)
+    {
+        if (!last->Used[t])
+            continue;
+
+        ImGui::Text("%d", t); ImGui::NextColumn();
+        ImGui::Text("%.1f KB (%.1f%%)", to_kb(last->Used[t]), 100.0f * last->Used[t] / mArenaSize); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
+
+VGE::FrameAllocator*
+VGE::GetFrameAllocator()
+{
+    static FrameAllocator a(FrameAllocator::DefaultArenaSize, "frame_allocator");
+    return &a;
+}
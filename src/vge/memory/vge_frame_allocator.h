@@ -0,0 +1,90 @@
+#pragma once
+#include <vge_allocator.h>
+#include <vge_memory_manager.h>
+#include <vge_global_allocator.h>
+#include <vge_thread.h>
+#include <atomic>
+
+namespace VGE
+{
+    // Scratch memory for data that only lives for the frame, e.g. draw commands, uniforms and debug vertices.
+    // Every thread bumps a pointer in its own arena, and nothing is freed individually.
+    // The arenas are double buffered, memory allocated in frame N stays valid until frame N + 2 begins,
+    // so the previous frame can still be consumed while the next one is recorded.
+    // BeginFrame is driven by the main loop through MemoryManager::BeginFrame, and must not run while other threads allocate.
+    class FrameAllocator
+        : public VGE::Allocator
+    {
+    public:
+        static constexpr auto FramesInFlight = 2;
+        static constexpr auto MaxReports = 90;
+        static constexpr i64 DefaultArenaSize = 4 * 1024 * 1024;
+
+        struct FrameReport
+        {
+            u64 Frame{};
+            i64 Used[VGE::Thread::MaxThreads]{}; // Pr thread.
+            i64 Total{};
+        };
+
+        // Reserves MaxThreads * FramesInFlight arenas of arena_size bytes from the backing allocator.
+        FrameAllocator(i64 arena_size = DefaultArenaSize, const char* name = nullptr, MemoryManager* memory_manager = &VGE::gMemoryManager, GlobalAllocator* backing = &VGE::gGlobalAllocator);
+        virtual ~FrameAllocator();
+
+        using VGE::Allocator::Allocate;
+        virtual void* Allocate(i64 size, i64 alignment) VGE_NOEXCEPT override;
+        virtual void Deallocate(void* ptr) VGE_NOEXCEPT override; // Does nothing, memory is released with the frame.
+        virtual i64 AllocatedSize() const VGE_NOEXCEPT override;
+        virtual void Clear() VGE_NOEXCEPT override;
+
+        virtual i64 Capacity() const VGE_NOEXCEPT override;
+        virtual const void* MemoryBegin() const VGE_NOEXCEPT override;
+        virtual const char* Name() const VGE_NOEXCEPT override;
+
+        // Records the report of the ending frame, and resets the arenas of the frame before it.
+        void BeginFrame() VGE_NOEXCEPT;
+
+        u64 FrameNumber() const VGE_NOEXCEPT;
+        i64 ArenaSize() const VGE_NOEXCEPT;
+
+        // Bytes allocated by the calling thread in the current frame.
+        i64 ThreadAllocatedSize() const VGE_NOEXCEPT;
+
+        // Most memory used by a single arena, and by all arenas combined, in any frame so far.
+        i64 HighWaterMark() const VGE_NOEXCEPT;
+        i64 FrameHighWaterMark() const VGE_NOEXCEPT;
+
+        // 0 is the last completed frame, nullptr if the frame is too old or hasn't happened yet.
+        const FrameReport* GetReport(int frames_back) const VGE_NOEXCEPT;
+
+        void DrawDebug();
+
+    private:
+        char* ArenaBegin(int thread_id, int buffer) const VGE_NOEXCEPT;
+
+        // Members
+        struct alignas(64) Arena
+        {
+            std::atomic<i64> Size{};
+            i64 Committed{}; // Only touched by the owning thread, pages stay committed across frames.
+        };
+
+        char* mData{};
+        i64 mArenaSize{};
+        Arena mArenas[VGE::Thread::MaxThreads][FramesInFlight];
+
+        u64 mFrame{};
+        int mBuffer{};
+
+        FrameReport mReports[MaxReports];
+        i64 mHighWaterMark{};
+        i64 mFrameHighWaterMark{};
+
+        char mName[256];
+        MemoryManager* mMemoryManager;
+    };
+
+    // Shared frame allocator, created on first use.
+    FrameAllocator*
+    GetFrameAllocator();
+}
@@ -1,48 +1,183 @@
-// Note, do not use this! Only putting this in header to allow for testing.
 #include <vge_global_allocator.h>
 #include <vge_memory.h>
+#include <vge_assert.h>
 
-VGE::GlobalAllocator::GlobalAllocator(VGE::MemoryManager* memory_manager)
-    : mMemoryManager(memory_manager)
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+VGE::GlobalAllocator::~GlobalAllocator()
 {
-    mSize = 0;
-    // Just allocate a gig, should be enough for now.
+    if (!mData)
+        return;
 
-    //mCap = 1 << 30;
-    mCap = 1 << 20;
-    //mCap = 1 << 12;
-    mData = (char*)malloc(mCap);
+    mMemoryManager->DeregisterAllocator(this);
 
-    mMemoryManager->RegisterAllocator(this);
+    #ifdef WIN32
+    VirtualFree(mData, 0, MEM_RELEASE);
+    #else
+    munmap(mData, mCap);
+    #endif
 }
 
-VGE::GlobalAllocator::~GlobalAllocator()
+void
+VGE::GlobalAllocator::Reserve()
 {
-    mMemoryManager->DeregisterAllocator(this);
-    free(mData);
+    #ifdef WIN32
+    mData = (char*)VirtualAlloc(nullptr, mCap, MEM_RESERVE, PAGE_NOACCESS);
+    #else
+    // Pages are backed lazily by the OS as they are touched.
+    mData = (char*)mmap(nullptr, mCap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mData == MAP_FAILED)
+        mData = nullptr;
+    #endif
+
+    VGE_ASSERT(mData, "Failed to reserve %lld bytes of virtual memory for the global allocator", (long long)mCap);
+    if (mData)
+        mMemoryManager->RegisterAllocator(this);
+}
+
+// Allocations are handed out in order, so only the part past the last committed range can be new.
+bool
+VGE::GlobalAllocator::Commit(i64 begin, i64 end)
+{
+    const auto first = std::max((begin / CommitSize) * CommitSize, mCommitEnd);
+    const auto last = std::min(((end + CommitSize - 1) / CommitSize) * CommitSize, mCap);
+    if (first >= last)
+        return true;
+
+    #ifdef WIN32
+    const auto res = VirtualAlloc(mData + first, last - first, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+    #else
+    const auto res = true; // Mapped read/write from the start.
+    #endif
+
+    VGE_ASSERT(res, "Failed to commit %lld bytes in the global allocator", (long long)(last - first));
+    if (res)
+    {
+        mCommitted += last - first;
+        mCommitEnd = last;
+    }
+
+    return res;
+}
+
+void
+VGE::GlobalAllocator::CommitPages(VGE_UNUSED void* begin, VGE_UNUSED i64 size) VGE_NOEXCEPT
+{
+    #ifdef WIN32
+    // Committing pages that are already committed is fine.
+    const auto res = VirtualAlloc(begin, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+    VGE_ASSERT(res, "Failed to commit %lld bytes of a region", (long long)size);
+    #endif
+}
+
+void*
+VGE::GlobalAllocator::AllocateRegion(i64 size, i64 alignment) VGE_NOEXCEPT
+{
+    VGE_ASSERT(size >= 0, "Trying to allocate a region of negative size: %lld from the global allocator", (long long)size);
+    VGE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two, got: %lld", (long long)alignment);
+
+    std::lock_guard<std::mutex> lock(mLock);
+    const auto ptr = Bump(size, alignment);
+    if (ptr)
+        mRegionCount++;
+
+    return ptr;
 }
 
 void*
-VGE::GlobalAllocator::Allocate(int size) VGE_NOEXCEPT
+VGE::GlobalAllocator::Allocate(i64 size, i64 alignment) VGE_NOEXCEPT
+{
+    VGE_ASSERT(size >= 0, "Trying to allocate negative size: %lld from the global allocator", (long long)size);
+    VGE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two, got: %lld", (long long)alignment);
+
+    std::lock_guard<std::mutex> lock(mLock);
+    const auto ptr = Bump(size, std::max<i64>(alignment, MinAlignment));
+    if (!ptr || !Commit(ptr - mData, ptr - mData + size))
+        return nullptr;
+
+    return ptr;
+}
+
+// Expects mLock to be held.
+char*
+VGE::GlobalAllocator::Bump(i64 size, i64 alignment)
 {
-    int old = mSize;
-    mSize += size;
-    return &mData[old];
+    if (VGE_UNLIKELY(!mData))
+    {
+        Reserve();
+        if (!mData)
+            return nullptr;
+    }
+
+    const auto current = (uintptr_t)(mData + mSize);
+    const auto aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    const auto begin = (i64)(aligned - (uintptr_t)mData);
+    const auto end = begin + size;
+
+    VGE_ASSERT(end <= mCap, "Out of global memory, trying to allocate %lld bytes with %lld of %lld bytes in use", (long long)size, (long long)mSize, (long long)mCap);
+    if (end > mCap)
+        return nullptr;
+
+    mSize = end;
+    return mData + begin;
 }
 
 void
-VGE::GlobalAllocator::Deallocate(VGE_UNUSED void* ptr) VGE_NOEXCEPT
+VGE::GlobalAllocator::Deallocate(void* ptr) VGE_NOEXCEPT
 {
+    // Memory is never given back, but do catch pointers from elsewhere.
+    VGE_ASSERT(!ptr || Contains(ptr), "Trying to deallocate memory not owned by the global allocator");
+    (void)ptr;
+}
 
+void
+VGE::GlobalAllocator::Clear() VGE_NOEXCEPT
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (!mData)
+        return;
+
+    // Child allocators would be left pointing at decommitted memory.
+    VGE_ASSERT(mRegionCount == 0, "Clearing the global allocator with %d regions handed out to child allocators", mRegionCount);
+
+    // Give the pages back to the OS, while keeping the range reserved.
+    #ifdef WIN32
+    VirtualFree(mData, mCommitEnd, MEM_DECOMMIT);
+    #else
+    madvise(mData, mSize, MADV_DONTNEED);
+    #endif
+
+    mSize = 0;
+    mCommitted = 0;
+    mCommitEnd = 0;
 }
 
-int
+i64
 VGE::GlobalAllocator::AllocatedSize() const VGE_NOEXCEPT
 {
-    return 0; // For now at least, because we aren't really interested in what the global allocator has allocated
+    std::lock_guard<std::mutex> lock(mLock);
+    return mSize;
+}
+
+i64
+VGE::GlobalAllocator::CommittedSize() const VGE_NOEXCEPT
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mCommitted;
+}
+
+bool
+VGE::GlobalAllocator::Contains(const void* ptr) const VGE_NOEXCEPT
+{
+    return mData && ptr >= mData && ptr < mData + mCap;
 }
 
-int
+i64
 VGE::GlobalAllocator::Capacity() const VGE_NOEXCEPT
 {
     return mCap;
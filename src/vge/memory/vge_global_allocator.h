@@ -1,30 +1,67 @@
 #pragma once
 #include <vge_allocator.h>
 #include <vge_memory_manager.h>
-// Note, do not use this! Only putting this in header to allow for testing.
+#include <mutex>
 
 namespace VGE
 {
+    // Backing store for all other allocators.
+    // Reserves a large range of virtual memory on first use, and commits pages as they are handed out,
+    // so reserving a lot of memory costs nothing until it is used.
+    // Regions for child allocators are not committed up front, see CommitPages.
+    // Memory is handed out linearly, and is never given back except through Clear.
+    // The constructor does no work, so the global instance can be used during static initialization.
     class GlobalAllocator
         : public VGE::Allocator
     {
     public:
-        GlobalAllocator(MemoryManager* memory_manager = &gMemoryManager);
+        static constexpr i64 DefaultReserveSize = i64(16) << 30;
+        static constexpr auto CommitSize = 64 * 1024; // Granularity of committing pages.
+        static constexpr auto MinAlignment = 16;
+        static constexpr auto RegionAlignment = 4096; // Child regions start on their own page.
+
+        constexpr GlobalAllocator(MemoryManager* memory_manager = &gMemoryManager, i64 reserve_size = DefaultReserveSize)
+            : mCap(reserve_size)
+            , mMemoryManager(memory_manager)
+        {}
         virtual ~GlobalAllocator();
 
-        virtual void* Allocate(int size) VGE_NOEXCEPT override;
+        using VGE::Allocator::Allocate;
+        virtual void* Allocate(i64 size, i64 alignment) VGE_NOEXCEPT override;
         virtual void Deallocate(void* ptr) VGE_NOEXCEPT override;
-        virtual int AllocatedSize() const VGE_NOEXCEPT override;
-        virtual void Clear() VGE_NOEXCEPT override {}
+        virtual i64 AllocatedSize() const VGE_NOEXCEPT override;
+        virtual void Clear() VGE_NOEXCEPT override;
 
-        virtual int Capacity() const VGE_NOEXCEPT override;
+        virtual i64 Capacity() const VGE_NOEXCEPT override;
         virtual const void* MemoryBegin() const VGE_NOEXCEPT override;
         virtual const char* Name() const VGE_NOEXCEPT override;
 
+        // Hands out a region for a child allocator (LinearAllocator etc.) to manage.
+        // The region is only reserved, the child commits the parts it is about to use with CommitPages.
+        void* AllocateRegion(i64 size, i64 alignment = RegionAlignment) VGE_NOEXCEPT;
+
+        // Commits the pages covering [begin, begin + size) of a region.
+        // The reserve is mapped read/write without reserving swap on POSIX, so the OS faults pages in on first touch
+        // and this does nothing. Windows has no overcommit, so the pages are committed with VirtualAlloc.
+        static void CommitPages(void* begin, i64 size) VGE_NOEXCEPT;
+
+        // Bytes committed for allocations made directly from the global allocator, regions are not included.
+        i64 CommittedSize() const VGE_NOEXCEPT;
+
+        bool Contains(const void* ptr) const VGE_NOEXCEPT;
+
     private:
+        void Reserve();
+        char* Bump(i64 size, i64 alignment);
+        bool Commit(i64 begin, i64 end);
+
         char* mData{};
-        int mCap{};
-        int mSize{}; // For testing
+        i64 mCap{};
+        i64 mSize{};
+        i64 mCommitted{};
+        i64 mCommitEnd{}; // End of the last range committed by Commit
+        int mRegionCount{}; // Regions handed out, they're never given back
+        mutable std::mutex mLock;
         MemoryManager* mMemoryManager{};
     };
 
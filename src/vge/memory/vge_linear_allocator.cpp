@@ -3,7 +3,7 @@
 #include <vge_assert.h>
 #include <cstring>
 
-VGE::LinearAllocator::LinearAllocator(void* memory, int cap, const char* name, MemoryManager* manager)
+VGE::LinearAllocator::LinearAllocator(void* memory, i64 cap, const char* name, MemoryManager* manager)
     : mData((char*)memory)
     , mSize(0)
     , mCap(cap)
@@ -20,12 +20,18 @@ VGE::LinearAllocator::~LinearAllocator()
 }
 
 void*
-VGE::LinearAllocator::Allocate(int size) VGE_NOEXCEPT
+VGE::LinearAllocator::Allocate(i64 size, i64 alignment) VGE_NOEXCEPT
 {
-    VGE_ASSERT(mSize + size <= mCap, "Overrunning linear allocator: %s", mName);
-    int old = mSize;
-    mSize += size;
-    return &mData[old];
+    VGE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two, got: %lld", (long long)alignment);
+
+    // Align the address, not the offset, as the memory itself might not be aligned.
+    const auto current = (uintptr_t)(mData + mSize);
+    const auto begin = (i64)(((current + alignment - 1) & ~(uintptr_t)(alignment - 1)) - (uintptr_t)mData);
+
+    VGE_ASSERT(begin + size <= mCap, "Overrunning linear allocator: %s", mName);
+    mSize = begin + size;
+    mMemoryManager->TrackAllocate(this, &mData[begin], size, VGE_RETURN_ADDRESS(), AllocationKind::Transient);
+    return &mData[begin];
 }
 
 void
@@ -40,13 +46,13 @@ VGE::LinearAllocator::Clear() VGE_NOEXCEPT
     mSize = 0;
 }
 
-int
+i64
 VGE::LinearAllocator::Capacity() const VGE_NOEXCEPT
 {
     return mCap;
 }
 
-int
+i64
 VGE::LinearAllocator::AllocatedSize() const VGE_NOEXCEPT
 {
     return mSize;
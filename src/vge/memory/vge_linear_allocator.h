@@ -8,22 +8,23 @@ namespace VGE
         : public VGE::Allocator
     {
     public:
-        LinearAllocator(void* memory, int cap, const char* name = nullptr, MemoryManager* memory_manager = &VGE::gMemoryManager);
+        LinearAllocator(void* memory, i64 cap, const char* name = nullptr, MemoryManager* memory_manager = &VGE::gMemoryManager);
         virtual ~LinearAllocator();
 
-        virtual void* Allocate(int size) VGE_NOEXCEPT override;
+        using VGE::Allocator::Allocate;
+        virtual void* Allocate(i64 size, i64 alignment) VGE_NOEXCEPT override;
         virtual void Deallocate(void* ptr) VGE_NOEXCEPT override;
-        virtual int AllocatedSize() const VGE_NOEXCEPT override;
+        virtual i64 AllocatedSize() const VGE_NOEXCEPT override;
         virtual void Clear() VGE_NOEXCEPT override;
 
-        virtual int Capacity() const VGE_NOEXCEPT override;
+        virtual i64 Capacity() const VGE_NOEXCEPT override;
         virtual const void* MemoryBegin() const VGE_NOEXCEPT override;
         virtual const char* Name() const VGE_NOEXCEPT override;
 
     private:
         char* mData;
-        int mSize;
-        int mCap;
+        i64 mSize;
+        i64 mCap;
         char mName[256];
         MemoryManager* mMemoryManager;
 
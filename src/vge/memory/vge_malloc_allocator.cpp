@@ -1,20 +1,44 @@
 #include <vge_malloc_allocator.h>
+#include <vge_assert.h>
 #include <cstdlib>
 
+#ifdef WIN32
+#include <malloc.h>
+#endif
+
 void*
-VGE::MallocAllocator::Allocate(int size) VGE_NOEXCEPT
+VGE::MallocAllocator::Allocate(i64 size, i64 alignment) VGE_NOEXCEPT
 {
+    VGE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two, got: %lld", (long long)alignment);
+
     //VGE_DEBUG("%s: Allocating: %d", m_name, size);
-    return std::malloc(size);
+    #ifdef WIN32
+    const auto ptr = _aligned_malloc(size, alignment);
+    #else
+    void* ptr = nullptr;
+    if (alignment <= DefaultAlignment)
+        ptr = std::malloc(size);
+    else if (posix_memalign(&ptr, alignment, size) != 0)
+        ptr = nullptr;
+    #endif
+
+    mMemoryManager->TrackAllocate(this, ptr, size, VGE_RETURN_ADDRESS());
+    return ptr;
 }
 
 void
 VGE::MallocAllocator::Deallocate(void* ptr) VGE_NOEXCEPT
 {
+    mMemoryManager->TrackDeallocate(this, ptr);
+
+    #ifdef WIN32
+    _aligned_free(ptr);
+    #else
     std::free(ptr);
+    #endif
 }
 
-int
+i64
 VGE::MallocAllocator::AllocatedSize() const VGE_NOEXCEPT
 {
     return 0;
@@ -1,5 +1,6 @@
 #pragma once
 #include <vge_allocator.h>
+#include <vge_memory_manager.h>
 
 namespace VGE
 {
@@ -8,13 +9,20 @@ namespace VGE
         : public VGE::Allocator
     {
     public:
-        MallocAllocator(const char* name [[maybe_unused]] ) {}
+        // Not registered with the memory manager, as it has no memory range, but its allocations are tracked.
+        MallocAllocator(const char* name [[maybe_unused]], MemoryManager* memory_manager = &VGE::gMemoryManager)
+            : mMemoryManager(memory_manager)
+        {}
         virtual ~MallocAllocator() {}
 
-        virtual void* Allocate(int size) VGE_NOEXCEPT override;
+        using VGE::Allocator::Allocate;
+        virtual void* Allocate(i64 size, i64 alignment) VGE_NOEXCEPT override;
         virtual void Deallocate(void* ptr) VGE_NOEXCEPT override;
-        virtual int AllocatedSize() const VGE_NOEXCEPT override;
+        virtual i64 AllocatedSize() const VGE_NOEXCEPT override;
         virtual void Clear() VGE_NOEXCEPT {}
+
+    private:
+        MemoryManager* mMemoryManager;
     };
 }
 
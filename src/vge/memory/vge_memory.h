@@ -2,5 +2,9 @@
 #include <vge_allocator.h>
 #include <vge_malloc_allocator.h>
 #include <vge_linear_allocator.h>
+#include <vge_thread_caching_allocator.h>
 #include <vge_global_allocator.h>
+#include <vge_frame_allocator.h>
+#include <vge_pool_allocator.h>
+#include <vge_stack_allocator.h>
 #include <vge_memory_manager.h>
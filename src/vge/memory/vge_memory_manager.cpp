@@ -1,7 +1,28 @@
 #include <vge_memory_manager.h>
 #include <vge_assert.h>
 #include <vge_global_allocator.h>
+#include <vge_frame_allocator.h>
 #include <imgui.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+VGE::MemoryManager::~MemoryManager()
+{
+    // Allocators destroyed after the manager must not record into the tracker.
+    mTracking.store(false, std::memory_order_relaxed);
+    delete mTracker;
+    mTracker = nullptr;
+
+    for (auto& registry : mRegistries)
+    {
+        std::lock_guard<std::shared_mutex> lock(registry.Lock);
+        std::free(registry.Ranges);
+        registry.Ranges = nullptr;
+        registry.Count = 0;
+        registry.Capacity = 0;
+    }
+}
 
 void
 VGE::MemoryManager::Init()
@@ -15,49 +36,246 @@ VGE::MemoryManager::GetDefaultAllocator()
     return &gGlobalAllocator;
 }
 
+namespace
+{
+    using AllocatorRange = VGE::MemoryManager::AllocatorRange;
+
+    // Outer ranges sort before the ranges nested inside of them.
+    bool
+    RangeLess(const AllocatorRange& a, const AllocatorRange& b)
+    {
+        return a.Begin < b.Begin || (a.Begin == b.Begin && a.End > b.End);
+    }
+
+    AllocatorRange
+    MakeRange(VGE::Allocator* allocator)
+    {
+        const auto begin = (const char*)allocator->MemoryBegin();
+        return {begin, begin + (begin ? allocator->Capacity() : 0), allocator, -1};
+    }
+}
+
+int
+VGE::MemoryManager::AllocatorRegistry::Insert(const AllocatorRange& range)
+{
+    if (Count == Capacity)
+    {
+        // Not through an allocator, as the allocators register themselves here.
+        Capacity = std::max(Capacity * 2, 64);
+        Ranges = (AllocatorRange*)std::realloc(Ranges, Capacity * sizeof(AllocatorRange));
+        VGE_ASSERT(Ranges, "Out of memory, failed to grow the allocator registry to %d allocators", Capacity);
+    }
+
+    const auto position = (int)(std::upper_bound(Ranges, Ranges + Count, range, RangeLess) - Ranges);
+
+    // The parent is the innermost range before this one that contains it, found by walking up from the previous range.
+    auto parent = position - 1;
+    while (parent >= 0 && !(Ranges[parent].Begin <= range.Begin && range.End <= Ranges[parent].End))
+        parent = Ranges[parent].Parent;
+
+    std::memmove(&Ranges[position + 1], &Ranges[position], (Count - position) * sizeof(AllocatorRange));
+    Ranges[position] = range;
+    Ranges[position].Parent = parent;
+    Count++;
+
+    // Parents come before their children, so only the ranges after the new one can point past it.
+    for (int i = position + 1; i < Count; i++)
+    {
+        if (Ranges[i].Parent >= position)
+            Ranges[i].Parent++;
+    }
+
+    // Direct children of the parent that fall inside the new range are now nested in it.
+    for (int i = position + 1; i < Count && Ranges[i].Begin < range.End; i++)
+    {
+        if (Ranges[i].Parent == parent && Ranges[i].End <= range.End)
+            Ranges[i].Parent = position;
+    }
+
+    return position;
+}
+
 void
-VGE::MemoryManager::RegisterAllocator(Allocator* allocator)
+VGE::MemoryManager::AllocatorRegistry::Erase(int idx)
+{
+    const auto parent = Ranges[idx].Parent;
+
+    std::memmove(&Ranges[idx], &Ranges[idx + 1], (Count - idx - 1) * sizeof(AllocatorRange));
+    Count--;
+
+    for (int i = idx; i < Count; i++)
+    {
+        if (Ranges[i].Parent == idx)
+            Ranges[i].Parent = parent;
+        else if (Ranges[i].Parent > idx)
+            Ranges[i].Parent--;
+    }
+}
+
+int
+VGE::MemoryManager::AllocatorRegistry::Find(const void* ptr) const
 {
-    // Switch to binary search after verifying correctness, before doing binary search though, do check that we are not larger then the end, because in that case we can just append the end.
-    // Sort not based on the address of the allocator, but rather the address of where the memory begins!
-    auto& alloc_count = mAllocatorsCount[VGE::Thread::ThisThread::ID()];
-    VGE_ASSERT(alloc_count < MaxAllocators, "We are either leaking allocators, or are trying to add more allocators than maximum 256");
+    // Last range beginning at or before ptr, if it doesn't contain ptr only its ancestors can.
+    auto idx = (int)(std::upper_bound(Ranges, Ranges + Count, (const char*)ptr, [](const char* p, const AllocatorRange& range) { return p < range.Begin; }) - Ranges) - 1;
+    while (idx >= 0 && (const char*)ptr >= Ranges[idx].End)
+        idx = Ranges[idx].Parent;
+
+    return idx;
+}
 
-    Allocator** allocators = mAllocators[VGE::Thread::ThisThread::ID()];
+int
+VGE::MemoryManager::AllocatorRegistry::Find(const Allocator* allocator) const
+{
+    for (int i = Count - 1; i >= 0; i--)
+    {
+        if (Ranges[i].Owner == allocator)
+            return i;
+    }
 
-    int position = 0;
-    while (position < alloc_count && allocator >= allocators[position])
-        position++;
+    return -1;
+}
 
-    // Shift all objects one space up
-    std::memmove(&allocators[position + 1], &allocators[position], (alloc_count - position) * sizeof(VGE::Allocator*));
-    allocators[position] = allocator;
+void
+VGE::MemoryManager::RegisterAllocator(Allocator* allocator)
+{
+    auto& registry = mRegistries[VGE::Thread::ThisThread::ID()];
 
-    alloc_count++;
+    std::lock_guard<std::shared_mutex> lock(registry.Lock);
+    registry.Insert(MakeRange(allocator));
 }
 
 void
 VGE::MemoryManager::DeregisterAllocator(Allocator* allocator)
 {
-    // Switch to binary search after verifying correctness.
-    // Make the assumption here that allocators are short lived, and therefore I should search backwards
-    auto& alloc_count = mAllocatorsCount[VGE::Thread::ThisThread::ID()];
-    Allocator** allocators = mAllocators[VGE::Thread::ThisThread::ID()];
+    // Usually deregistered by the same thread, but allocators may be destroyed on another thread.
+    const auto this_thread = VGE::Thread::ThisThread::ID();
+    for (int i = 0; i < VGE::Thread::MaxThreads; i++)
+    {
+        auto& registry = mRegistries[(this_thread + i) % VGE::Thread::MaxThreads];
+
+        std::lock_guard<std::shared_mutex> lock(registry.Lock);
+
+        // Look in the range it was registered with first, allocators are short lived so search from the back otherwise.
+        const auto range = MakeRange(allocator);
+        auto idx = registry.Find(range.Begin);
+        while (idx >= 0 && registry.Ranges[idx].Owner != allocator && registry.Ranges[idx].Begin == range.Begin)
+            idx--;
+
+        if (idx < 0 || registry.Ranges[idx].Owner != allocator)
+            idx = registry.Find(allocator);
+
+        if (idx >= 0)
+        {
+            registry.Erase(idx);
+            return;
+        }
+    }
+
+    VGE_ASSERT(false, "Trying to doubly delete allocator with name: %s", allocator->Name());
+}
+
+VGE::Allocator*
+VGE::MemoryManager::FindAllocator(const void* ptr)
+{
+    // Allocators on other threads may be nested inside of ours, so pick the smallest range containing ptr.
+    Allocator* found = nullptr;
+    i64 found_size = 0;
+    for (auto& registry : mRegistries)
+    {
+        std::shared_lock<std::shared_mutex> lock(registry.Lock);
 
-    int position = alloc_count - 1;
-    while (position >= 0 && allocator < allocators[position])
-        position--;
+        const auto idx = registry.Find(ptr);
+        if (idx < 0)
+            continue;
 
-    VGE_ASSERT(position >= 0, "Trying to doubly delete allocator with name: %s", allocator->Name());
+        const auto size = registry.Ranges[idx].End - registry.Ranges[idx].Begin;
+        if (!found || size < found_size)
+        {
+            found = registry.Ranges[idx].Owner;
+            found_size = size;
+        }
+    }
 
-    std::memmove(&allocators[position], &allocators[position + 1], (alloc_count - position) * sizeof(VGE::Allocator*));
-    alloc_count--;
+    return found;
+}
+
+void
+VGE::MemoryManager::Free(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    auto allocator = FindAllocator(ptr);
+    VGE_ASSERT(allocator, "Trying to free %p, which is not owned by any registered allocator", ptr);
+    if (allocator)
+        allocator->Deallocate(ptr);
+}
+
+int
+VGE::MemoryManager::AllocatorCount() const
+{
+    int count = 0;
+    for (auto& registry : mRegistries)
+    {
+        std::shared_lock<std::shared_mutex> lock(registry.Lock);
+        count += registry.Count;
+    }
+
+    return count;
+}
+
+void
+VGE::MemoryManager::RegisterFrameAllocator(FrameAllocator* allocator)
+{
+    VGE_ASSERT(mFrameAllocatorsCount < MaxFrameAllocators, "Trying to add more than %d frame allocators", MaxFrameAllocators);
+    mFrameAllocators[mFrameAllocatorsCount++] = allocator;
+}
+
+void
+VGE::MemoryManager::DeregisterFrameAllocator(FrameAllocator* allocator)
+{
+    const auto end = mFrameAllocators + mFrameAllocatorsCount;
+    const auto it = std::find(mFrameAllocators, end, allocator);
+    VGE_ASSERT(it != end, "Trying to deregister unknown frame allocator with name: %s", allocator->Name());
+
+    std::copy(it + 1, end, it);
+    mFrameAllocatorsCount--;
+}
+
+void
+VGE::MemoryManager::BeginFrame()
+{
+    for (int i = 0; i < mFrameAllocatorsCount; i++)
+        mFrameAllocators[i]->BeginFrame();
+
+    if (mTracker)
+        mTracker->BeginFrame();
+}
+
+void
+VGE::MemoryManager::EnableTracking(bool enabled)
+{
+    if (enabled && !mTracker)
+        mTracker = new AllocationTracker();
+
+    mTracking.store(enabled, std::memory_order_release);
+}
+
+bool
+VGE::MemoryManager::IsTracking() const
+{
+    return mTracking.load(std::memory_order_relaxed);
+}
+
+VGE::AllocationTracker*
+VGE::MemoryManager::GetTracker()
+{
+    return mTracker;
 }
 
 void
 VGE::MemoryManager::DrawDebug()
 {
-    // TODO: Need to find another reporting scheme as well, because this will not work for frame based allocators.
     if (ImGui::BeginTabBar("MemoryTab"))
     {
         if (ImGui::BeginTabItem("Memory View"))
@@ -70,15 +288,17 @@ VGE::MemoryManager::DrawDebug()
             ImGui::BeginChild(ImGui::GetID("AllocatorList"), ImVec2(list_width, 0.0f), true, ImGuiWindowFlags_AlwaysVerticalScrollbar);
             {
                 // TODO: Should make it clear that this is on a per thread basis.
-                for (int t = 0; t != (int)std::size(mAllocatorsCount); t++)
+                for (auto& registry : mRegistries)
                 {
-                    for (int i = 0; i != mAllocatorsCount[t]; i++)
+                    std::lock_guard<std::shared_mutex> lock(registry.Lock);
+                    for (int i = 0; i != registry.Count; i++)
                     {
-                        if (ImGui::TreeNode((void*)(i + (t * MaxAllocators)), "Allocator: %s", mAllocators[t][i]->Name()))
+                        const auto allocator = registry.Ranges[i].Owner;
+                        if (ImGui::TreeNode(allocator, "Allocator: %s", allocator->Name()))
                         {
-                            ImGui::Text("Capacity: %d\nUsed: %d",
-                                        mAllocators[t][i]->Capacity(),
-                                        mAllocators[t][i]->AllocatedSize());
+                            ImGui::Text("Capacity: %lld\nUsed: %lld",
+                                        (long long)allocator->Capacity(),
+                                        (long long)allocator->AllocatedSize());
 
                             ImGui::TreePop();
                         }
@@ -89,7 +309,7 @@ VGE::MemoryManager::DrawDebug()
             ImGui::SameLine();
 
 
-            const auto DrawMemory = [&](int byte_pr_pixel)
+            const auto DrawMemory = [&](i64 byte_pr_pixel)
             {
                 constexpr static ImU32 colors[] =
                 {
@@ -111,13 +331,21 @@ VGE::MemoryManager::DrawDebug()
 
                 auto list = ImGui::GetWindowDrawList();
 
-                for (int t = 0; t != (int)std::size(mAllocatorsCount); t++)
+                // Everything is laid out relative to the global allocator, as all other allocators should live inside of it.
+                const auto base = (const char*)gGlobalAllocator.MemoryBegin();
+
+                for (auto& registry : mRegistries)
                 {
-                    for (int i = 0, c = 0; i != mAllocatorsCount[t]; i++, c = (c + 1) % (sizeof(colors) / sizeof(colors[0])))
+                    std::lock_guard<std::shared_mutex> lock(registry.Lock);
+                    for (int i = 0, c = 0; i != registry.Count; i++, c = (c + 1) % (sizeof(colors) / sizeof(colors[0])))
                     {
-                        const auto total_begin = start_pos.y + ((char*)mAllocators[t][i]->MemoryBegin() - (char*)mAllocators[0][0]->MemoryBegin()) / byte_pr_pixel;
-                        const auto total_end = total_begin + (mAllocators[t][i]->Capacity() / byte_pr_pixel);
-                        const auto used_end = total_begin + (mAllocators[t][i]->AllocatedSize() / byte_pr_pixel);
+                        const auto allocator = registry.Ranges[i].Owner;
+                        if (!gGlobalAllocator.Contains(allocator->MemoryBegin()))
+                            continue;
+
+                        const auto total_begin = start_pos.y + ((const char*)allocator->MemoryBegin() - base) / byte_pr_pixel;
+                        const auto total_end = total_begin + (allocator->Capacity() / byte_pr_pixel);
+                        const auto used_end = total_begin + (allocator->AllocatedSize() / byte_pr_pixel);
 
                         list->AddRectFilled({x_begin, total_begin}, {x_end, total_end}, colors[c] | (0x77 << 24));
                         list->AddRectFilled({x_begin, total_begin}, {x_end, used_end}, colors[c] | (0xFF << 24));
@@ -128,10 +356,10 @@ VGE::MemoryManager::DrawDebug()
                         if (ImGui::IsItemHovered())
                         {
                             ImGui::BeginTooltip();
-                            ImGui::Text("Allocator: %s\nCapacity: %d\nUsed: %d",
-                                        mAllocators[t][i]->Name(),
-                                        mAllocators[t][i]->Capacity(),
-                                        mAllocators[t][i]->AllocatedSize());
+                            ImGui::Text("Allocator: %s\nCapacity: %lld\nUsed: %lld",
+                                        allocator->Name(),
+                                        (long long)allocator->Capacity(),
+                                        (long long)allocator->AllocatedSize());
 
                             ImGui::EndTooltip();
                         }
@@ -154,13 +382,36 @@ VGE::MemoryManager::DrawDebug()
                 // For the dynamic minimap
                 const auto& style = ImGui::GetStyle();
                 const auto max_y = std::max(ImGui::GetContentRegionAvail().y - style.WindowPadding.y, 1.0f);
-                const auto byte_pr_pixel = mAllocators[0][0]->Capacity() / max_y;
+                const auto byte_pr_pixel = std::max((i64)(gGlobalAllocator.AllocatedSize() / max_y), i64(1));
                 DrawMemory(byte_pr_pixel);
             }
             ImGui::EndChild();
             ImGui::EndTabItem();
         }
 
+        if (ImGui::BeginTabItem("Allocations"))
+        {
+            auto tracking = IsTracking();
+            if (ImGui::Checkbox("Track allocations", &tracking))
+                EnableTracking(tracking);
+
+            if (mTracker)
+                mTracker->DrawDebug();
+
+            ImGui::EndTabItem();
+        }
+
+        // Frame allocators are reset every frame, so they are reported pr frame instead.
+        if (ImGui::BeginTabItem("Frame Allocators"))
+        {
+            for (int i = 0; i < mFrameAllocatorsCount; i++)
+            {
+                if (ImGui::CollapsingHeader(mFrameAllocators[i]->Name(), ImGuiTreeNodeFlags_DefaultOpen))
+                    mFrameAllocators[i]->DrawDebug();
+            }
+            ImGui::EndTabItem();
+        }
+
         ImGui::EndTabBar();
     }
 }
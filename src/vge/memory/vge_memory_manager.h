@@ -1,25 +1,99 @@
 #pragma once
 #include <vge_allocator.h>
 #include <vge_thread.h>
+#include <vge_allocation_tracker.h>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 
 namespace VGE
 {
+    class FrameAllocator;
+
     struct MemoryManager
     {
+        ~MemoryManager();
+
         void Init();
         Allocator* GetDefaultAllocator();
 
+        // Allocators are kept pr thread, sorted by the memory range they manage.
+        // Ranges either nest (a linear allocator in a region of the global allocator) or are disjoint.
         void RegisterAllocator(Allocator* allocator);
         void DeregisterAllocator(Allocator* allocator);
 
+        // Innermost registered allocator whose memory range contains ptr, nullptr if there is none.
+        // Note: ThreadCachingAllocator hands large allocations to malloc, those are outside of its range.
+        Allocator* FindAllocator(const void* ptr);
+
+        // Deallocates through the allocator owning ptr.
+        void Free(void* ptr);
+
+        int AllocatorCount() const;
+
+        // Frame allocators are registered in addition to the normal registration, so they can be driven and reported pr frame.
+        // Only to be called from the main thread.
+        void RegisterFrameAllocator(FrameAllocator* allocator);
+        void DeregisterFrameAllocator(FrameAllocator* allocator);
+
+        // Called by the main loop at the start of every frame.
+        void BeginFrame();
+
+        // Allocation tracking is off by default, the tracker is created the first time it is enabled.
+        // Only to be called from the main thread.
+        void EnableTracking(bool enabled);
+        bool IsTracking() const;
+        AllocationTracker* GetTracker(); // nullptr if tracking has never been enabled.
+
+        // Called by the allocators, costs a single load when tracking is disabled.
+        VGE_INLINE void TrackAllocate(const Allocator* allocator, const void* ptr, i64 size, const void* call_site, AllocationKind kind = AllocationKind::Allocate)
+        {
+            if (VGE_UNLIKELY(mTracking.load(std::memory_order_acquire)) && ptr)
+                mTracker->Record(kind, allocator, ptr, size, call_site);
+        }
+
+        VGE_INLINE void TrackDeallocate(const Allocator* allocator, const void* ptr)
+        {
+            if (VGE_UNLIKELY(mTracking.load(std::memory_order_acquire)) && ptr)
+                mTracker->Record(AllocationKind::Deallocate, allocator, ptr, 0, nullptr);
+        }
+
         void DrawDebug();
 
 
-        // Currently, just limitting it to 256 allocators.
-        static constexpr auto MaxAllocators = 256;
+        // Members
+        struct AllocatorRange
+        {
+            const char* Begin;
+            const char* End;
+            Allocator* Owner;
+            int Parent; // Index of the innermost range containing this one, -1 if none.
+        };
+
+        // Grows on demand. Only the owning thread registers, but any thread can look up allocators.
+        // Lookups take the lock shared, so threads freeing through the manager don't serialize on each other.
+        struct alignas(64) AllocatorRegistry
+        {
+            AllocatorRange* Ranges{};
+            int Count{};
+            int Capacity{};
+            mutable std::shared_mutex Lock;
+
+            int Insert(const AllocatorRange& range);
+            void Erase(int idx);
+            int Find(const void* ptr) const;
+            int Find(const Allocator* allocator) const;
+        };
+
+        AllocatorRegistry mRegistries[VGE::Thread::MaxThreads];
+
+        static constexpr auto MaxFrameAllocators = 16;
+
+        FrameAllocator* mFrameAllocators[MaxFrameAllocators]{};
+        int mFrameAllocatorsCount{};
 
-        Allocator* mAllocators[VGE::Thread::MaxThreads][MaxAllocators]{};
-        int mAllocatorsCount[VGE::Thread::MaxThreads]{};
+        std::atomic<bool> mTracking{};
+        AllocationTracker* mTracker{};
     };
 
     inline MemoryManager gMemoryManager;
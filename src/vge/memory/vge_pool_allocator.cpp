@@ -0,0 +1,229 @@
+#include <vge_pool_allocator.h>
+#include <vge_assert.h>
+#include <algorithm>
+#include <cstring>
+
+VGE::PoolAllocator::PoolAllocator(void* memory, i64 cap, i64 block_size, i64 block_alignment, Threading threading, const char* name, MemoryManager* manager)
+    : mData((char*)memory)
+    , mCap(cap)
+    , mThreading(threading)
+    , mMemoryManager(manager)
+{
+    auto tmp = (!name) ? "unnamed" : name;
+    std::strcpy(mName, tmp);
+
+    VGE_ASSERT(memory && cap > 0, "Pool allocator: %s needs memory to work with", mName);
+    VGE_ASSERT(block_size > 0, "Pool allocator: %s needs a positive block size, got: %lld", mName, (long long)block_size);
+    VGE_ASSERT(block_alignment > 0 && (block_alignment & (block_alignment - 1)) == 0, "Alignment must be a power of two, got: %lld", (long long)block_alignment);
+
+    // Every block must be able to hold a free list link.
+    mBlockAlignment = std::max<i64>(block_alignment, alignof(std::atomic<u32>));
+    mBlockSize = (std::max<i64>(block_size, sizeof(std::atomic<u32>)) + mBlockAlignment - 1) & ~(mBlockAlignment - 1);
+
+    auto begin = (uintptr_t)mData;
+    #ifdef VGE_MEMORY_DEBUG
+    const auto max_blocks = cap / mBlockSize;
+    begin = (begin + alignof(std::atomic<u64>) - 1) & ~(uintptr_t)(alignof(std::atomic<u64>) - 1);
+    mAllocatedBits = (std::atomic<u64>*)begin;
+    begin += ((max_blocks + 63) / 64) * sizeof(u64);
+    #endif
+
+    mBlocks = (char*)((begin + mBlockAlignment - 1) & ~(uintptr_t)(mBlockAlignment - 1));
+    mBlockCount = (u32)std::clamp<i64>((mData + mCap - mBlocks) / mBlockSize, 0, EmptyIndex - 1);
+    VGE_ASSERT(mBlockCount > 0, "Pool allocator: %s has no room for a single block of %lld bytes", mName, (long long)mBlockSize);
+
+    Clear();
+    mMemoryManager->RegisterAllocator(this);
+}
+
+VGE::PoolAllocator::~PoolAllocator()
+{
+    mMemoryManager->DeregisterAllocator(this);
+}
+
+char*
+VGE::PoolAllocator::Block(u32 idx) const VGE_NOEXCEPT
+{
+    return mBlocks + idx * mBlockSize;
+}
+
+std::atomic<u32>&
+VGE::PoolAllocator::Link(u32 idx) const VGE_NOEXCEPT
+{
+    return *(std::atomic<u32>*)Block(idx);
+}
+
+u32
+VGE::PoolAllocator::PopFreeList() VGE_NOEXCEPT
+{
+    if (mThreading == Threading::SingleThreaded)
+    {
+        const auto head = mHead.load(std::memory_order_relaxed);
+        if ((u32)head != EmptyIndex)
+            mHead.store(Link((u32)head).load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        return (u32)head;
+    }
+
+    // The tag is bumped on every change of the head, so a block that was popped and pushed back
+    // in between reading the link and the exchange fails the exchange.
+    auto head = mHead.load(std::memory_order_acquire);
+    while ((u32)head != EmptyIndex)
+    {
+        const u64 next = Link((u32)head).load(std::memory_order_relaxed);
+        const auto new_head = (((head >> 32) + 1) << 32) | next;
+        if (mHead.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire))
+            break;
+    }
+
+    return (u32)head;
+}
+
+void
+VGE::PoolAllocator::PushFreeList(u32 idx) VGE_NOEXCEPT
+{
+    if (mThreading == Threading::SingleThreaded)
+    {
+        Link(idx).store((u32)mHead.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        mHead.store(idx, std::memory_order_relaxed);
+        return;
+    }
+
+    auto head = mHead.load(std::memory_order_relaxed);
+    u64 new_head;
+    do
+    {
+        Link(idx).store((u32)head, std::memory_order_relaxed);
+        new_head = (((head >> 32) + 1) << 32) | idx;
+    } while (!mHead.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void*
+VGE::PoolAllocator::Allocate(i64 size, i64 alignment) VGE_NOEXCEPT
+{
+    VGE_ASSERT(size <= mBlockSize, "Trying to allocate %lld bytes from pool: %s with blocks of %lld bytes", (long long)size, mName, (long long)mBlockSize);
+    VGE_ASSERT(alignment <= mBlockAlignment, "Trying to allocate with alignment %lld from pool: %s aligned to %lld", (long long)alignment, mName, (long long)mBlockAlignment);
+
+    auto idx = PopFreeList();
+    if (idx == EmptyIndex)
+    {
+        // Bump a block that has never been used, the counter never moves past the end.
+        idx = mUnused.load(std::memory_order_relaxed);
+        if (mThreading == Threading::SingleThreaded)
+        {
+            if (idx < mBlockCount)
+                mUnused.store(idx + 1, std::memory_order_relaxed);
+        }
+        else
+        {
+            while (idx < mBlockCount && !mUnused.compare_exchange_weak(idx, idx + 1, std::memory_order_relaxed))
+            {
+                // idx was reloaded by the failed exchange.
+            }
+        }
+
+        VGE_ASSERT(idx < mBlockCount, "Pool allocator: %s is out of blocks, all %u are in use", mName, mBlockCount);
+        if (idx >= mBlockCount)
+            return nullptr;
+    }
+    #ifdef VGE_MEMORY_DEBUG
+    else
+    {
+        const auto block = (const u8*)Block(idx);
+        const auto poisoned = std::all_of(block + sizeof(u32), block + mBlockSize, [](u8 byte) { return byte == PoisonByte; });
+        VGE_ASSERT(poisoned, "Pool allocator: %s, block %u was written to after being freed", mName, idx);
+    }
+    #endif
+
+    #ifdef VGE_MEMORY_DEBUG
+    const auto bit = u64(1) << (idx % 64);
+    mAllocatedBits[idx / 64].fetch_or(bit, std::memory_order_relaxed);
+    #endif
+
+    mAllocatedBlocks.fetch_add(1, std::memory_order_relaxed);
+    mMemoryManager->TrackAllocate(this, Block(idx), size, VGE_RETURN_ADDRESS());
+    return Block(idx);
+}
+
+void
+VGE::PoolAllocator::Deallocate(void* ptr) VGE_NOEXCEPT
+{
+    if (!ptr)
+        return;
+
+    const auto offset = (char*)ptr - mBlocks;
+    VGE_UNUSED const auto owned = offset >= 0 && offset < mBlockCount * mBlockSize && offset % mBlockSize == 0;
+    VGE_ASSERT(owned, "Pool allocator: %s does not own: %p", mName, ptr);
+    const auto idx = (u32)(offset / mBlockSize);
+    mMemoryManager->TrackDeallocate(this, ptr);
+
+    #ifdef VGE_MEMORY_DEBUG
+    const auto bit = u64(1) << (idx % 64);
+    const auto was_allocated = (mAllocatedBits[idx / 64].fetch_and(~bit, std::memory_order_relaxed) & bit) != 0;
+    VGE_ASSERT(was_allocated, "Pool allocator: %s, double free of block %u", mName, idx);
+
+    // Pushing the block again would corrupt the free list.
+    if (!was_allocated)
+        return;
+
+    std::memset(Block(idx) + sizeof(u32), PoisonByte, mBlockSize - sizeof(u32));
+    #endif
+
+    mAllocatedBlocks.fetch_sub(1, std::memory_order_relaxed);
+    PushFreeList(idx);
+}
+
+void
+VGE::PoolAllocator::Clear() VGE_NOEXCEPT
+{
+    mHead.store(EmptyIndex, std::memory_order_relaxed);
+    mUnused.store(0, std::memory_order_relaxed);
+    mAllocatedBlocks.store(0, std::memory_order_relaxed);
+
+    #ifdef VGE_MEMORY_DEBUG
+    for (u32 i = 0; i < (mBlockCount + 63) / 64; i++)
+        mAllocatedBits[i].store(0, std::memory_order_relaxed);
+    #endif
+}
+
+i64
+VGE::PoolAllocator::AllocatedSize() const VGE_NOEXCEPT
+{
+    return AllocatedBlocks() * mBlockSize;
+}
+
+i64
+VGE::PoolAllocator::BlockSize() const VGE_NOEXCEPT
+{
+    return mBlockSize;
+}
+
+int
+VGE::PoolAllocator::BlockCount() const VGE_NOEXCEPT
+{
+    return (int)mBlockCount;
+}
+
+int
+VGE::PoolAllocator::AllocatedBlocks() const VGE_NOEXCEPT
+{
+    return mAllocatedBlocks.load(std::memory_order_relaxed);
+}
+
+i64
+VGE::PoolAllocator::Capacity() const VGE_NOEXCEPT
+{
+    return mCap;
+}
+
+const void*
+VGE::PoolAllocator::MemoryBegin() const VGE_NOEXCEPT
+{
+    return mData;
+}
+
+const char*
+VGE::PoolAllocator::Name() const VGE_NOEXCEPT
+{
+    return mName;
+}
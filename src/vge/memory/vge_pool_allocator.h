@@ -0,0 +1,73 @@
+#pragma once
+#include <vge_allocator.h>
+#include <vge_memory_manager.h>
+#include <atomic>
+
+namespace VGE
+{
+    // Hands out fixed size blocks through an intrusive free list, allocating and freeing is O(1).
+    // Blocks that have never been used are bumped from the end of the pool, so constructing a pool is O(1) as well.
+    // The LockFree variant allows blocks to be allocated and freed from any thread, using a tagged head to avoid ABA.
+    // With VGE_MEMORY_DEBUG freed blocks are poisoned, which is verified when they are handed out again,
+    // and every block is tracked so double frees are caught.
+    class PoolAllocator
+        : public VGE::Allocator
+    {
+    public:
+        enum class Threading
+        {
+            SingleThreaded,
+            LockFree,
+        };
+
+        static constexpr u8 PoisonByte = 0xDD;
+
+        PoolAllocator(void* memory, i64 cap, i64 block_size, i64 block_alignment = DefaultAlignment, Threading threading = Threading::SingleThreaded,
+                      const char* name = nullptr, MemoryManager* memory_manager = &VGE::gMemoryManager);
+        virtual ~PoolAllocator();
+
+        using VGE::Allocator::Allocate;
+        virtual void* Allocate(i64 size, i64 alignment) VGE_NOEXCEPT override; // Size and alignment must fit in a block.
+        virtual void Deallocate(void* ptr) VGE_NOEXCEPT override;
+        virtual i64 AllocatedSize() const VGE_NOEXCEPT override;
+        virtual void Clear() VGE_NOEXCEPT override;
+
+        virtual i64 Capacity() const VGE_NOEXCEPT override;
+        virtual const void* MemoryBegin() const VGE_NOEXCEPT override;
+        virtual const char* Name() const VGE_NOEXCEPT override;
+
+        i64 BlockSize() const VGE_NOEXCEPT; // Requested size rounded up to the alignment.
+        int BlockCount() const VGE_NOEXCEPT;
+        int AllocatedBlocks() const VGE_NOEXCEPT;
+
+    private:
+        static constexpr u32 EmptyIndex = 0xFFFFFFFF;
+
+        // Free list links are block indices, stored in the first bytes of every free block.
+        std::atomic<u32>& Link(u32 idx) const VGE_NOEXCEPT;
+        char* Block(u32 idx) const VGE_NOEXCEPT;
+
+        u32 PopFreeList() VGE_NOEXCEPT;
+        void PushFreeList(u32 idx) VGE_NOEXCEPT;
+
+        // Members
+        char* mData{};
+        i64 mCap{};
+        char* mBlocks{};
+        i64 mBlockSize{};
+        i64 mBlockAlignment{};
+        u32 mBlockCount{};
+        Threading mThreading{};
+
+        std::atomic<u64> mHead{}; // Tag in the upper 32 bits, index of the first free block in the lower.
+        std::atomic<u32> mUnused{}; // Index of the first block that has never been handed out.
+        std::atomic<int> mAllocatedBlocks{};
+
+        #ifdef VGE_MEMORY_DEBUG
+        std::atomic<u64>* mAllocatedBits{}; // One bit pr block, stored before the blocks.
+        #endif
+
+        char mName[256];
+        MemoryManager* mMemoryManager;
+    };
+}
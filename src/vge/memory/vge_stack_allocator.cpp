@@ -0,0 +1,115 @@
+#include <vge_stack_allocator.h>
+#include <vge_assert.h>
+#include <algorithm>
+#include <cstring>
+
+VGE::StackAllocator::Scope::Scope(StackAllocator& allocator)
+    : mAllocator(&allocator)
+    , mMarker(allocator.GetMarker())
+{
+}
+
+VGE::StackAllocator::Scope::~Scope()
+{
+    mAllocator->FreeToMarker(mMarker);
+}
+
+VGE::StackAllocator::StackAllocator(void* memory, i64 cap, const char* name, MemoryManager* manager)
+    : mData((char*)memory)
+    , mSize(0)
+    , mCap(cap)
+    , mHighWaterMark(0)
+    , mMemoryManager(manager)
+{
+    auto tmp = (!name) ? "unnamed" : name;
+    std::strcpy(mName, tmp);
+    mMemoryManager->RegisterAllocator(this);
+}
+
+VGE::StackAllocator::~StackAllocator()
+{
+    mMemoryManager->DeregisterAllocator(this);
+}
+
+void*
+VGE::StackAllocator::Allocate(i64 size, i64 alignment) VGE_NOEXCEPT
+{
+    VGE_ASSERT(size >= 0, "Trying to allocate negative size: %lld from %s", (long long)size, mName);
+    VGE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two, got: %lld", (long long)alignment);
+
+    const auto current = (uintptr_t)(mData + mSize);
+    const auto begin = (i64)(((current + alignment - 1) & ~(uintptr_t)(alignment - 1)) - (uintptr_t)mData);
+
+    VGE_ASSERT(begin + size <= mCap, "Overrunning stack allocator: %s", mName);
+    if (begin + size > mCap)
+        return nullptr;
+
+    mSize = begin + size;
+    mHighWaterMark = std::max(mHighWaterMark, mSize);
+    mMemoryManager->TrackAllocate(this, &mData[begin], size, VGE_RETURN_ADDRESS(), AllocationKind::Transient);
+    return &mData[begin];
+}
+
+void
+VGE::StackAllocator::Deallocate(VGE_UNUSED void* ptr) VGE_NOEXCEPT
+{
+    VGE_ASSERT(!ptr || (ptr >= mData && ptr < mData + mCap), "Trying to deallocate memory not owned by stack allocator: %s", mName);
+}
+
+VGE::StackAllocator::Marker
+VGE::StackAllocator::GetMarker() const VGE_NOEXCEPT
+{
+    return mSize;
+}
+
+void
+VGE::StackAllocator::FreeToMarker(Marker marker) VGE_NOEXCEPT
+{
+    // A marker above the top means that memory was freed out of order.
+    VGE_ASSERT(marker >= 0 && marker <= mSize, "Stack allocator: %s, freeing to marker %lld above the top %lld",
+               mName, (long long)marker, (long long)mSize);
+    if (marker < 0 || marker > mSize)
+        return;
+
+    #ifdef VGE_MEMORY_DEBUG
+    std::memset(mData + marker, PoisonByte, mSize - marker);
+    #endif
+
+    mSize = marker;
+}
+
+void
+VGE::StackAllocator::Clear() VGE_NOEXCEPT
+{
+    FreeToMarker(0);
+}
+
+i64
+VGE::StackAllocator::AllocatedSize() const VGE_NOEXCEPT
+{
+    return mSize;
+}
+
+i64
+VGE::StackAllocator::HighWaterMark() const VGE_NOEXCEPT
+{
+    return mHighWaterMark;
+}
+
+i64
+VGE::StackAllocator::Capacity() const VGE_NOEXCEPT
+{
+    return mCap;
+}
+
+const void*
+VGE::StackAllocator::MemoryBegin() const VGE_NOEXCEPT
+{
+    return mData;
+}
+
+const char*
+VGE::StackAllocator::Name() const VGE_NOEXCEPT
+{
+    return mName;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vge_allocator.h>
+#include <vge_memory_manager.h>
+
+namespace VGE
+{
+    // Linear allocator that can be rewound to a marker, so nested users can release their temporaries in LIFO order.
+    // Deallocate does nothing, memory is only given back through FreeToMarker, a Scope or Clear.
+    // With VGE_MEMORY_DEBUG rewound memory is poisoned.
+    // Not thread safe, every thread should use its own stack.
+    class StackAllocator
+        : public VGE::Allocator
+    {
+    public:
+        using Marker = i64;
+
+        static constexpr u8 PoisonByte = 0xDD;
+
+        // Rewinds the stack to where it was when the scope was created.
+        class Scope
+        {
+        public:
+            Scope(StackAllocator& allocator);
+            ~Scope();
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            StackAllocator* mAllocator;
+            Marker mMarker;
+        };
+
+        StackAllocator(void* memory, i64 cap, const char* name = nullptr, MemoryManager* memory_manager = &VGE::gMemoryManager);
+        virtual ~StackAllocator();
+
+        using VGE::Allocator::Allocate;
+        virtual void* Allocate(i64 size, i64 alignment) VGE_NOEXCEPT override;
+        virtual void Deallocate(void* ptr) VGE_NOEXCEPT override;
+        virtual i64 AllocatedSize() const VGE_NOEXCEPT override;
+        virtual void Clear() VGE_NOEXCEPT override;
+
+        virtual i64 Capacity() const VGE_NOEXCEPT override;
+        virtual const void* MemoryBegin() const VGE_NOEXCEPT override;
+        virtual const char* Name() const VGE_NOEXCEPT override;
+
+        Marker GetMarker() const VGE_NOEXCEPT;
+        void FreeToMarker(Marker marker) VGE_NOEXCEPT; // Everything allocated after the marker is freed.
+
+        i64 HighWaterMark() const VGE_NOEXCEPT;
+
+    private:
+        char* mData;
+        i64 mSize;
+        i64 mCap;
+        i64 mHighWaterMark;
+        char mName[256];
+        MemoryManager* mMemoryManager;
+    };
+}
@@ -0,0 +1,334 @@
+#include <vge_thread_caching_allocator.h>
+#include <vge_global_allocator.h>
+#include <vge_assert.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    using TCA = VGE::ThreadCachingAllocator;
+
+    // Lookup tables, to keep divisions and branches off the hot path.
+    struct SizeClassTable
+    {
+        // Indexed by the size in 16 byte steps, rounded up.
+        u8 Classes[TCA::MaxSmallSize / 16 + 1]{};
+        int Sizes[TCA::SizeClassCount]{};
+        int BatchSizes[TCA::SizeClassCount]{};
+
+        constexpr SizeClassTable()
+        {
+            int size_class = 0;
+            for (int i = 0; i < (int)std::size(Classes); i++)
+            {
+                while (TCA::ClassSize(size_class) < i * 16)
+                    size_class++;
+                Classes[i] = (u8)size_class;
+            }
+
+            for (int i = 0; i < TCA::SizeClassCount; i++)
+            {
+                // Move around roughly 8KB at a time.
+                Sizes[i] = TCA::ClassSize(i);
+                BatchSizes[i] = std::clamp(8 * 1024 / Sizes[i], 2, 64);
+            }
+        }
+    };
+
+    constexpr SizeClassTable sTable;
+
+    // Every block larger than MaxSmallSize is prefixed with its size, and the pointer returned by malloc.
+    struct alignas(16) LargeHeader
+    {
+        i64 Size;
+        void* Allocation;
+    };
+}
+
+int
+VGE::ThreadCachingAllocator::SizeClass(int size)
+{
+    return sTable.Classes[(size + 15) / 16];
+}
+
+int
+VGE::ThreadCachingAllocator::AlignedSizeClass(i64 size, i64 alignment)
+{
+    size = std::max(size, alignment);
+    if (size > MaxSmallSize)
+        return -1;
+
+    for (auto size_class = SizeClass((int)size); size_class < SizeClassCount; size_class++)
+    {
+        if (sTable.Sizes[size_class] % alignment == 0)
+            return size_class;
+    }
+
+    return -1;
+}
+
+VGE::ThreadCachingAllocator::ThreadCachingAllocator(void* memory, i64 cap, const char* name, MemoryManager* manager)
+    : mMemoryManager(manager)
+{
+    VGE_ASSERT(memory && cap > 0, "Thread caching allocator needs memory to work with");
+
+    auto tmp = (!name) ? "unnamed" : name;
+    std::strcpy(mName, tmp);
+
+    mData = (char*)memory;
+    mCap = cap;
+
+    // The size class table comes first, followed by the spans which are aligned to SpanSize.
+    mSpanClasses = (u8*)mData;
+    const auto spans_begin = (uintptr_t)(mData + mCap / SpanSize + 1);
+    mSpansBegin = (char*)((spans_begin + SpanSize - 1) & ~(uintptr_t)(SpanSize - 1));
+    VGE_ASSERT(mSpansBegin + SpanSize <= mData + mCap, "Thread caching allocator: %s needs room for at least one span", mName);
+    GlobalAllocator::CommitPages(mData, mSpansBegin - mData);
+
+    mMemoryManager->RegisterAllocator(this);
+}
+
+VGE::ThreadCachingAllocator::~ThreadCachingAllocator()
+{
+    mMemoryManager->DeregisterAllocator(this);
+}
+
+void*
+VGE::ThreadCachingAllocator::Allocate(i64 size, i64 alignment) VGE_NOEXCEPT
+{
+    const auto ptr = AllocateBlock(size, alignment);
+    mMemoryManager->TrackAllocate(this, ptr, size, VGE_RETURN_ADDRESS());
+    return ptr;
+}
+
+void*
+VGE::ThreadCachingAllocator::AllocateBlock(i64 size, i64 alignment) VGE_NOEXCEPT
+{
+    VGE_ASSERT(size >= 0, "Trying to allocate negative size: %lld from %s", (long long)size, mName);
+    VGE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two, got: %lld", (long long)alignment);
+
+    int size_class;
+    if (VGE_LIKELY(alignment <= MinAlignment))
+    {
+        if (size > MaxSmallSize)
+            return AllocateLarge(size, alignment);
+
+        size_class = SizeClass((int)size);
+    }
+    else
+    {
+        size_class = AlignedSizeClass(size, alignment);
+        if (size_class < 0)
+            return AllocateLarge(size, alignment);
+    }
+
+    auto& cache = mCaches[VGE::Thread::ThisThread::ID()];
+
+    if (VGE_UNLIKELY(!cache.FreeLists[size_class]))
+    {
+        Refill(cache, size_class);
+
+        // Out of spans, so let malloc deal with it.
+        if (!cache.FreeLists[size_class])
+            return AllocateLarge(size, alignment);
+    }
+
+    auto block = cache.FreeLists[size_class];
+    cache.FreeLists[size_class] = block->Next;
+    cache.FreeCounts[size_class]--;
+    cache.Allocated.store(cache.Allocated.load(std::memory_order_relaxed) + sTable.Sizes[size_class], std::memory_order_relaxed);
+
+    return block;
+}
+
+void
+VGE::ThreadCachingAllocator::Deallocate(void* ptr) VGE_NOEXCEPT
+{
+    if (!ptr)
+        return;
+
+    mMemoryManager->TrackDeallocate(this, ptr);
+
+    if (ptr < mSpansBegin || ptr >= mData + mCap)
+        return DeallocateLarge(ptr);
+
+    auto& cache = mCaches[VGE::Thread::ThisThread::ID()];
+    const auto size_class = mSpanClasses[((char*)ptr - mSpansBegin) / SpanSize];
+
+    auto block = (FreeBlock*)ptr;
+    block->Next = cache.FreeLists[size_class];
+    cache.FreeLists[size_class] = block;
+    cache.FreeCounts[size_class]++;
+    cache.Allocated.store(cache.Allocated.load(std::memory_order_relaxed) - sTable.Sizes[size_class], std::memory_order_relaxed);
+
+    if (VGE_UNLIKELY(cache.FreeCounts[size_class] > 2 * sTable.BatchSizes[size_class]))
+        Release(cache, size_class);
+}
+
+void
+VGE::ThreadCachingAllocator::Refill(ThreadCache& cache, int size_class)
+{
+    const auto batch_size = sTable.BatchSizes[size_class];
+
+    std::lock_guard<std::mutex> lock(mCentralLock);
+
+    if (mCentralLists[size_class])
+    {
+        // Detach up to a batch of blocks from the central list.
+        auto first = mCentralLists[size_class];
+        auto last = first;
+        int count = 1;
+        while (count < batch_size && last->Next)
+        {
+            last = last->Next;
+            count++;
+        }
+
+        mCentralLists[size_class] = last->Next;
+        mCentralCounts[size_class] -= count;
+
+        last->Next = cache.FreeLists[size_class];
+        cache.FreeLists[size_class] = first;
+        cache.FreeCounts[size_class] += count;
+        return;
+    }
+
+    // Carve a new span, the thread gets one batch and the rest goes to the central list.
+    const auto spans_size = mSpansSize.load(std::memory_order_relaxed);
+    if (mSpansBegin + spans_size + SpanSize > mData + mCap)
+        return;
+
+    const auto span_idx = spans_size / SpanSize;
+    const auto span = mSpansBegin + spans_size;
+    mSpansSize.store(spans_size + SpanSize, std::memory_order_relaxed);
+    mSpanClasses[span_idx] = (u8)size_class;
+    GlobalAllocator::CommitPages(span, SpanSize);
+
+    const auto block_size = sTable.Sizes[size_class];
+    const auto block_count = SpanSize / block_size;
+    const auto thread_count = std::min(block_count, batch_size);
+
+    for (int i = block_count - 1; i >= thread_count; i--)
+    {
+        auto block = (FreeBlock*)(span + i * block_size);
+        block->Next = mCentralLists[size_class];
+        mCentralLists[size_class] = block;
+    }
+    mCentralCounts[size_class] += block_count - thread_count;
+
+    for (int i = thread_count - 1; i >= 0; i--)
+    {
+        auto block = (FreeBlock*)(span + i * block_size);
+        block->Next = cache.FreeLists[size_class];
+        cache.FreeLists[size_class] = block;
+    }
+    cache.FreeCounts[size_class] += thread_count;
+}
+
+void
+VGE::ThreadCachingAllocator::Release(ThreadCache& cache, int size_class)
+{
+    const auto batch_size = sTable.BatchSizes[size_class];
+
+    // Keep the most recently freed blocks, as they are most likely to still be in cache.
+    auto keep = cache.FreeLists[size_class];
+    for (int i = 1; i < batch_size; i++)
+        keep = keep->Next;
+
+    auto first = keep->Next;
+    auto last = first;
+    for (int i = 1; i < batch_size; i++)
+        last = last->Next;
+
+    keep->Next = last->Next;
+    cache.FreeCounts[size_class] -= batch_size;
+
+    std::lock_guard<std::mutex> lock(mCentralLock);
+    last->Next = mCentralLists[size_class];
+    mCentralLists[size_class] = first;
+    mCentralCounts[size_class] += batch_size;
+}
+
+void*
+VGE::ThreadCachingAllocator::AllocateLarge(i64 size, i64 alignment)
+{
+    alignment = std::max<i64>(alignment, alignof(LargeHeader));
+
+    const auto allocation = (char*)std::malloc(sizeof(LargeHeader) + size + alignment - alignof(LargeHeader));
+    VGE_ASSERT(allocation, "Out of memory, failed to allocate %lld bytes in %s", (long long)size, mName);
+    if (!allocation)
+        return nullptr;
+
+    const auto user = ((uintptr_t)allocation + sizeof(LargeHeader) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    auto header = (LargeHeader*)user - 1;
+    header->Size = size;
+    header->Allocation = allocation;
+
+    auto& cache = mCaches[VGE::Thread::ThisThread::ID()];
+    cache.Allocated.store(cache.Allocated.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+
+    return header + 1;
+}
+
+void
+VGE::ThreadCachingAllocator::DeallocateLarge(void* ptr)
+{
+    auto header = (LargeHeader*)ptr - 1;
+
+    auto& cache = mCaches[VGE::Thread::ThisThread::ID()];
+    cache.Allocated.store(cache.Allocated.load(std::memory_order_relaxed) - header->Size, std::memory_order_relaxed);
+
+    std::free(header->Allocation);
+}
+
+void
+VGE::ThreadCachingAllocator::Clear() VGE_NOEXCEPT
+{
+    std::lock_guard<std::mutex> lock(mCentralLock);
+
+    for (auto& cache : mCaches)
+    {
+        std::fill(std::begin(cache.FreeLists), std::end(cache.FreeLists), nullptr);
+        std::fill(std::begin(cache.FreeCounts), std::end(cache.FreeCounts), 0);
+        cache.Allocated.store(0, std::memory_order_relaxed);
+    }
+
+    std::fill(std::begin(mCentralLists), std::end(mCentralLists), nullptr);
+    std::fill(std::begin(mCentralCounts), std::end(mCentralCounts), 0);
+    mSpansSize.store(0, std::memory_order_relaxed);
+}
+
+i64
+VGE::ThreadCachingAllocator::AllocatedSize() const VGE_NOEXCEPT
+{
+    i64 total = 0;
+    for (const auto& cache : mCaches)
+        total += cache.Allocated.load(std::memory_order_relaxed);
+
+    return total;
+}
+
+i64
+VGE::ThreadCachingAllocator::SpansSize() const VGE_NOEXCEPT
+{
+    return mSpansSize.load(std::memory_order_relaxed);
+}
+
+i64
+VGE::ThreadCachingAllocator::Capacity() const VGE_NOEXCEPT
+{
+    return mCap;
+}
+
+const void*
+VGE::ThreadCachingAllocator::MemoryBegin() const VGE_NOEXCEPT
+{
+    return mData;
+}
+
+const char*
+VGE::ThreadCachingAllocator::Name() const VGE_NOEXCEPT
+{
+    return mName;
+}
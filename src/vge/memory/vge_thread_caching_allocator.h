@@ -0,0 +1,95 @@
+#pragma once
+#include <vge_allocator.h>
+#include <vge_memory_manager.h>
+#include <atomic>
+#include <mutex>
+
+namespace VGE
+{
+    // General purpose allocator, used as the default allocator.
+    // Small allocations are rounded up to a size class, and served from spans carved out of the arena.
+    // Every VGE::Thread keeps its own free lists pr size class, so allocating and freeing is lock free in the common case.
+    // When a thread runs out of blocks it refills from a central free list, and when a thread has cached too many
+    // blocks (e.g. from freeing memory allocated by another thread) it returns a batch to the central free list.
+    // Allocations larger than the largest size class go directly to malloc.
+    // Spans are committed as they are carved out, so the arena can be a region of the GlobalAllocator.
+    // Alignments above MinAlignment are served from the smallest size class that is a multiple of the alignment,
+    // as spans are aligned to SpanSize.
+    // Note: Threads not started through VGE::Thread share the cache of ThreadID 0, and must not allocate concurrently with the main thread.
+    class ThreadCachingAllocator
+        : public VGE::Allocator
+    {
+    public:
+        ThreadCachingAllocator(void* memory, i64 cap, const char* name = nullptr, MemoryManager* memory_manager = &VGE::gMemoryManager);
+        virtual ~ThreadCachingAllocator();
+
+        using VGE::Allocator::Allocate;
+        virtual void* Allocate(i64 size, i64 alignment) VGE_NOEXCEPT override;
+        virtual void Deallocate(void* ptr) VGE_NOEXCEPT override;
+        virtual i64 AllocatedSize() const VGE_NOEXCEPT override;
+        virtual void Clear() VGE_NOEXCEPT override; // Only resets the arena, allocations that went to malloc are left alone.
+
+        virtual i64 Capacity() const VGE_NOEXCEPT override;
+        virtual const void* MemoryBegin() const VGE_NOEXCEPT override;
+        virtual const char* Name() const VGE_NOEXCEPT override;
+
+        // Bytes of the arena that have been carved into spans.
+        i64 SpansSize() const VGE_NOEXCEPT;
+
+        static constexpr auto SpanSize = 64 * 1024;
+        static constexpr auto MinAlignment = 16;
+        static constexpr auto MaxSmallSize = 32 * 1024;
+        static constexpr auto SizeClassCount = 8 + 8 * 4; // 16 byte steps up to 128, then 4 steps pr power of two.
+
+        static int SizeClass(int size);
+        static int AlignedSizeClass(i64 size, i64 alignment); // -1 if no size class fits.
+        static constexpr int ClassSize(int size_class);
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* Next;
+        };
+
+        struct alignas(64) ThreadCache
+        {
+            FreeBlock* FreeLists[SizeClassCount]{};
+            int FreeCounts[SizeClassCount]{};
+            std::atomic<i64> Allocated{}; // Allocated minus deallocated by this thread, can be negative.
+        };
+
+        void* AllocateBlock(i64 size, i64 alignment) VGE_NOEXCEPT;
+        void Refill(ThreadCache& cache, int size_class);
+        void Release(ThreadCache& cache, int size_class);
+
+        void* AllocateLarge(i64 size, i64 alignment);
+        void DeallocateLarge(void* ptr);
+
+        char* mData{};
+        i64 mCap{};
+        u8* mSpanClasses{}; // Size class of every span, stored at the beginning of the arena.
+        char* mSpansBegin{};
+
+        ThreadCache mCaches[VGE::Thread::MaxThreads];
+
+        // Central free lists, shared between all threads.
+        std::mutex mCentralLock;
+        FreeBlock* mCentralLists[SizeClassCount]{};
+        int mCentralCounts[SizeClassCount]{};
+        std::atomic<i64> mSpansSize{};
+
+        char mName[256];
+        MemoryManager* mMemoryManager;
+    };
+}
+
+constexpr int
+VGE::ThreadCachingAllocator::ClassSize(int size_class)
+{
+    if (size_class < 8)
+        return (size_class + 1) * 16;
+
+    const auto power = 7 + (size_class - 8) / 4;
+    const auto step = (size_class - 8) % 4 + 1;
+    return (1 << power) + step * (1 << (power - 2));
+}